@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "Utilities/ShooterTestsActorNetworkTest.h"
+
+#if ENABLE_SHOOTERTESTS_NETWORK_TEST
+
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Character/LyraCharacter.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "Inventory/LyraInventoryItemInstance.h"
+#include "Inventory/LyraInventoryManagerComponent.h"
+
+/**
+ * Creates a test object using the name from the first parameter, in the case `AbilityRPCBatchingTest`, which inherits from `ShooterTestsBaseActorNetworkTest<Derived, AsserterType>` to load a level with a server and a client player.
+ * The second parameter specifies the category and subcategories used for displaying within the UI
+ *
+ * The test object will fire the client player's weapon with and without ability RPC batching (lyra.AbilitySystem.BatchAbilityRPCs), and compare the number of bunches the client sent to the server per shot.
+ * The weapon's magazine is refilled on the server before each pass so both passes fire the same number of shots without reloading.
+ *
+ * Each TEST_METHOD will register with the `AbilityRPCBatchingTest` test object and has the variables and methods from `AbilityRPCBatchingTest` available for use.
+ */
+TEST_CLASS_WITH_BASE_AND_FLAGS(AbilityRPCBatchingTest, "Project.Functional Tests.ShooterTests.AbilitySystem.RPCBatching", ShooterTestsBaseActorNetworkTest, EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+{
+	/** Number of shots fired in each pass, kept below the magazine size of the starting weapon */
+	static constexpr int32 NumShots = 8;
+
+	/** The fire input is released and pressed again this often, so semi-automatic weapons also fire repeatedly */
+	static constexpr int32 RetriggerFrames = 10;
+
+	AbilityRPCBatchingTest() : ShooterTestsBaseActorNetworkTest(TEXT("/ShooterTests/Maps/L_ShooterTest_Basic"))
+	{
+	}
+
+	/** Bunches sent by the client per shot without and with batching */
+	double UnbatchedBunchesPerShot{ 0.0 };
+	double BatchedBunchesPerShot{ 0.0 };
+
+	int64 StartBunches{ 0 };
+	int32 NumActivations{ 0 };
+	int32 FramesFired{ 0 };
+	FDelegateHandle AbilityActivatedHandle;
+	bool bPreviousBatchValue{ true };
+
+	static IConsoleVariable* FindBatchCVar()
+	{
+		return IConsoleManager::Get().FindConsoleVariable(TEXT("lyra.AbilitySystem.BatchAbilityRPCs"));
+	}
+
+	static ULyraAbilitySystemComponent* GetAbilitySystem(FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState)
+	{
+		return ClientState.LocalPlayer->GetLyraCharacter()->GetLyraAbilitySystemComponent();
+	}
+
+	static int64 GetSentBunches(FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState)
+	{
+		return (int64)ClientState.World->GetNetDriver()->ServerConnection->OutTotalBunches;
+	}
+
+	/**
+	 * Fill the magazines of the client player's weapons on the server.
+	 */
+	void RefillClientPlayerAmmo()
+	{
+		Network.ThenServer(TEXT("Refill the client player's ammo."), [this](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ServerState) {
+			const FGameplayTag MagazineAmmoTag = FGameplayTag::RequestGameplayTag(TEXT("Lyra.ShooterGame.Weapon.MagazineAmmo"), false);
+			const FGameplayTag MagazineSizeTag = FGameplayTag::RequestGameplayTag(TEXT("Lyra.ShooterGame.Weapon.MagazineSize"), false);
+			ASSERT_THAT(IsTrue(MagazineAmmoTag.IsValid() && MagazineSizeTag.IsValid(), TEXT("Weapon ammo tags are not registered.")));
+
+			ASSERT_THAT(IsNotNull(ServerState.NetworkPlayer.Get(), TEXT("Client player was not found on the server.")));
+			const AController* Controller = ServerState.NetworkPlayer->GetLyraCharacter()->GetController();
+			ULyraInventoryManagerComponent* Inventory = Controller ? Controller->FindComponentByClass<ULyraInventoryManagerComponent>() : nullptr;
+			ASSERT_THAT(IsNotNull(Inventory, TEXT("Client player has no inventory on the server.")));
+
+			for (ULyraInventoryItemInstance* Item : Inventory->GetAllItems())
+			{
+				Item->AddStatTagStack(MagazineAmmoTag, Item->GetStatTagStackCount(MagazineSizeTag) - Item->GetStatTagStackCount(MagazineAmmoTag));
+			}
+		});
+	}
+
+	/**
+	 * Fire NumShots shots on the client player and measure the bunches sent per shot meanwhile.
+	 *
+	 * @param bBatch - Whether ability RPC batching is enabled while firing.
+	 * @param OutBunchesPerShot - Receives the number of bunches sent by the client per ability activation.
+	 */
+	void FireOnClientPlayer(bool bBatch, double& OutBunchesPerShot)
+	{
+		const FGameplayTag FireInputTag = FGameplayTag::RequestGameplayTag(TEXT("InputTag.Weapon.Fire"));
+
+		RefillClientPlayerAmmo();
+
+		Network
+			.ThenClient(TEXT("Start firing on the client player."), [this, bBatch, FireInputTag](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState) {
+				IConsoleVariable* BatchCVar = FindBatchCVar();
+				ASSERT_THAT(IsNotNull(BatchCVar, TEXT("lyra.AbilitySystem.BatchAbilityRPCs is not registered.")));
+				BatchCVar->Set(bBatch, ECVF_SetByCode);
+
+				ULyraAbilitySystemComponent* AbilitySystem = GetAbilitySystem(ClientState);
+				ASSERT_THAT(IsNotNull(AbilitySystem, TEXT("Client player has no ability system.")));
+
+				NumActivations = 0;
+				FramesFired = 0;
+				AbilityActivatedHandle = AbilitySystem->AbilityActivatedCallbacks.AddLambda([this](UGameplayAbility*) { ++NumActivations; });
+
+				StartBunches = GetSentBunches(ClientState);
+				AbilitySystem->AbilityInputTagPressed(FireInputTag);
+			})
+			.UntilClient(TEXT("Keep firing on the client player."), [this, FireInputTag](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState) {
+				ULyraAbilitySystemComponent* AbilitySystem = GetAbilitySystem(ClientState);
+				if ((++FramesFired % RetriggerFrames) == 0)
+				{
+					AbilitySystem->AbilityInputTagReleased(FireInputTag);
+					AbilitySystem->AbilityInputTagPressed(FireInputTag);
+				}
+				return NumActivations >= NumShots;
+			})
+			.ThenClient(TEXT("Stop firing on the client player."), [this, FireInputTag, &OutBunchesPerShot](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState) {
+				ULyraAbilitySystemComponent* AbilitySystem = GetAbilitySystem(ClientState);
+				AbilitySystem->AbilityInputTagReleased(FireInputTag);
+				AbilitySystem->AbilityActivatedCallbacks.Remove(AbilityActivatedHandle);
+
+				OutBunchesPerShot = double(GetSentBunches(ClientState) - StartBunches) / double(NumActivations);
+			});
+	}
+
+	TEST_METHOD(ClientPlayer_Fire_SendsFewerBunchesPerShotWhenBatched)
+	{
+		Network.ThenClient(TEXT("Save the batching setting."), [this](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState) {
+			IConsoleVariable* BatchCVar = FindBatchCVar();
+			ASSERT_THAT(IsNotNull(BatchCVar, TEXT("lyra.AbilitySystem.BatchAbilityRPCs is not registered.")));
+			bPreviousBatchValue = BatchCVar->GetBool();
+		});
+
+		FireOnClientPlayer(false, UnbatchedBunchesPerShot);
+		FireOnClientPlayer(true, BatchedBunchesPerShot);
+
+		Network.ThenClient(TEXT("Compare the bunches sent per shot with and without batching."), [this](FShooterTestsNetworkState<FShooterTestsActorTestHelper>& ClientState) {
+			FindBatchCVar()->Set(bPreviousBatchValue, ECVF_SetByCode);
+
+			ASSERT_THAT(IsTrue(UnbatchedBunchesPerShot > 0.0, TEXT("Client did not send anything while firing.")));
+			ASSERT_THAT(IsTrue(BatchedBunchesPerShot < UnbatchedBunchesPerShot, *FString::Printf(TEXT("Batching did not reduce the bunches sent per shot (%.2f batched, %.2f unbatched)."), BatchedBunchesPerShot, UnbatchedBunchesPerShot)));
+		});
+	}
+};
+
+#endif // ENABLE_SHOOTERTESTS_NETWORK_TEST
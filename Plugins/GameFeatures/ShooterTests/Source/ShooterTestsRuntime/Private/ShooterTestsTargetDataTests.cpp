@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "CQTest.h"
+
+#if WITH_AUTOMATION_TESTS
+
+#include "AbilitySystem/LyraGameplayAbilityTargetData_CompressedCartridge.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+/**
+ * Creates a standalone test object using the name from the first parameter, in the case `CompressedCartridgeTest`, which inherits from `TTest<Derived, AsserterType>` to provide us our testing functionality.
+ * The second parameter specifies the category and subcategories used for displaying within the UI
+ * The third parameter specifies the flags as to what context the test will run in and the filter to be applied for the test to appear in the UI
+ *
+ * The test object will test the packed target data sent by clients when firing a multi-pellet weapon. All variables are reset after each test iteration.
+ *
+ * Each TEST_METHOD will register with the `CompressedCartridgeTest` test object and has the variables and methods from `CompressedCartridgeTest` available for use.
+ */
+TEST_CLASS_WITH_FLAGS(CompressedCartridgeTest, "Project.Functional Tests.ShooterTests.Weapon.TargetData", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+{
+	static constexpr int32 NumPellets = 8;
+
+	FLyraGameplayAbilityTargetData_CompressedCartridge* Cartridge{ nullptr };
+	FGameplayAbilityTargetDataHandle SingleHitsHandle;
+
+	/**
+	 * Run before each TEST_METHOD to build a shotgun cartridge and expand it into the per-pellet target data the ability produces when tracing
+	 */
+	BEFORE_EACH()
+	{
+		FRandomStream RandomStream(1234);
+
+		Cartridge = new FLyraGameplayAbilityTargetData_CompressedCartridge();
+		Cartridge->TraceStart = FVector(12345.6, -7890.1, 234.5);
+		Cartridge->CartridgeID = 4711;
+		Cartridge->FireTimestamp = 123.456f;
+
+		for (int32 PelletIndex = 0; PelletIndex < NumPellets; ++PelletIndex)
+		{
+			FLyraCompressedCartridgeHit& Hit = Cartridge->Hits.AddDefaulted_GetRef();
+			Hit.ImpactPoint = Cartridge->TraceStart + RandomStream.VRand() * RandomStream.FRandRange(100.0f, 5000.0f);
+			Hit.ImpactNormal = RandomStream.VRand();
+			Hit.bBlockingHit = true;
+		}
+
+		// Keep one pellet that missed everything
+		Cartridge->Hits.Last().bBlockingHit = false;
+		Cartridge->Hits.Last().ImpactNormal = FVector::ZeroVector;
+
+		SingleHitsHandle.Add(new FLyraGameplayAbilityTargetData_CompressedCartridge(*Cartridge));
+		ASSERT_THAT(IsTrue(FLyraGameplayAbilityTargetData_CompressedCartridge::ExpandHandle(SingleHitsHandle)));
+		ASSERT_THAT(AreEqual(NumPellets, SingleHitsHandle.Num()));
+	}
+
+	AFTER_EACH()
+	{
+		delete Cartridge;
+		Cartridge = nullptr;
+	}
+
+	int64 GetSerializedBits(FGameplayAbilityTargetData* Data)
+	{
+		FBitWriter Writer(0, true);
+		bool bSuccess = false;
+		Data->GetScriptStruct()->GetCppStructOps()->NetSerialize(Writer, nullptr, bSuccess, Data);
+		return Writer.GetNumBits();
+	}
+
+	TEST_METHOD(CompressedCartridge_IsSmallerThanSingleHits)
+	{
+		int64 SingleHitsBits = 0;
+		for (int32 Index = 0; Index < SingleHitsHandle.Num(); ++Index)
+		{
+			SingleHitsBits += GetSerializedBits(SingleHitsHandle.Get(Index));
+		}
+
+		FGameplayAbilityTargetDataHandle CompressedHandle;
+		ASSERT_THAT(IsTrue(FLyraGameplayAbilityTargetData_CompressedCartridge::CompressHandle(SingleHitsHandle, CompressedHandle)));
+		ASSERT_THAT(AreEqual(1, CompressedHandle.Num()));
+
+		const int64 CompressedBits = GetSerializedBits(CompressedHandle.Get(0));
+		TestRunner->AddInfo(FString::Printf(TEXT("%d pellets: %lld bytes as single hits, %lld bytes compressed"), NumPellets, (SingleHitsBits + 7) / 8, (CompressedBits + 7) / 8));
+
+		ASSERT_THAT(IsTrue(CompressedBits < SingleHitsBits));
+	}
+
+	TEST_METHOD(CompressedCartridge_RoundTripsWithinPrecision)
+	{
+		FBitWriter Writer(0, true);
+		bool bSuccess = false;
+		Cartridge->NetSerialize(Writer, nullptr, bSuccess);
+		ASSERT_THAT(IsTrue(bSuccess));
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		FLyraGameplayAbilityTargetData_CompressedCartridge Loaded;
+		Loaded.NetSerialize(Reader, nullptr, bSuccess);
+		ASSERT_THAT(IsTrue(bSuccess));
+		ASSERT_THAT(IsFalse(Reader.IsError()));
+
+		ASSERT_THAT(AreEqual(Cartridge->CartridgeID, Loaded.CartridgeID));
+		ASSERT_THAT(AreEqual(Cartridge->FireTimestamp, Loaded.FireTimestamp));
+		ASSERT_THAT(AreEqual(Cartridge->Hits.Num(), Loaded.Hits.Num()));
+
+		for (int32 HitIndex = 0; HitIndex < Loaded.Hits.Num(); ++HitIndex)
+		{
+			const FLyraCompressedCartridgeHit& Expected = Cartridge->Hits[HitIndex];
+			const FLyraCompressedCartridgeHit& Actual = Loaded.Hits[HitIndex];
+
+			ASSERT_THAT(AreEqual(Expected.bBlockingHit, Actual.bBlockingHit));
+			ASSERT_THAT(IsTrue(Expected.ImpactPoint.Equals(Actual.ImpactPoint, 0.2)));
+			if (Expected.bBlockingHit)
+			{
+				// 8 bits per octahedral axis keeps normals within about a degree
+				ASSERT_THAT(IsTrue((Expected.ImpactNormal | Actual.ImpactNormal) > 0.999));
+			}
+		}
+	}
+
+	TEST_METHOD(CompressHandle_RejectsMixedCartridges)
+	{
+		FLyraGameplayAbilityTargetData_CompressedCartridge* OtherCartridge = new FLyraGameplayAbilityTargetData_CompressedCartridge(*Cartridge);
+		OtherCartridge->CartridgeID++;
+
+		FGameplayAbilityTargetDataHandle OtherHitsHandle(OtherCartridge);
+		ASSERT_THAT(IsTrue(FLyraGameplayAbilityTargetData_CompressedCartridge::ExpandHandle(OtherHitsHandle)));
+		SingleHitsHandle.Append(OtherHitsHandle);
+
+		FGameplayAbilityTargetDataHandle CompressedHandle;
+		ASSERT_THAT(IsFalse(FLyraGameplayAbilityTargetData_CompressedCartridge::CompressHandle(SingleHitsHandle, CompressedHandle)));
+	}
+};
+
+#endif // WITH_AUTOMATION_TESTS
@@ -8,6 +8,7 @@
 #include "Weapons/LyraRangedWeaponInstance.h"
 #include "Character/LyraCharacter.h"
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 UBTS_TestPlayCheckAmmo::UBTS_TestPlayCheckAmmo()
 {
@@ -27,6 +28,8 @@ FString UBTS_TestPlayCheckAmmo::GetStaticDescription() const
 
 void UBTS_TestPlayCheckAmmo::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+    LYRA_SERVER_PERF_SCOPE(AIServices);
+
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
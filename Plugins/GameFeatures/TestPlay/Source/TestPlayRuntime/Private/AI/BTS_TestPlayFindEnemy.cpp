@@ -10,6 +10,7 @@
 #include "GameFramework/PlayerState.h"
 #include "Engine/World.h"
 #include "Engine/OverlapResult.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 UBTS_TestPlayFindEnemy::UBTS_TestPlayFindEnemy()
 {
@@ -27,6 +28,8 @@ UBTS_TestPlayFindEnemy::UBTS_TestPlayFindEnemy()
 
 void UBTS_TestPlayFindEnemy::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+    LYRA_SERVER_PERF_SCOPE(AIServices);
+
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
@@ -97,9 +100,8 @@ void UBTS_TestPlayFindEnemy::TickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 		QueryParams
 	);
 
-	AActor* BestTarget = nullptr;
-	float BestDistSq = SearchRadius * SearchRadius;
-
+	// 후보 수집 (LyraCharacter만 대상으로 함)
+	TArray<AActor*, TInlineAllocator<16>> Candidates;
 	for (const FOverlapResult& Overlap : Overlaps)
 	{
 		AActor* Actor = Overlap.GetActor();
@@ -108,7 +110,6 @@ void UBTS_TestPlayFindEnemy::TickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 			continue;
 		}
 
-		// LyraCharacter만 대상으로 함
 		if (!Actor->IsA(ALyraCharacter::StaticClass()))
 		{
 			continue;
@@ -117,14 +118,25 @@ void UBTS_TestPlayFindEnemy::TickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 		// 1. 살아있는지 확인 (간단히 액터 유효성만 체크하거나 HealthComponent 확인)
 		// (프로토타입 단계이므로 생략, 죽으면 Destroy되거나 Ragdoll이 됨을 가정)
 
-		// 2. 적대 관계인지 확인
-		ELyraTeamComparison TeamRelationship = TeamSubsystem->CompareTeams(MyPawn, Actor);
-		if (TeamRelationship != ELyraTeamComparison::DifferentTeams)
+		Candidates.AddUnique(Actor);
+	}
+
+	// 2. 적대 관계 확인 (내 팀은 한 번만 조회하고 후보 전체와 한 번에 비교)
+	TArray<ELyraTeamComparison> TeamRelationships;
+	TeamSubsystem->CompareTeamsBulk(MyPawn, Candidates, TeamRelationships);
+
+	AActor* BestTarget = nullptr;
+	float BestDistSq = SearchRadius * SearchRadius;
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+	{
+		if (TeamRelationships[CandidateIndex] != ELyraTeamComparison::DifferentTeams)
 		{
 			continue; // 같은 팀이거나 중립이면 무시
 		}
 
 		// 3. 거리 확인 (더 가까운 적 찾기)
+		AActor* Actor = Candidates[CandidateIndex];
 		float DistSq = FVector::DistSquared(MyPawn->GetActorLocation(), Actor->GetActorLocation());
 		if (DistSq < BestDistSq)
 		{
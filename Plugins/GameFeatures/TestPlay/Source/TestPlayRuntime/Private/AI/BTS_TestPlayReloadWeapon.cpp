@@ -6,6 +6,7 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
 #include "Character/LyraCharacter.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 UBTS_TestPlayReloadWeapon::UBTS_TestPlayReloadWeapon()
 {
@@ -28,6 +29,8 @@ FString UBTS_TestPlayReloadWeapon::GetStaticDescription() const
 
 void UBTS_TestPlayReloadWeapon::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+    LYRA_SERVER_PERF_SCOPE(AIServices);
+
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
@@ -4,6 +4,7 @@
 #include "AI/TestPlayAIConstants.h"
 #include "AIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 UBTS_TestPlaySetFocus::UBTS_TestPlaySetFocus()
 {
@@ -24,6 +25,8 @@ FString UBTS_TestPlaySetFocus::GetStaticDescription() const
 
 void UBTS_TestPlaySetFocus::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+    LYRA_SERVER_PERF_SCOPE(AIServices);
+
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
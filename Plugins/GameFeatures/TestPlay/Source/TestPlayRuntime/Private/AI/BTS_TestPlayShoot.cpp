@@ -8,6 +8,7 @@
 #include "Character/LyraCharacter.h"
 #include "Equipment/LyraEquipmentManagerComponent.h"
 #include "Weapons/LyraRangedWeaponInstance.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 // 디버그 로그 카테고리
 DEFINE_LOG_CATEGORY_STATIC(LogTestPlayShoot, Log, All);
@@ -32,6 +33,8 @@ FString UBTS_TestPlayShoot::GetStaticDescription() const
 
 void UBTS_TestPlayShoot::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+    LYRA_SERVER_PERF_SCOPE(AIServices);
+
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
@@ -10,6 +10,7 @@
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "DrawDebugHelpers.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogTestPlayMeleeHandler, Log, All);
 
@@ -62,6 +63,8 @@ void UTestPlayMeleeDamageHandler::UnbindFromMeleeTraceComponent()
 
 void UTestPlayMeleeDamageHandler::HandleMeleeHit(AActor* HitActor, const FHitResult& HitResult)
 {
+	LYRA_SERVER_PERF_SCOPE(MeleeHits);
+
 	if (!HitActor)
 	{
 		UE_LOG(LogTestPlayMeleeHandler, Warning, TEXT("HandleMeleeHit: HitActor가 nullptr입니다."));
@@ -135,6 +138,8 @@ void UTestPlayMeleeDamageHandler::HandleMeleeHit(AActor* HitActor, const FHitRes
 
 void UTestPlayMeleeDamageHandler::HandleMeleeHitBlocked(AActor* BlockingActor, const FHitResult& HitResult, FVector TraceDirection)
 {
+	LYRA_SERVER_PERF_SCOPE(MeleeHits);
+
 	AActor* Owner = GetOwner();
 	if (!Owner)
 	{
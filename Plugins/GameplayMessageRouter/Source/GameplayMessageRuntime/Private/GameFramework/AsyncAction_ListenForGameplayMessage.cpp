@@ -20,6 +20,7 @@ UAsyncAction_ListenForGameplayMessage* UAsyncAction_ListenForGameplayMessage::Li
 
 	UAsyncAction_ListenForGameplayMessage* Action = NewObject<UAsyncAction_ListenForGameplayMessage>();
 	Action->WorldPtr = World;
+	Action->DebugOwnerPtr = WorldContextObject;
 	Action->ChannelToRegister = Channel;
 	Action->MessageStructType = PayloadType;
 	Action->MessageMatchType = MatchType;
@@ -46,7 +47,8 @@ void UAsyncAction_ListenForGameplayMessage::Activate()
 					}
 				},
 				MessageStructType.Get(),
-				MessageMatchType);
+				MessageMatchType,
+				DebugOwnerPtr.Get());
 
 			return;
 		}
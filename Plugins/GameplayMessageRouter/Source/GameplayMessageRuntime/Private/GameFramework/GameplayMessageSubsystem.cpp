@@ -4,6 +4,8 @@
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "GameplayTagsManager.h"
+#include "HAL/IConsoleManager.h"
 #include "UObject/ScriptMacros.h"
 #include "UObject/Stack.h"
 
@@ -19,6 +21,194 @@ namespace UE
 		static FAutoConsoleVariableRef CVarShouldLogMessages(TEXT("GameplayMessageSubsystem.LogMessages"),
 			ShouldLogMessages,
 			TEXT("Should messages broadcast through the gameplay message subsystem be logged?"));
+
+#if !UE_BUILD_SHIPPING
+		static bool bCollectStats = false;
+		static FAutoConsoleVariableRef CVarCollectStats(TEXT("GameplayMessageSubsystem.Stats"),
+			bCollectStats,
+			TEXT("Should per channel and per listener counters (broadcasts, listeners invoked, time spent in callbacks) be collected?"));
+#else
+		// Stats are compiled out of shipping builds
+		static constexpr bool bCollectStats = false;
+#endif
+
+#if !UE_BUILD_SHIPPING
+		static UGameplayMessageSubsystem* GetRouterForWorld(UWorld* World)
+		{
+			UGameInstance* GameInstance = (World != nullptr) ? World->GetGameInstance() : nullptr;
+			return (GameInstance != nullptr) ? GameInstance->GetSubsystem<UGameplayMessageSubsystem>() : nullptr;
+		}
+
+		static FAutoConsoleCommandWithWorldAndArgs CmdDumpStats(
+			TEXT("GameplayMessageSubsystem.Stats.Dump"),
+			TEXT("Lists the hottest channels and slowest listeners since the stats were last reset. Usage: GameplayMessageSubsystem.Stats.Dump [NumToList]"),
+			FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+			{
+				if (UGameplayMessageSubsystem* Router = GetRouterForWorld(World))
+				{
+					Router->LogStats((Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10);
+				}
+			}));
+
+		static FAutoConsoleCommandWithWorld CmdResetStats(
+			TEXT("GameplayMessageSubsystem.Stats.Reset"),
+			TEXT("Resets the channel and listener counters of the gameplay message subsystem"),
+			FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+			{
+				if (UGameplayMessageSubsystem* Router = GetRouterForWorld(World))
+				{
+					Router->ResetStats();
+				}
+			}));
+
+		// Returns the requested channel, or the deepest registered tag so the parent chain walk is part of the measurement
+		static FGameplayTag FindBenchmarkChannel(const TArray<FString>& Args, int32 ChannelArgIndex)
+		{
+			FGameplayTag Channel = (Args.Num() > ChannelArgIndex) ? FGameplayTag::RequestGameplayTag(FName(*Args[ChannelArgIndex]), /*ErrorIfNotFound=*/ false) : FGameplayTag();
+			if (!Channel.IsValid())
+			{
+				FGameplayTagContainer AllTags;
+				UGameplayTagsManager::Get().RequestAllGameplayTags(/*out*/ AllTags, /*OnlyIncludeDictionaryTags=*/ true);
+
+				int32 DeepestNumParents = -1;
+				for (const FGameplayTag& Tag : AllTags)
+				{
+					const int32 NumParents = Tag.GetGameplayTagParents().Num();
+					if (NumParents > DeepestNumParents)
+					{
+						Channel = Tag;
+						DeepestNumParents = NumParents;
+					}
+				}
+			}
+
+			return Channel;
+		}
+
+		static void RunBroadcastBenchmark(const TArray<FString>& Args, UWorld* World)
+		{
+			UGameInstance* GameInstance = (World != nullptr) ? World->GetGameInstance() : nullptr;
+			if (GameInstance == nullptr)
+			{
+				UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("GameplayMessageSubsystem.Benchmark: requires a game instance"));
+				return;
+			}
+
+			const int32 NumBroadcasts = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+			const FGameplayTag Channel = FindBenchmarkChannel(Args, 1);
+			if (!Channel.IsValid())
+			{
+				UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("GameplayMessageSubsystem.Benchmark: no gameplay tag to broadcast on"));
+				return;
+			}
+
+			for (const int32 NumListeners : { 1, 10, 100 })
+			{
+				// A standalone router, so the benchmark does not invoke any real listeners
+				UGameplayMessageSubsystem* Router = NewObject<UGameplayMessageSubsystem>(GameInstance);
+
+				int64 NumReceived = 0;
+				for (int32 ListenerIndex = 0; ListenerIndex < NumListeners; ++ListenerIndex)
+				{
+					Router->RegisterListener<FVector>(Channel, [&NumReceived](FGameplayTag, const FVector&) { ++NumReceived; });
+				}
+
+				const FVector Message(1.0, 2.0, 3.0);
+				Router->BroadcastMessage(Channel, Message);
+
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 BroadcastIndex = 0; BroadcastIndex < NumBroadcasts; ++BroadcastIndex)
+				{
+					Router->BroadcastMessage(Channel, Message);
+				}
+				const double ElapsedSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
+				UE_LOG(LogGameplayMessageSubsystem, Display, TEXT("GameplayMessageSubsystem.Benchmark: %d listeners on %s, %d broadcasts in %.2f ms (%.0f broadcasts/s, %.1f ns per delivery, %lld deliveries)"),
+					NumListeners, *Channel.ToString(), NumBroadcasts, ElapsedSeconds * 1000.0, NumBroadcasts / ElapsedSeconds,
+					(ElapsedSeconds * 1e9) / FMath::Max<int64>(NumReceived, 1), NumReceived);
+
+				Router->MarkAsGarbage();
+			}
+		}
+
+		static FAutoConsoleCommandWithWorldAndArgs CmdBroadcastBenchmark(
+			TEXT("GameplayMessageSubsystem.Benchmark"),
+			TEXT("Measures broadcast throughput with 1, 10 and 100 listeners. Usage: GameplayMessageSubsystem.Benchmark [NumBroadcasts] [Channel]"),
+			FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunBroadcastBenchmark));
+
+		static void RunDeferredBenchmark(const TArray<FString>& Args, UWorld* World)
+		{
+			UGameInstance* GameInstance = (World != nullptr) ? World->GetGameInstance() : nullptr;
+			if (GameInstance == nullptr)
+			{
+				UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("GameplayMessageSubsystem.DeferredBenchmark: requires a game instance"));
+				return;
+			}
+
+			const int32 NumFrames = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+			const int32 NumItems = (Args.Num() > 1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 20;
+			const int32 NumChangesPerItem = (Args.Num() > 2) ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 5;
+
+			const FGameplayTag Channel = FindBenchmarkChannel(Args, 3);
+			if (!Channel.IsValid())
+			{
+				UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("GameplayMessageSubsystem.DeferredBenchmark: no gameplay tag to broadcast on"));
+				return;
+			}
+
+			// Simulates bursty inventory traffic: every frame, each item changes several times, and a UI listener rebuilds on every message it receives
+			const TCHAR* ModeNames[] = { TEXT("Immediate"), TEXT("Deferred"), TEXT("Deferred+Coalesced") };
+			for (int32 Mode = 0; Mode < UE_ARRAY_COUNT(ModeNames); ++Mode)
+			{
+				// A standalone router, so the benchmark does not invoke any real listeners
+				UGameplayMessageSubsystem* Router = NewObject<UGameplayMessageSubsystem>(GameInstance);
+				Router->SetChannelDeferred(Channel, Mode > 0);
+
+				TArray<UObject*> Items;
+				for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+				{
+					Items.Add(NewObject<UObject>(Router));
+				}
+
+				int64 NumRebuilds = 0;
+				Router->RegisterListener<FVector>(Channel, [&NumRebuilds](FGameplayTag, const FVector&) { ++NumRebuilds; });
+
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+				{
+					for (int32 ChangeIndex = 0; ChangeIndex < NumChangesPerItem; ++ChangeIndex)
+					{
+						for (UObject* Item : Items)
+						{
+							const FVector Message(FrameIndex, ChangeIndex, 0.0);
+							if (Mode == 2)
+							{
+								Router->BroadcastMessage(Channel, Message, Item);
+							}
+							else
+							{
+								Router->BroadcastMessage(Channel, Message);
+							}
+						}
+					}
+
+					Router->FlushDeferredMessages();
+				}
+				const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+				UE_LOG(LogGameplayMessageSubsystem, Display, TEXT("GameplayMessageSubsystem.DeferredBenchmark: %-18s %d frames of %d items x %d changes, %lld UI rebuilds (%.1f per frame) in %.2f ms"),
+					ModeNames[Mode], NumFrames, NumItems, NumChangesPerItem, NumRebuilds, (double)NumRebuilds / NumFrames, ElapsedSeconds * 1000.0);
+
+				Router->MarkAsGarbage();
+			}
+		}
+
+		static FAutoConsoleCommandWithWorldAndArgs CmdDeferredBenchmark(
+			TEXT("GameplayMessageSubsystem.DeferredBenchmark"),
+			TEXT("Counts listener invocations under bursty traffic with immediate, deferred and coalesced delivery. Usage: GameplayMessageSubsystem.DeferredBenchmark [NumFrames] [NumItems] [NumChangesPerItem] [Channel]"),
+			FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDeferredBenchmark));
+#endif // !UE_BUILD_SHIPPING
 	}
 }
 
@@ -55,14 +245,71 @@ bool UGameplayMessageSubsystem::HasInstance(const UObject* WorldContextObject)
 	return Router != nullptr;
 }
 
+void UGameplayMessageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	StatsResetTime = FPlatformTime::Seconds();
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::HandleWorldPostActorTick);
+}
+
 void UGameplayMessageSubsystem::Deinitialize()
 {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	for (const FDeferredMessage& Message : DeferredMessages)
+	{
+		Message.StructType->DestroyStruct(Message.Payload);
+	}
+	DeferredMessages.Reset();
+	CoalescedMessageIndices.Reset();
+	DeferredChannels.Reset();
+	for (FMemStackBase& Arena : DeferredArenas)
+	{
+		Arena.Flush();
+	}
+
 	ListenerMap.Reset();
+	ChannelChains.Reset();
+	ChannelChainTags.Reset();
+	ChannelStats.Reset();
+	ListenerStats.Reset();
 
 	Super::Deinitialize();
 }
 
-void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
+void UGameplayMessageSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	// Queued payloads are copies, keep whatever they point at alive until they are delivered
+	UGameplayMessageSubsystem* This = CastChecked<UGameplayMessageSubsystem>(InThis);
+	for (const FDeferredMessage& Message : This->DeferredMessages)
+	{
+		Collector.AddPropertyReferencesWithStructARO(Message.StructType, Message.Payload, This);
+	}
+	for (int32 Index = This->FlushingMessageIndex; Index < This->FlushingMessages.Num(); ++Index)
+	{
+		const FDeferredMessage& Message = This->FlushingMessages[Index];
+		Collector.AddPropertyReferencesWithStructARO(Message.StructType, Message.Payload, This);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey)
+{
+	if ((DeferredChannels.Num() > 0) && DeferredChannels.Contains(Channel))
+	{
+		QueueDeferredMessage(Channel, StructType, MessageBytes, CoalesceKey);
+	}
+	else
+	{
+		DeliverMessage(Channel, StructType, MessageBytes);
+	}
+}
+
+void UGameplayMessageSubsystem::DeliverMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
 {
 	// Log the message if enabled
 	if (UE::GameplayMessageSubsystem::ShouldLogMessages != 0)
@@ -82,42 +329,241 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 	}
 
 	// Broadcast the message
-	bool bOnInitialTag = true;
-	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	const bool bCollectStats = UE::GameplayMessageSubsystem::bCollectStats;
+	uint64 NumListenersInvoked = 0;
+	uint64 BroadcastCallbackCycles = 0;
+	++ActiveBroadcastDepth;
+
+	const FChannelChain Chain = GetChannelChain(Channel);
+	for (int32 ChainIndex = 0; ChainIndex < Chain.Num; ++ChainIndex)
 	{
-		if (const FChannelListenerList* pList = ListenerMap.Find(Tag))
+		// Index every time, listeners may cache new channels (and grow the storage) from within their callback
+		const FGameplayTag Tag = ChannelChainTags[Chain.FirstIndex + ChainIndex];
+		const bool bOnInitialTag = (ChainIndex == 0);
+
+		const TUniquePtr<FChannelListenerList>* pListPtr = ListenerMap.Find(Tag);
+		if (pListPtr == nullptr)
 		{
-			// Copy in case there are removals while handling callbacks
-			TArray<FGameplayMessageListenerData> ListenerArray(pList->Listeners);
+			continue;
+		}
+
+		// Registrations and removals made by the callbacks are deferred until the outermost broadcast finishes,
+		// so the array is neither copied nor resized while we walk it
+		FChannelListenerList& List = **pListPtr;
+		++List.BroadcastDepth;
+
+		const int32 NumListeners = List.Listeners.Num();
+		for (int32 ListenerIndex = 0; ListenerIndex < NumListeners; ++ListenerIndex)
+		{
+			const FGameplayMessageListenerData& Listener = List.Listeners[ListenerIndex];
+			if (Listener.HandleID == 0)
+			{
+				// Unregistered during this broadcast
+				continue;
+			}
 
-			for (const FGameplayMessageListenerData& Listener : ListenerArray)
+			if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
 			{
-				if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
+				if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
 				{
-					if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
-					{
-						UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
-						UnregisterListenerInternal(Channel, Listener.HandleID);
-						continue;
-					}
+					UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
+					UnregisterListenerInternal(Tag, Listener.HandleID);
+					continue;
+				}
 
-					// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
-					if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
+				// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
+				if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
+				{
+					if (bCollectStats)
 					{
+						// Listener stays valid, the list is not resized until the outermost broadcast finishes
+						FGameplayMessageListenerStats* Stats = Listener.Stats;
+						const uint64 StartCycles = FPlatformTime::Cycles64();
+
 						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+
+						const uint64 ElapsedCycles = FPlatformTime::Cycles64() - StartCycles;
+						++Stats->NumCalls;
+						Stats->TotalCycles += ElapsedCycles;
+						Stats->MaxCycles = FMath::Max(Stats->MaxCycles, ElapsedCycles);
+
+						++NumListenersInvoked;
+						BroadcastCallbackCycles += ElapsedCycles;
 					}
 					else
 					{
-						UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
-							*Channel.ToString(),
-							*StructType->GetPathName(),
-							*Tag.ToString(),
-							*Listener.ListenerStructType->GetPathName());
+						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
 					}
 				}
+				else
+				{
+					UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
+						*Channel.ToString(),
+						*StructType->GetPathName(),
+						*Tag.ToString(),
+						*Listener.ListenerStructType->GetPathName());
+				}
 			}
 		}
-		bOnInitialTag = false;
+
+		if (--List.BroadcastDepth == 0)
+		{
+			ApplyDeferredListenerChanges(Tag, List);
+		}
+	}
+
+	--ActiveBroadcastDepth;
+
+	if (bCollectStats)
+	{
+		FGameplayMessageChannelStats& Stats = ChannelStats[Chain.StatsIndex].Value;
+		++Stats.NumBroadcasts;
+		Stats.NumListenersInvoked += NumListenersInvoked;
+		Stats.CallbackCycles += BroadcastCallbackCycles;
+
+		if (ActiveBroadcastDepth == 0)
+		{
+			TotalCallbackCycles += BroadcastCallbackCycles;
+		}
+	}
+}
+
+void UGameplayMessageSubsystem::QueueDeferredMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey)
+{
+	const TPair<FGameplayTag, FObjectKey> CoalesceId(Channel, FObjectKey(CoalesceKey));
+	if (CoalesceKey != nullptr)
+	{
+		if (const int32* pQueuedIndex = CoalescedMessageIndices.Find(CoalesceId))
+		{
+			FDeferredMessage& QueuedMessage = DeferredMessages[*pQueuedIndex];
+			if (QueuedMessage.StructType == StructType)
+			{
+				// Last writer wins, the message keeps the queue position of the first one
+				StructType->CopyScriptStruct(QueuedMessage.Payload, MessageBytes);
+
+				if (UE::GameplayMessageSubsystem::bCollectStats)
+				{
+					++ChannelStats[GetChannelChain(Channel).StatsIndex].Value.NumCoalesced;
+				}
+				return;
+			}
+		}
+	}
+
+	FDeferredMessage& Message = DeferredMessages.AddDefaulted_GetRef();
+	Message.Channel = Channel;
+	Message.StructType = StructType;
+	Message.CoalesceKey = FObjectKey(CoalesceKey);
+	Message.Payload = DeferredArenas[ActiveArenaIndex].Alloc(FMath::Max(StructType->GetStructureSize(), 1), StructType->GetMinAlignment());
+	StructType->InitializeStruct(Message.Payload);
+	StructType->CopyScriptStruct(Message.Payload, MessageBytes);
+
+	if (CoalesceKey != nullptr)
+	{
+		CoalescedMessageIndices.Add(CoalesceId, DeferredMessages.Num() - 1);
+	}
+}
+
+void UGameplayMessageSubsystem::SetChannelDeferred(FGameplayTag Channel, bool bDeferred)
+{
+	// Messages already queued on the channel are still delivered by the next flush
+	if (bDeferred)
+	{
+		DeferredChannels.Add(Channel);
+	}
+	else
+	{
+		DeferredChannels.Remove(Channel);
+	}
+}
+
+void UGameplayMessageSubsystem::FlushDeferredMessages()
+{
+	if (bFlushingDeferredMessages || (DeferredMessages.Num() == 0))
+	{
+		return;
+	}
+
+	TGuardValue<bool> FlushGuard(bFlushingDeferredMessages, true);
+
+	// Listeners can broadcast on deferred channels while we deliver, those messages are queued in the
+	// other arena and wait for the next flush
+	FlushingMessages = MoveTemp(DeferredMessages);
+	FlushingMessageIndex = 0;
+	DeferredMessages.Reset();
+	CoalescedMessageIndices.Reset();
+
+	FMemStackBase& Arena = DeferredArenas[ActiveArenaIndex];
+	ActiveArenaIndex ^= 1;
+
+	// Index based, the messages not delivered yet stay visible to AddReferencedObjects if a listener triggers a GC
+	while (FlushingMessageIndex < FlushingMessages.Num())
+	{
+		const FDeferredMessage& Message = FlushingMessages[FlushingMessageIndex];
+		DeliverMessage(Message.Channel, Message.StructType, Message.Payload);
+		Message.StructType->DestroyStruct(Message.Payload);
+		++FlushingMessageIndex;
+	}
+
+	Arena.Flush();
+
+	FlushingMessages.Reset();
+	FlushingMessageIndex = 0;
+
+	// Hand the queue's allocation back for the next frame
+	if (DeferredMessages.Num() == 0)
+	{
+		Swap(DeferredMessages, FlushingMessages);
+	}
+}
+
+void UGameplayMessageSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World->GetGameInstance() == GetGameInstance())
+	{
+		FlushDeferredMessages();
+	}
+}
+
+UGameplayMessageSubsystem::FChannelChain UGameplayMessageSubsystem::GetChannelChain(FGameplayTag Channel)
+{
+	if (const FChannelChain* pChain = ChannelChains.Find(Channel))
+	{
+		return *pChain;
+	}
+
+	FChannelChain& Chain = ChannelChains.Add(Channel);
+	Chain.FirstIndex = ChannelChainTags.Num();
+	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		ChannelChainTags.Add(Tag);
+	}
+	Chain.Num = ChannelChainTags.Num() - Chain.FirstIndex;
+#if !UE_BUILD_SHIPPING
+	Chain.StatsIndex = ChannelStats.Emplace(Channel, FGameplayMessageChannelStats());
+#endif
+
+	return Chain;
+}
+
+void UGameplayMessageSubsystem::ApplyDeferredListenerChanges(FGameplayTag Channel, FChannelListenerList& List)
+{
+	if (List.bHasRemovedListeners)
+	{
+		List.Listeners.RemoveAllSwap([](const FGameplayMessageListenerData& Listener) { return Listener.HandleID == 0; }, EAllowShrinking::No);
+		List.bHasRemovedListeners = false;
+	}
+
+	if (List.PendingListeners.Num() > 0)
+	{
+		List.Listeners.Append(MoveTemp(List.PendingListeners));
+		List.PendingListeners.Reset();
+	}
+
+	if (List.Listeners.Num() == 0)
+	{
+		// Destroys List
+		ListenerMap.Remove(Channel);
 	}
 }
 
@@ -144,16 +590,27 @@ DEFINE_FUNCTION(UGameplayMessageSubsystem::execK2_BroadcastMessage)
 	}
 }
 
-FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType)
+FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType, const UObject* DebugOwner)
 {
-	FChannelListenerList& List = ListenerMap.FindOrAdd(Channel);
+	TUniquePtr<FChannelListenerList>& ListPtr = ListenerMap.FindOrAdd(Channel);
+	if (!ListPtr.IsValid())
+	{
+		ListPtr = MakeUnique<FChannelListenerList>();
+	}
+	FChannelListenerList& List = *ListPtr;
 
-	FGameplayMessageListenerData& Entry = List.Listeners.AddDefaulted_GetRef();
+	// Listeners registered from within a broadcast on this channel will receive the next message
+	TArray<FGameplayMessageListenerData>& TargetArray = (List.BroadcastDepth > 0) ? List.PendingListeners : List.Listeners;
+
+	FGameplayMessageListenerData& Entry = TargetArray.AddDefaulted_GetRef();
 	Entry.ReceivedCallback = MoveTemp(Callback);
 	Entry.ListenerStructType = StructType;
 	Entry.bHadValidType = StructType != nullptr;
 	Entry.HandleID = ++List.HandleID;
 	Entry.MatchType = MatchType;
+#if !UE_BUILD_SHIPPING
+	Entry.Stats = FindOrAddListenerStats(Channel, DebugOwner);
+#endif
 
 	return FGameplayMessageListenerHandle(this, Channel, Entry.HandleID);
 }
@@ -174,18 +631,126 @@ void UGameplayMessageSubsystem::UnregisterListener(FGameplayMessageListenerHandl
 
 void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID)
 {
-	if (FChannelListenerList* pList = ListenerMap.Find(Channel))
+	if (TUniquePtr<FChannelListenerList>* pListPtr = ListenerMap.Find(Channel))
 	{
-		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; });
+		FChannelListenerList& List = **pListPtr;
+		auto MatchesHandle = [ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; };
+
+		if (List.BroadcastDepth > 0)
+		{
+			// The list is being iterated, only flag the entry (its callback may be the one currently executing)
+			if (FGameplayMessageListenerData* Match = List.Listeners.FindByPredicate(MatchesHandle))
+			{
+				Match->HandleID = 0;
+				List.bHasRemovedListeners = true;
+			}
+			else
+			{
+				const int32 PendingIndex = List.PendingListeners.IndexOfByPredicate(MatchesHandle);
+				if (PendingIndex != INDEX_NONE)
+				{
+					List.PendingListeners.RemoveAtSwap(PendingIndex);
+				}
+			}
+			return;
+		}
+
+		int32 MatchIndex = List.Listeners.IndexOfByPredicate(MatchesHandle);
 		if (MatchIndex != INDEX_NONE)
 		{
-			pList->Listeners.RemoveAtSwap(MatchIndex);
+			List.Listeners.RemoveAtSwap(MatchIndex);
 		}
 
-		if (pList->Listeners.Num() == 0)
+		if (List.Listeners.Num() == 0)
 		{
 			ListenerMap.Remove(Channel);
 		}
 	}
 }
 
+FGameplayMessageListenerStats* UGameplayMessageSubsystem::FindOrAddListenerStats(FGameplayTag Channel, const UObject* DebugOwner)
+{
+	const FName DebugName(*FString::Printf(TEXT("%s (%s)"), (DebugOwner != nullptr) ? *DebugOwner->GetClass()->GetName() : TEXT("Unknown"), *Channel.ToString()));
+
+	TUniquePtr<FGameplayMessageListenerStats>& StatsPtr = ListenerStats.FindOrAdd(DebugName);
+	if (!StatsPtr.IsValid())
+	{
+		StatsPtr = MakeUnique<FGameplayMessageListenerStats>();
+		StatsPtr->DebugName = DebugName;
+	}
+	return StatsPtr.Get();
+}
+
+void UGameplayMessageSubsystem::GetChannelStats(TArray<TPair<FGameplayTag, FGameplayMessageChannelStats>>& OutStats) const
+{
+	OutStats.Reset(ChannelStats.Num());
+	for (const TPair<FGameplayTag, FGameplayMessageChannelStats>& Entry : ChannelStats)
+	{
+		if (Entry.Value.NumBroadcasts > 0)
+		{
+			OutStats.Add(Entry);
+		}
+	}
+}
+
+void UGameplayMessageSubsystem::GetListenerStats(TArray<FGameplayMessageListenerStats>& OutStats) const
+{
+	OutStats.Reset(ListenerStats.Num());
+	for (const TPair<FName, TUniquePtr<FGameplayMessageListenerStats>>& Entry : ListenerStats)
+	{
+		OutStats.Add(*Entry.Value);
+	}
+}
+
+void UGameplayMessageSubsystem::LogStats(int32 NumToList) const
+{
+	const double ElapsedSeconds = FMath::Max(FPlatformTime::Seconds() - StatsResetTime, UE_DOUBLE_SMALL_NUMBER);
+	if (!UE::GameplayMessageSubsystem::bCollectStats)
+	{
+		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("Stats are not being collected (see GameplayMessageSubsystem.Stats)"));
+	}
+
+	TArray<TPair<FGameplayTag, FGameplayMessageChannelStats>> Channels;
+	GetChannelStats(Channels);
+	Channels.Sort([](const TPair<FGameplayTag, FGameplayMessageChannelStats>& A, const TPair<FGameplayTag, FGameplayMessageChannelStats>& B) { return A.Value.CallbackCycles > B.Value.CallbackCycles; });
+
+	UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("Hottest channels over the last %.1f seconds:"), ElapsedSeconds);
+	for (int32 Index = 0; Index < FMath::Min(NumToList, Channels.Num()); ++Index)
+	{
+		const FGameplayMessageChannelStats& Stats = Channels[Index].Value;
+		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("  %-48s %8.2f ms  %8llu broadcasts (%.1f/s)  %8llu listener calls  %8llu coalesced"),
+			*Channels[Index].Key.ToString(), FPlatformTime::ToMilliseconds64(Stats.CallbackCycles), Stats.NumBroadcasts, Stats.NumBroadcasts / ElapsedSeconds, Stats.NumListenersInvoked, Stats.NumCoalesced);
+	}
+
+	TArray<FGameplayMessageListenerStats> Listeners;
+	GetListenerStats(Listeners);
+	Listeners.RemoveAllSwap([](const FGameplayMessageListenerStats& Stats) { return Stats.NumCalls == 0; });
+	Listeners.Sort([](const FGameplayMessageListenerStats& A, const FGameplayMessageListenerStats& B) { return A.TotalCycles > B.TotalCycles; });
+
+	UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("Slowest listeners:"));
+	for (int32 Index = 0; Index < FMath::Min(NumToList, Listeners.Num()); ++Index)
+	{
+		const FGameplayMessageListenerStats& Stats = Listeners[Index];
+		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("  %-64s %8.2f ms  %8llu calls  avg %.3f ms  max %.3f ms"),
+			*Stats.DebugName.ToString(), FPlatformTime::ToMilliseconds64(Stats.TotalCycles), Stats.NumCalls,
+			FPlatformTime::ToMilliseconds64(Stats.TotalCycles) / Stats.NumCalls, FPlatformTime::ToMilliseconds64(Stats.MaxCycles));
+	}
+}
+
+void UGameplayMessageSubsystem::ResetStats()
+{
+	for (TPair<FGameplayTag, FGameplayMessageChannelStats>& Entry : ChannelStats)
+	{
+		Entry.Value = FGameplayMessageChannelStats();
+	}
+
+	// Registered listeners point at the entries, so only clear them
+	for (TPair<FName, TUniquePtr<FGameplayMessageListenerStats>>& Entry : ListenerStats)
+	{
+		Entry.Value->NumCalls = 0;
+		Entry.Value->TotalCycles = 0;
+		Entry.Value->MaxCycles = 0;
+	}
+
+	StatsResetTime = FPlatformTime::Seconds();
+}
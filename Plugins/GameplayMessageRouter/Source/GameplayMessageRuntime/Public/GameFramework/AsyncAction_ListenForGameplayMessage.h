@@ -68,6 +68,9 @@ private:
 	TWeakObjectPtr<UScriptStruct> MessageStructType = nullptr;
 	EGameplayMessageMatch MessageMatchType = EGameplayMessageMatch::ExactMatch;
 
+	// The object that started listening, reported in the message subsystem stats
+	TWeakObjectPtr<const UObject> DebugOwnerPtr;
+
 	FGameplayMessageListenerHandle ListenerHandle;
 };
 
@@ -2,9 +2,12 @@
 
 #pragma once
 
+#include "Engine/EngineBaseTypes.h"
 #include "GameplayMessageTypes2.h"
 #include "GameplayTagContainer.h"
+#include "Misc/MemStack.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/WeakObjectPtr.h"
 
 #include "GameplayMessageSubsystem.generated.h"
@@ -51,6 +54,33 @@ private:
 	FGameplayMessageListenerHandle(UGameplayMessageSubsystem* InSubsystem, FGameplayTag InChannel, int32 InID) : Subsystem(InSubsystem), Channel(InChannel), ID(InID) {}
 };
 
+/**
+ * Counters of a single broadcast channel, collected while GameplayMessageSubsystem.Stats is enabled
+ */
+struct FGameplayMessageChannelStats
+{
+	uint64 NumBroadcasts = 0;
+	uint64 NumListenersInvoked = 0;
+
+	// Messages that replaced an older message still queued on a deferred channel (and so were never broadcast)
+	uint64 NumCoalesced = 0;
+
+	// Time spent in listener callbacks, including any broadcast they make themselves
+	uint64 CallbackCycles = 0;
+};
+
+/**
+ * Counters of the listeners registered on a channel by one kind of owner (listeners are grouped by owner class,
+ * so the stats survive the listeners being unregistered)
+ */
+struct FGameplayMessageListenerStats
+{
+	FName DebugName;
+	uint64 NumCalls = 0;
+	uint64 TotalCycles = 0;
+	uint64 MaxCycles = 0;
+};
+
 /** 
  * Entry information for a single registered listener
  */
@@ -62,12 +92,16 @@ struct FGameplayMessageListenerData
 	// Callback for when a message has been received
 	TFunction<void(FGameplayTag, const UScriptStruct*, const void*)> ReceivedCallback;
 
+	// Zero once the listener has been unregistered while its list was being broadcast to
 	int32 HandleID;
 	EGameplayMessageMatch MatchType;
 
 	// Adding some logging and extra variables around some potential problems with this
 	TWeakObjectPtr<const UScriptStruct> ListenerStructType = nullptr;
 	bool bHadValidType = false;
+
+	// Where the callback's counters go, owned by the subsystem
+	FGameplayMessageListenerStats* Stats = nullptr;
 };
 
 /**
@@ -104,9 +138,12 @@ public:
 	static UE_API bool HasInstance(const UObject* WorldContextObject);
 
 	//~USubsystem interface
+	UE_API virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	UE_API virtual void Deinitialize() override;
 	//~End of USubsystem interface
 
+	static UE_API void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 	/**
 	 * Broadcast a message on the specified channel
 	 *
@@ -120,6 +157,36 @@ public:
 		BroadcastMessageInternal(Channel, StructType, &Message);
 	}
 
+	/**
+	 * Broadcast a message on the specified channel, replacing any message with the same key still queued on it
+	 * Only deferred channels coalesce messages, on other channels this is the same as a regular broadcast
+	 *
+	 * @param Channel			The message channel to broadcast on
+	 * @param Message			The message to send (must be the same type of UScriptStruct expected by the listeners for this channel, otherwise an error will be logged)
+	 * @param CoalesceKey		What the message is about (e.g., its instigator or item), only the last message queued for a key is delivered
+	 */
+	template <typename FMessageStructType>
+	void BroadcastMessage(FGameplayTag Channel, const FMessageStructType& Message, const UObject* CoalesceKey)
+	{
+		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
+		BroadcastMessageInternal(Channel, StructType, &Message, CoalesceKey);
+	}
+
+	/**
+	 * Sets whether broadcasts on exactly this channel are queued and delivered together once the world has
+	 * finished ticking actors, rather than synchronously from within the broadcast.
+	 * Useful for bursty channels whose listeners do expensive work (e.g., rebuilding UI) for every message.
+	 * Queued messages are delivered in the order they were broadcast, to the listeners registered at delivery time.
+	 */
+	UE_API void SetChannelDeferred(FGameplayTag Channel, bool bDeferred);
+
+	bool IsChannelDeferred(FGameplayTag Channel) const { return DeferredChannels.Contains(Channel); }
+
+	/** Delivers the messages queued on deferred channels (done automatically every frame) */
+	UE_API void FlushDeferredMessages();
+
+	int32 GetNumDeferredMessages() const { return DeferredMessages.Num(); }
+
 	/**
 	 * Register to receive messages on a specified channel
 	 *
@@ -154,14 +221,16 @@ public:
 	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TOwner* Object, void(TOwner::* Function)(FGameplayTag, const FMessageStructType&))
 	{
 		TWeakObjectPtr<TOwner> WeakObject(Object);
-		return RegisterListener<FMessageStructType>(Channel,
-			[WeakObject, Function](FGameplayTag Channel, const FMessageStructType& Payload)
+		auto ThunkCallback = [WeakObject, Function](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload)
+		{
+			if (TOwner* StrongObject = WeakObject.Get())
 			{
-				if (TOwner* StrongObject = WeakObject.Get())
-				{
-					(StrongObject->*Function)(Channel, Payload);
-				}
-			});
+				(StrongObject->*Function)(ActualTag, *reinterpret_cast<const FMessageStructType*>(SenderPayload));
+			}
+		};
+
+		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
+		return RegisterListenerInternal(Channel, ThunkCallback, StructType, EGameplayMessageMatch::ExactMatch, Object);
 	}
 
 	/**
@@ -200,6 +269,20 @@ public:
 	 */
 	UE_API void UnregisterListener(FGameplayMessageListenerHandle Handle);
 
+	/** Returns the counters of every channel that was broadcast on since the stats were last reset */
+	UE_API void GetChannelStats(TArray<TPair<FGameplayTag, FGameplayMessageChannelStats>>& OutStats) const;
+
+	/** Returns the counters of every kind of listener that was registered since the stats were last reset */
+	UE_API void GetListenerStats(TArray<FGameplayMessageListenerStats>& OutStats) const;
+
+	/** Writes the NumToList hottest channels and slowest listeners to the log */
+	UE_API void LogStats(int32 NumToList) const;
+
+	UE_API void ResetStats();
+
+	/** Time spent in listener callbacks since the subsystem started (only counted while stats are enabled) */
+	uint64 GetTotalCallbackCycles() const { return TotalCallbackCycles; }
+
 protected:
 	/**
 	 * Broadcast a message on the specified channel
@@ -213,15 +296,23 @@ protected:
 	DECLARE_FUNCTION(execK2_BroadcastMessage);
 
 private:
-	// Internal helper for broadcasting a message
-	UE_API void BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes);
+	// Internal helper for broadcasting a message, queues it if the channel is deferred
+	UE_API void BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey = nullptr);
+
+	// Calls the listeners of a channel (and its parents)
+	void DeliverMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes);
+
+	void QueueDeferredMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey);
+
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
 
 	// Internal helper for registering a message listener
 	UE_API FGameplayMessageListenerHandle RegisterListenerInternal(
 		FGameplayTag Channel, 
 		TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback,
 		const UScriptStruct* StructType,
-		EGameplayMessageMatch MatchType);
+		EGameplayMessageMatch MatchType,
+		const UObject* DebugOwner = nullptr);
 
 	UE_API void UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID);
 
@@ -230,11 +321,85 @@ private:
 	struct FChannelListenerList
 	{
 		TArray<FGameplayMessageListenerData> Listeners;
+
+		// Listeners registered while Listeners was being iterated, appended once no broadcast is in progress
+		TArray<FGameplayMessageListenerData> PendingListeners;
+
 		int32 HandleID = 0;
+
+		// Number of broadcasts currently iterating over Listeners (can be more than one for nested broadcasts)
+		int32 BroadcastDepth = 0;
+
+		// Set when listeners were unregistered during a broadcast and still need to be removed from Listeners
+		bool bHasRemovedListeners = false;
+	};
+
+	// Range in ChannelChainTags holding a channel followed by all of its parent tags
+	struct FChannelChain
+	{
+		int32 FirstIndex = 0;
+		int32 Num = 0;
+
+		// Index of the channel's counters in ChannelStats
+		int32 StatsIndex = INDEX_NONE;
 	};
 
+	// Returns the cached parent chain for a channel, building it on first use
+	FChannelChain GetChannelChain(FGameplayTag Channel);
+
+	// Applies the registrations and removals deferred while a list was being broadcast to
+	void ApplyDeferredListenerChanges(FGameplayTag Channel, FChannelListenerList& List);
+
+	// Returns the counters shared by the listeners of the same owner class on a channel
+	FGameplayMessageListenerStats* FindOrAddListenerStats(FGameplayTag Channel, const UObject* DebugOwner);
+
 private:
-	TMap<FGameplayTag, FChannelListenerList> ListenerMap;
+	// Lists are heap allocated so they stay put while listeners register new channels from within a broadcast
+	TMap<FGameplayTag, TUniquePtr<FChannelListenerList>> ListenerMap;
+
+	// Cached tag hierarchy walks, so broadcasting does not query the tag manager for parents every time
+	TMap<FGameplayTag, FChannelChain> ChannelChains;
+	TArray<FGameplayTag> ChannelChainTags;
+
+	// Counters of each broadcast channel, indexed by FChannelChain::StatsIndex
+	TArray<TPair<FGameplayTag, FGameplayMessageChannelStats>> ChannelStats;
+
+	// Heap allocated so listeners can keep pointing at them while more are added
+	TMap<FName, TUniquePtr<FGameplayMessageListenerStats>> ListenerStats;
+
+	uint64 TotalCallbackCycles = 0;
+	double StatsResetTime = 0.0;
+
+	// Number of broadcasts in progress, so nested broadcasts are not counted twice in TotalCallbackCycles
+	int32 ActiveBroadcastDepth = 0;
+
+	// A message waiting for the next flush, its payload is allocated from DeferredArenas[ActiveArenaIndex]
+	struct FDeferredMessage
+	{
+		FGameplayTag Channel;
+		const UScriptStruct* StructType = nullptr;
+		void* Payload = nullptr;
+		FObjectKey CoalesceKey;
+	};
+
+	TSet<FGameplayTag> DeferredChannels;
+
+	TArray<FDeferredMessage> DeferredMessages;
+
+	// Messages taken from DeferredMessages by the flush in progress, the ones from FlushingMessageIndex on are not delivered yet
+	TArray<FDeferredMessage> FlushingMessages;
+	int32 FlushingMessageIndex = 0;
+
+	// Index in DeferredMessages of the queued message for a channel and coalescing key
+	TMap<TPair<FGameplayTag, FObjectKey>, int32> CoalescedMessageIndices;
+
+	// Messages broadcast while a flush is delivering go to the other arena, and are delivered by the next flush
+	FMemStackBase DeferredArenas[2];
+	int32 ActiveArenaIndex = 0;
+
+	bool bFlushingDeferredMessages = false;
+
+	FDelegateHandle PostActorTickHandle;
 };
 
 #undef UE_API
@@ -15,9 +15,11 @@
 #include "GameFramework/GameplayMessageSubsystem.h"
 #include "AbilitySystem/LyraAbilitySourceInterface.h"
 #include "AbilitySystem/LyraGameplayEffectContext.h"
+#include "AbilitySystem/LyraGameplayCueManager.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "GameFramework/PlayerState.h"
 #include "Camera/LyraCameraMode.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayAbility)
 
@@ -30,6 +32,12 @@
 	}																																					\
 }
 
+namespace LyraGameplayAbility
+{
+	// Number of ability activations in progress on the game thread, so abilities activated by another one are not timed twice
+	static int32 ActivationDepth = 0;
+}
+
 UE_DEFINE_GAMEPLAY_TAG(TAG_ABILITY_SIMPLE_FAILURE_MESSAGE, "Ability.UserFacingSimpleActivateFail.Message");
 UE_DEFINE_GAMEPLAY_TAG(TAG_ABILITY_PLAY_MONTAGE_FAILURE_MESSAGE, "Ability.PlayMontageOnActivateFail.Message");
 
@@ -177,6 +185,15 @@ void ULyraGameplayAbility::OnGiveAbility(const FGameplayAbilityActorInfo* ActorI
 
 	K2_OnAbilityAdded();
 
+	// Abilities granted to a local player (e.g., by equipping a weapon) are likely to play their cues soon
+	if (ActorInfo && ActorInfo->IsLocallyControlled())
+	{
+		if (ULyraGameplayCueManager* GCM = ULyraGameplayCueManager::Get())
+		{
+			GCM->PrioritizeCuePreloadsFor(GetClass());
+		}
+	}
+
 	TryActivateAbilityOnSpawn(ActorInfo, Spec);
 }
 
@@ -187,6 +204,20 @@ void ULyraGameplayAbility::OnRemoveAbility(const FGameplayAbilityActorInfo* Acto
 	Super::OnRemoveAbility(ActorInfo, Spec);
 }
 
+void ULyraGameplayAbility::CallActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, FOnGameplayAbilityEnded::FDelegate* OnGameplayAbilityEndedDelegate, const FGameplayEventData* TriggerEventData)
+{
+	// Timed here rather than in ActivateAbility so the work subclasses do after calling Super is included,
+	// and only the outermost activation records since nested ones are already part of its time
+	TOptional<FLyraScopedServerPerfTimer> PerfScope;
+	if (LyraGameplayAbility::ActivationDepth == 0)
+	{
+		PerfScope.Emplace(ELyraServerPerfTimer::AbilityActivation);
+	}
+	TGuardValue<int32> DepthGuard(LyraGameplayAbility::ActivationDepth, LyraGameplayAbility::ActivationDepth + 1);
+
+	Super::CallActivateAbility(Handle, ActorInfo, ActivationInfo, OnGameplayAbilityEndedDelegate, TriggerEventData);
+}
+
 void ULyraGameplayAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
 {
 	Super::ActivateAbility(Handle, ActorInfo, ActivationInfo, TriggerEventData);
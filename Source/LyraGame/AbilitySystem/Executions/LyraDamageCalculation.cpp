@@ -0,0 +1,318 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraDamageCalculation.h"
+
+#include "AbilitySystem/Attributes/LyraCombatSet.h"
+#include "AbilitySystem/Attributes/LyraHealthSet.h"
+#include "AbilitySystem/LyraAbilitySourceInterface.h"
+#include "AbilitySystem/LyraGameplayEffectContext.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraGameplayTags.h"
+#include "LyraLogChannels.h"
+#include "System/LyraAssetManager.h"
+#include "System/LyraGameData.h"
+#include "Teams/LyraTeamSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+namespace LyraConsoleVariables
+{
+	static bool bCacheDamageTeamChecks = true;
+	static FAutoConsoleVariableRef CVarCacheDamageTeamChecks(
+		TEXT("lyra.Damage.CacheTeamChecks"),
+		bCacheDamageTeamChecks,
+		TEXT("Should damage executions reuse the team check between an instigator and a target for the rest of the frame?"),
+		ECVF_Default);
+}
+
+namespace LyraDamageCalculation
+{
+	struct FDamageStatics
+	{
+		FGameplayEffectAttributeCaptureDefinition BaseDamageDef;
+
+		FDamageStatics()
+		{
+			BaseDamageDef = FGameplayEffectAttributeCaptureDefinition(ULyraCombatSet::GetBaseDamageAttribute(), EGameplayEffectAttributeCaptureSource::Source, true);
+		}
+	};
+
+	static FDamageStatics& DamageStatics()
+	{
+		static FDamageStatics Statics;
+		return Statics;
+	}
+
+	// Team checks made this frame (game thread only)
+	struct FFrameTeamCheckCache
+	{
+		uint64 FrameNumber = MAX_uint64;
+		TMap<TPair<FObjectKey, FObjectKey>, bool> CanCauseDamage;
+
+		void ResetIfStale()
+		{
+			if (FrameNumber != GFrameCounter)
+			{
+				FrameNumber = GFrameCounter;
+				CanCauseDamage.Reset();
+			}
+		}
+	};
+	static FFrameTeamCheckCache TeamCheckCache;
+}
+
+const FGameplayEffectAttributeCaptureDefinition& FLyraDamageCalculation::GetBaseDamageCaptureDef()
+{
+	return LyraDamageCalculation::DamageStatics().BaseDamageDef;
+}
+
+bool FLyraDamageCalculation::CanCauseDamageCached(const UWorld* World, const UObject* Instigator, const UObject* Target, bool bAllowDamageWithoutTeamSubsystem)
+{
+	using namespace LyraDamageCalculation;
+
+	const ULyraTeamSubsystem* TeamSubsystem = World ? World->GetSubsystem<ULyraTeamSubsystem>() : nullptr;
+	if (TeamSubsystem == nullptr)
+	{
+		ensure(bAllowDamageWithoutTeamSubsystem);
+		return bAllowDamageWithoutTeamSubsystem;
+	}
+
+	if (!LyraConsoleVariables::bCacheDamageTeamChecks || !IsInGameThread())
+	{
+		return TeamSubsystem->CanCauseDamage(Instigator, Target);
+	}
+
+	TeamCheckCache.ResetIfStale();
+
+	const TPair<FObjectKey, FObjectKey> Key(Instigator, Target);
+	if (const bool* CachedResult = TeamCheckCache.CanCauseDamage.Find(Key))
+	{
+		return *CachedResult;
+	}
+
+	const bool bResult = TeamSubsystem->CanCauseDamage(Instigator, Target);
+	TeamCheckCache.CanCauseDamage.Add(Key, bResult);
+	return bResult;
+}
+
+float FLyraDamageCalculation::Execute(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput, const FLyraDamageCalculationOptions& Options, FLyraDamageCalculationResult* OutResult)
+{
+	FLyraDamageCalculationResult Result;
+
+	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
+	FLyraGameplayEffectContext* TypedContext = FLyraGameplayEffectContext::ExtractEffectContext(Spec.GetContext());
+	if (!ensure(TypedContext))
+	{
+		return 0.0f;
+	}
+
+	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
+	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
+
+	FAggregatorEvaluateParameters EvaluateParameters;
+	EvaluateParameters.SourceTags = SourceTags;
+	EvaluateParameters.TargetTags = TargetTags;
+
+	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(GetBaseDamageCaptureDef(), EvaluateParameters, Result.BaseDamage);
+
+	const AActor* EffectCauser = TypedContext->GetEffectCauser();
+	const FHitResult* HitActorResult = TypedContext->GetHitResult();
+
+	FVector ImpactLocation = FVector::ZeroVector;
+
+	// Calculation of hit actor, surface, zone, and distance all rely on whether the calculation has a hit result or not.
+	// Effects just being added directly w/o having been targeted will always come in without a hit result, which must default
+	// to some fallback information.
+	if (HitActorResult)
+	{
+		Result.HitActor = HitActorResult->HitObjectHandle.FetchActor();
+		if (Result.HitActor)
+		{
+			ImpactLocation = HitActorResult->ImpactPoint;
+		}
+	}
+
+	// Handle case of no hit result or hit result not actually returning an actor
+	if (!Result.HitActor)
+	{
+		UAbilitySystemComponent* TargetAbilitySystemComponent = ExecutionParams.GetTargetAbilitySystemComponent();
+		Result.HitActor = TargetAbilitySystemComponent ? TargetAbilitySystemComponent->GetAvatarActor_Direct() : nullptr;
+		if (Result.HitActor)
+		{
+			ImpactLocation = Result.HitActor->GetActorLocation();
+		}
+	}
+
+	// Apply rules for team damage/self damage/etc...
+	if (Result.HitActor)
+	{
+		Result.DamageInteractionAllowedMultiplier = CanCauseDamageCached(Result.HitActor->GetWorld(), EffectCauser, Result.HitActor, Options.bAllowDamageWithoutTeamSubsystem) ? 1.0f : 0.0f;
+	}
+
+	// Nothing else matters if the damage is not allowed
+	if ((Result.DamageInteractionAllowedMultiplier > 0.0f) && (Result.BaseDamage > 0.0f))
+	{
+		const ILyraAbilitySourceInterface* AbilitySource = TypedContext->GetAbilitySource();
+
+		if (Options.bApplyDistanceAttenuation)
+		{
+			// Determine distance
+			if (TypedContext->HasOrigin())
+			{
+				Result.Distance = FVector::Dist(TypedContext->GetOrigin(), ImpactLocation);
+			}
+			else if (EffectCauser)
+			{
+				Result.Distance = FVector::Dist(EffectCauser->GetActorLocation(), ImpactLocation);
+			}
+			else
+			{
+				UE_LOG(LogLyraAbilitySystem, Error, TEXT("Damage Calculation cannot deduce a source location for damage coming from %s; Falling back to WORLD_MAX dist!"), *GetPathNameSafe(Spec.Def));
+			}
+
+			if (AbilitySource)
+			{
+				Result.DistanceAttenuation = FMath::Max(AbilitySource->GetDistanceAttenuation(Result.Distance, SourceTags, TargetTags), 0.0f);
+			}
+		}
+
+		if (Options.bApplyPhysicalMaterialAttenuation && AbilitySource)
+		{
+			if (const UPhysicalMaterial* PhysMat = TypedContext->GetPhysicalMaterial())
+			{
+				Result.PhysicalMaterialAttenuation = AbilitySource->GetPhysicalMaterialAttenuation(PhysMat, SourceTags, TargetTags);
+			}
+		}
+	}
+
+	// Clamping is done when damage is converted to -health
+	Result.DamageDone = FMath::Max(Result.BaseDamage * Result.DistanceAttenuation * Result.PhysicalMaterialAttenuation * Result.DamageInteractionAllowedMultiplier, 0.0f);
+
+	if (Result.DamageDone > 0.0f)
+	{
+		// Apply a damage modifier, this gets turned into - health on the target
+		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(ULyraHealthSet::GetDamageAttribute(), EGameplayModOp::Additive, Result.DamageDone));
+	}
+
+	if (OutResult)
+	{
+		*OutResult = Result;
+	}
+
+	return Result.DamageDone;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+#if !UE_BUILD_SHIPPING
+namespace LyraDamageCalculation
+{
+	// Applies the damage effect NumHits times between the pawns in the world, with and without the frame cache of team checks
+	static void RunBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumHits = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+
+		if ((World == nullptr) || (World->GetSubsystem<ULyraTeamSubsystem>() == nullptr))
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Damage benchmark: no team subsystem in this world"));
+			return;
+		}
+
+		if (World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Damage benchmark: damage is only applied on the server"));
+			return;
+		}
+
+		const TSubclassOf<UGameplayEffect> DamageGE = ULyraAssetManager::GetSubclass(ULyraGameData::Get().DamageGameplayEffect_SetByCaller);
+		if (DamageGE.Get() == nullptr)
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Damage benchmark: no damage gameplay effect in the game data"));
+			return;
+		}
+
+		TArray<UAbilitySystemComponent*> AbilitySystems;
+		for (TActorIterator<APawn> It(World); It; ++It)
+		{
+			if (UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(*It))
+			{
+				AbilitySystems.AddUnique(AbilitySystem);
+			}
+		}
+
+		if (AbilitySystems.Num() < 2)
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Damage benchmark: needs at least two pawns with ability systems in the world (add bots)"));
+			return;
+		}
+
+		// The executions run in full, god mode only stops the health set from taking the damage at the end
+		TArray<UAbilitySystemComponent*> GodModeAdded;
+		for (UAbilitySystemComponent* AbilitySystem : AbilitySystems)
+		{
+			if (!AbilitySystem->HasMatchingGameplayTag(LyraGameplayTags::Cheat_GodMode))
+			{
+				AbilitySystem->AddLooseGameplayTag(LyraGameplayTags::Cheat_GodMode);
+				GodModeAdded.Add(AbilitySystem);
+			}
+		}
+
+		// Each instigator hits a handful of targets several times, like pellets of a shotgun blast
+		const int32 HitsPerTarget = 8;
+		auto RunHits = [&AbilitySystems, DamageGE, NumHits, HitsPerTarget]()
+		{
+			for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+			{
+				const int32 Blast = HitIndex / HitsPerTarget;
+				UAbilitySystemComponent* Source = AbilitySystems[Blast % AbilitySystems.Num()];
+				UAbilitySystemComponent* Target = AbilitySystems[(Blast / AbilitySystems.Num() + 1 + Blast) % AbilitySystems.Num()];
+
+				const FGameplayEffectSpecHandle SpecHandle = Source->MakeOutgoingSpec(DamageGE, 1.0f, Source->MakeEffectContext());
+				if (SpecHandle.IsValid())
+				{
+					SpecHandle.Data->SetSetByCallerMagnitude(LyraGameplayTags::SetByCaller_Damage, 1.0f);
+					Source->ApplyGameplayEffectSpecToTarget(*SpecHandle.Data.Get(), Target);
+				}
+			}
+		};
+
+		const bool bPreviousCacheTeamChecks = LyraConsoleVariables::bCacheDamageTeamChecks;
+
+		LyraConsoleVariables::bCacheDamageTeamChecks = false;
+		const double UncachedStartTime = FPlatformTime::Seconds();
+		RunHits();
+		const double UncachedSeconds = FPlatformTime::Seconds() - UncachedStartTime;
+
+		// Start the timed pass from an empty cache, as at the start of a frame
+		TeamCheckCache.FrameNumber = MAX_uint64;
+
+		LyraConsoleVariables::bCacheDamageTeamChecks = true;
+		const double CachedStartTime = FPlatformTime::Seconds();
+		RunHits();
+		const double CachedSeconds = FPlatformTime::Seconds() - CachedStartTime;
+
+		// The benchmark runs within a single frame, don't leave its results behind
+		TeamCheckCache.FrameNumber = MAX_uint64;
+		TeamCheckCache.CanCauseDamage.Reset();
+		LyraConsoleVariables::bCacheDamageTeamChecks = bPreviousCacheTeamChecks;
+
+		for (UAbilitySystemComponent* AbilitySystem : GodModeAdded)
+		{
+			AbilitySystem->RemoveLooseGameplayTag(LyraGameplayTags::Cheat_GodMode);
+		}
+
+		UE_LOG(LogLyraAbilitySystem, Log, TEXT("Damage benchmark: %d applications of %s between %d pawns, %d hits per target"), NumHits, *GetNameSafe(DamageGE.Get()), AbilitySystems.Num(), HitsPerTarget);
+		UE_LOG(LogLyraAbilitySystem, Log, TEXT("  Uncached: %.3f ms (%.1f ns per application)"), UncachedSeconds * 1000.0, UncachedSeconds * 1000000000.0 / NumHits);
+		UE_LOG(LogLyraAbilitySystem, Log, TEXT("  Cached:   %.3f ms (%.1f ns per application)"), CachedSeconds * 1000.0, CachedSeconds * 1000000000.0 / NumHits);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("lyra.Damage.Benchmark"),
+		TEXT("Applies the damage effect in shotgun-like bursts between the pawns in the world, with and without the per-frame team check cache. Usage: lyra.Damage.Benchmark [NumHits]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunBenchmark));
+}
+#endif // !UE_BUILD_SHIPPING
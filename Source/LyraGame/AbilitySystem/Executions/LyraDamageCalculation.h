@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayEffectExecutionCalculation.h"
+
+#define UE_API LYRAGAME_API
+
+class AActor;
+class UObject;
+class UWorld;
+
+/** Which parts of the damage calculation an execution uses */
+struct FLyraDamageCalculationOptions
+{
+	// Scale damage by the ability source's distance attenuation
+	bool bApplyDistanceAttenuation = true;
+
+	// Scale damage by the ability source's physical material attenuation
+	bool bApplyPhysicalMaterialAttenuation = true;
+
+	// Allow the damage when the world has no team subsystem
+	bool bAllowDamageWithoutTeamSubsystem = false;
+};
+
+/** Intermediate values of a damage calculation */
+struct FLyraDamageCalculationResult
+{
+	AActor* HitActor = nullptr;
+	float BaseDamage = 0.0f;
+	double Distance = WORLD_MAX;
+	float DistanceAttenuation = 1.0f;
+	float PhysicalMaterialAttenuation = 1.0f;
+	float DamageInteractionAllowedMultiplier = 0.0f;
+	float DamageDone = 0.0f;
+};
+
+/**
+ * FLyraDamageCalculation
+ *
+ *	Native damage pipeline shared by ULyraDamageExecution and the game feature damage executions.
+ *	Team checks are resolved once per instigator/target pair per frame, so every other pellet or swing hitting
+ *	the same target that frame skips the team lookups.
+ */
+struct FLyraDamageCalculation
+{
+	// Capture of the source's base damage, to add to RelevantAttributesToCapture
+	static UE_API const FGameplayEffectAttributeCaptureDefinition& GetBaseDamageCaptureDef();
+
+	// Computes the damage of an execution and adds it to the output as a Damage modifier. Returns the damage done.
+	static UE_API float Execute(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput, const FLyraDamageCalculationOptions& Options, FLyraDamageCalculationResult* OutResult = nullptr);
+
+	// Returns ULyraTeamSubsystem::CanCauseDamage for the pair, reusing the answer for the rest of the frame
+	static UE_API bool CanCauseDamageCached(const UWorld* World, const UObject* Instigator, const UObject* Target, bool bAllowDamageWithoutTeamSubsystem = false);
+};
+
+#undef UE_API
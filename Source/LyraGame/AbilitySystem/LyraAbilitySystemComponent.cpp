@@ -7,6 +7,8 @@
 #include "Animation/LyraAnimInstance.h"
 #include "Engine/World.h"
 #include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Optional.h"
 #include "LyraGlobalAbilitySystem.h"
 #include "LyraLogChannels.h"
 #include "System/LyraAssetManager.h"
@@ -16,6 +18,16 @@
 
 UE_DEFINE_GAMEPLAY_TAG(TAG_Gameplay_AbilityInputBlocked, "Gameplay.AbilityInputBlocked");
 
+namespace LyraConsoleVariables
+{
+	static bool bBatchAbilityRPCs = true;
+	static FAutoConsoleVariableRef CVarBatchAbilityRPCs(
+		TEXT("lyra.AbilitySystem.BatchAbilityRPCs"),
+		bBatchAbilityRPCs,
+		TEXT("Should the activate, target data and end RPCs of abilities activated from input be sent to the server as a single RPC?"),
+		ECVF_Default);
+}
+
 ULyraAbilitySystemComponent::ULyraAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -221,10 +233,22 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 		return;
 	}
 
-	static TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
+	// Take the scratch storage, so a reentrant call (from an ability activating) gets its own
+	TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate = MoveTemp(AbilitiesToActivateScratch);
+	TBitArray<> AbilitiesToActivateMask = MoveTemp(AbilitiesToActivateMaskScratch);
 	AbilitiesToActivate.Reset();
+	AbilitiesToActivateMask.Init(false, ActivatableAbilities.Items.Num());
 
-	//@TODO: See if we can use FScopedServerAbilityRPCBatcher ScopedRPCBatcher in some of these loops
+	// Deduplicates the abilities to activate by their index in ActivatableAbilities
+	auto AddAbilityToActivate = [this, &AbilitiesToActivate, &AbilitiesToActivateMask](const FGameplayAbilitySpec& AbilitySpec)
+	{
+		const int32 SpecIndex = UE_PTRDIFF_TO_INT32(&AbilitySpec - ActivatableAbilities.Items.GetData());
+		if (!AbilitiesToActivateMask[SpecIndex])
+		{
+			AbilitiesToActivateMask[SpecIndex] = true;
+			AbilitiesToActivate.Add(AbilitySpec.Handle);
+		}
+	};
 
 	//
 	// Process all abilities that activate when the input is held.
@@ -238,7 +262,7 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 				const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec->Ability);
 				if (LyraAbilityCDO && LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::WhileInputActive)
 				{
-					AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
+					AddAbilityToActivate(*AbilitySpec);
 				}
 			}
 		}
@@ -266,7 +290,7 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 
 					if (LyraAbilityCDO && LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::OnInputTriggered)
 					{
-						AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
+						AddAbilityToActivate(*AbilitySpec);
 					}
 				}
 			}
@@ -278,8 +302,17 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	// We do it all at once so that held inputs don't activate the ability
 	// and then also send a input event to the ability because of the press.
 	//
+	// When batching is enabled (see ShouldDoServerAbilityRPCBatch), predicting clients send the activate,
+	// target data and end RPCs a locally predicted ability makes within its batcher scope to the server as a single RPC.
+	//
 	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : AbilitiesToActivate)
 	{
+		TOptional<FScopedServerAbilityRPCBatcher> RPCBatcher;
+		if (ShouldBatchAbilityActivation(AbilitySpecHandle))
+		{
+			RPCBatcher.Emplace(this, AbilitySpecHandle);
+		}
+
 		TryActivateAbility(AbilitySpecHandle);
 	}
 
@@ -308,6 +341,28 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	InputPressedSpecHandles.Reset();
 	InputReleasedSpecHandles.Reset();
+
+	// Hand the scratch storage back for the next frame
+	AbilitiesToActivateScratch = MoveTemp(AbilitiesToActivate);
+	AbilitiesToActivateMaskScratch = MoveTemp(AbilitiesToActivateMask);
+}
+
+bool ULyraAbilitySystemComponent::ShouldDoServerAbilityRPCBatch() const
+{
+	// Only predicting clients send ability RPCs to the server
+	return LyraConsoleVariables::bBatchAbilityRPCs && !IsOwnerActorAuthoritative();
+}
+
+bool ULyraAbilitySystemComponent::ShouldBatchAbilityActivation(const FGameplayAbilitySpecHandle& AbilitySpecHandle) const
+{
+	if (!ShouldDoServerAbilityRPCBatch())
+	{
+		return false;
+	}
+
+	// Abilities that don't predict never call the server from here, so a batch would go out empty
+	const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(AbilitySpecHandle);
+	return AbilitySpec && AbilitySpec->Ability && (AbilitySpec->Ability->GetNetExecutionPolicy() == EGameplayAbilityNetExecutionPolicy::LocalPredicted);
 }
 
 void ULyraAbilitySystemComponent::ClearAbilityInput()
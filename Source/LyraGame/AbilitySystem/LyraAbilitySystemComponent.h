@@ -38,6 +38,7 @@ public:
 	//~End of UActorComponent interface
 
 	UE_API virtual void InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor) override;
+	UE_API virtual bool ShouldDoServerAbilityRPCBatch() const override;
 
 	typedef TFunctionRef<bool(const ULyraGameplayAbility* LyraAbility, FGameplayAbilitySpecHandle Handle)> TShouldCancelAbilityFunc;
 	UE_API void CancelAbilitiesByFunc(TShouldCancelAbilityFunc ShouldCancelFunc, bool bReplicateCancelAbility);
@@ -90,6 +91,9 @@ protected:
 	UE_API void HandleAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason);
 protected:
 
+	// Returns true if activating this ability from input should open a server ability RPC batch
+	UE_API bool ShouldBatchAbilityActivation(const FGameplayAbilitySpecHandle& AbilitySpecHandle) const;
+
 	// If set, this table is used to look up tag relationships for activate and cancel
 	UPROPERTY()
 	TObjectPtr<ULyraAbilityTagRelationshipMapping> TagRelationshipMapping;
@@ -103,6 +107,10 @@ protected:
 	// Handles to abilities that have their input held.
 	TArray<FGameplayAbilitySpecHandle> InputHeldSpecHandles;
 
+	// Storage reused by ProcessAbilityInput, for the abilities to activate and their indices in ActivatableAbilities
+	TArray<FGameplayAbilitySpecHandle> AbilitiesToActivateScratch;
+	TBitArray<> AbilitiesToActivateMaskScratch;
+
 	// Number of abilities running in each activation group.
 	int32 ActivationGroupCounts[(uint8)ELyraAbilityActivationGroup::MAX];
 };
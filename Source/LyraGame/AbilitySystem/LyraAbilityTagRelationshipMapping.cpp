@@ -2,62 +2,247 @@
 
 #include "AbilitySystem/LyraAbilityTagRelationshipMapping.h"
 
+#include "GameplayTagsManager.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "UObject/Package.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraAbilityTagRelationshipMapping)
 
-void ULyraAbilityTagRelationshipMapping::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+namespace LyraAbilityTagRelationships
+{
+	// The cache only grows with the number of distinct ability tag containers, this is a safety net
+	static constexpr int32 MaxCachedContainers = 1024;
+}
+
+void ULyraAbilityTagRelationshipMapping::FCompiledRelationship::Append(const FCompiledRelationship& Other)
+{
+	AbilityTagsToBlock.AppendTags(Other.AbilityTagsToBlock);
+	AbilityTagsToCancel.AppendTags(Other.AbilityTagsToCancel);
+	ActivationRequiredTags.AppendTags(Other.ActivationRequiredTags);
+	ActivationBlockedTags.AppendTags(Other.ActivationBlockedTags);
+}
+
+void ULyraAbilityTagRelationshipMapping::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileRelationships();
+}
+
+#if WITH_EDITOR
+void ULyraAbilityTagRelationshipMapping::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Recompiled on the next query
+	bIsCompiled = false;
+}
+#endif
+
+void ULyraAbilityTagRelationshipMapping::CompileRelationships() const
+{
+	CompiledRelationships.Reset();
+	CompiledContainerCache.Reset();
+
+	for (const FLyraAbilityTagRelationship& Relationship : AbilityTagRelationships)
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		if (!Relationship.AbilityTag.IsValid())
 		{
-			if (OutTagsToBlock)
-			{
-				OutTagsToBlock->AppendTags(Tags.AbilityTagsToBlock);
-			}
-			if (OutTagsToCancel)
-			{
-				OutTagsToCancel->AppendTags(Tags.AbilityTagsToCancel);
-			}
+			continue;
 		}
+
+		// Several entries can be about the same tag
+		FCompiledRelationship& Compiled = CompiledRelationships.FindOrAdd(Relationship.AbilityTag);
+		Compiled.AbilityTagsToBlock.AppendTags(Relationship.AbilityTagsToBlock);
+		Compiled.AbilityTagsToCancel.AppendTags(Relationship.AbilityTagsToCancel);
+		Compiled.ActivationRequiredTags.AppendTags(Relationship.ActivationRequiredTags);
+		Compiled.ActivationBlockedTags.AppendTags(Relationship.ActivationBlockedTags);
 	}
+
+	bIsCompiled = true;
 }
 
-void ULyraAbilityTagRelationshipMapping::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+const ULyraAbilityTagRelationshipMapping::FCompiledRelationship& ULyraAbilityTagRelationshipMapping::FindRelationshipsForAbilityTags(const FGameplayTagContainer& AbilityTags) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	if (!bIsCompiled)
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		CompileRelationships();
+	}
+
+	if (const FCompiledRelationship* CachedResult = CompiledContainerCache.Find(AbilityTags))
+	{
+		return *CachedResult;
+	}
+
+	if (CompiledContainerCache.Num() >= LyraAbilityTagRelationships::MaxCachedContainers)
+	{
+		CompiledContainerCache.Reset();
+	}
+
+	// A relationship applies when the ability has its tag or a child of it (matching FGameplayTagContainer::HasTag)
+	FCompiledRelationship Result;
+	for (const FGameplayTag& AbilityTag : AbilityTags)
+	{
+		for (FGameplayTag Tag = AbilityTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
 		{
-			if (OutActivationRequired)
-			{
-				OutActivationRequired->AppendTags(Tags.ActivationRequiredTags);
-			}
-			if (OutActivationBlocked)
+			if (const FCompiledRelationship* Compiled = CompiledRelationships.Find(Tag))
 			{
-				OutActivationBlocked->AppendTags(Tags.ActivationBlockedTags);
+				Result.Append(*Compiled);
 			}
 		}
 	}
+
+	return CompiledContainerCache.Add(AbilityTags, MoveTemp(Result));
+}
+
+void ULyraAbilityTagRelationshipMapping::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+{
+	const FCompiledRelationship& Relationships = FindRelationshipsForAbilityTags(AbilityTags);
+	if (OutTagsToBlock)
+	{
+		OutTagsToBlock->AppendTags(Relationships.AbilityTagsToBlock);
+	}
+	if (OutTagsToCancel)
+	{
+		OutTagsToCancel->AppendTags(Relationships.AbilityTagsToCancel);
+	}
+}
+
+void ULyraAbilityTagRelationshipMapping::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+{
+	const FCompiledRelationship& Relationships = FindRelationshipsForAbilityTags(AbilityTags);
+	if (OutActivationRequired)
+	{
+		OutActivationRequired->AppendTags(Relationships.ActivationRequiredTags);
+	}
+	if (OutActivationBlocked)
+	{
+		OutActivationBlocked->AppendTags(Relationships.ActivationBlockedTags);
+	}
 }
 
 bool ULyraAbilityTagRelationshipMapping::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	if (!bIsCompiled)
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
+		CompileRelationships();
+	}
+
+	// Only relationships about exactly ActionTag apply here
+	const FCompiledRelationship* Compiled = CompiledRelationships.Find(ActionTag);
+	return (Compiled != nullptr) && Compiled->AbilityTagsToCancel.HasAny(AbilityTags);
+}
 
-		if (Tags.AbilityTag == ActionTag && Tags.AbilityTagsToCancel.HasAny(AbilityTags))
+//////////////////////////////////////////////////////////////////////
+
+#if !UE_BUILD_SHIPPING
+struct FLyraAbilityTagRelationshipMappingBenchmark
+{
+	// The original implementation, scanning every relationship
+	static void GetAllTagsUncompiled(const ULyraAbilityTagRelationshipMapping& Mapping, const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutBlock, FGameplayTagContainer& OutCancel, FGameplayTagContainer& OutRequired, FGameplayTagContainer& OutBlocked)
+	{
+		for (const FLyraAbilityTagRelationship& Tags : Mapping.AbilityTagRelationships)
 		{
-			return true;
+			if (AbilityTags.HasTag(Tags.AbilityTag))
+			{
+				OutBlock.AppendTags(Tags.AbilityTagsToBlock);
+				OutCancel.AppendTags(Tags.AbilityTagsToCancel);
+				OutRequired.AppendTags(Tags.ActivationRequiredTags);
+				OutBlocked.AppendTags(Tags.ActivationBlockedTags);
+			}
 		}
 	}
 
-	return false;
-}
+	static void Run(const TArray<FString>& Args)
+	{
+		const int32 NumQueries = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+		const int32 NumRelationships = 200;
+		const int32 NumAbilities = 50;
+
+		FGameplayTagContainer AllTagsContainer;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(/*out*/ AllTagsContainer, /*OnlyIncludeDictionaryTags=*/ true);
+		TArray<FGameplayTag> AllTags;
+		AllTagsContainer.GetGameplayTagArray(/*out*/ AllTags);
+		if (AllTags.Num() == 0)
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Tag relationship benchmark: no gameplay tags registered"));
+			return;
+		}
+
+		FRandomStream Random(0x1234);
+		auto RandomTags = [&Random, &AllTags](int32 NumTags)
+		{
+			FGameplayTagContainer Result;
+			for (int32 Index = 0; Index < NumTags; ++Index)
+			{
+				Result.AddTag(AllTags[Random.RandHelper(AllTags.Num())]);
+			}
+			return Result;
+		};
+
+		ULyraAbilityTagRelationshipMapping* Mapping = NewObject<ULyraAbilityTagRelationshipMapping>(GetTransientPackage());
+		for (int32 Index = 0; Index < NumRelationships; ++Index)
+		{
+			FLyraAbilityTagRelationship& Relationship = Mapping->AbilityTagRelationships.AddDefaulted_GetRef();
+			Relationship.AbilityTag = AllTags[Random.RandHelper(AllTags.Num())];
+			Relationship.AbilityTagsToBlock = RandomTags(3);
+			Relationship.AbilityTagsToCancel = RandomTags(2);
+			Relationship.ActivationRequiredTags = RandomTags(1);
+			Relationship.ActivationBlockedTags = RandomTags(2);
+		}
+
+		TArray<FGameplayTagContainer> AbilityTagContainers;
+		for (int32 Index = 0; Index < NumAbilities; ++Index)
+		{
+			AbilityTagContainers.Add(RandomTags(1 + Random.RandHelper(3)));
+		}
+
+		// Make sure both paths agree before timing them
+		int32 NumMismatches = 0;
+		for (const FGameplayTagContainer& AbilityTags : AbilityTagContainers)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			GetAllTagsUncompiled(*Mapping, AbilityTags, Block, Cancel, Required, Blocked);
+
+			FGameplayTagContainer CompiledBlock, CompiledCancel, CompiledRequired, CompiledBlocked;
+			Mapping->GetAbilityTagsToBlockAndCancel(AbilityTags, &CompiledBlock, &CompiledCancel);
+			Mapping->GetRequiredAndBlockedActivationTags(AbilityTags, &CompiledRequired, &CompiledBlocked);
+
+			if ((Block != CompiledBlock) || (Cancel != CompiledCancel) || (Required != CompiledRequired) || (Blocked != CompiledBlocked))
+			{
+				++NumMismatches;
+			}
+		}
+
+		const double UncompiledStartTime = FPlatformTime::Seconds();
+		for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			GetAllTagsUncompiled(*Mapping, AbilityTagContainers[QueryIndex % NumAbilities], Block, Cancel, Required, Blocked);
+		}
+		const double UncompiledSeconds = FPlatformTime::Seconds() - UncompiledStartTime;
+
+		const double CompiledStartTime = FPlatformTime::Seconds();
+		for (int32 QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			const FGameplayTagContainer& AbilityTags = AbilityTagContainers[QueryIndex % NumAbilities];
+			Mapping->GetAbilityTagsToBlockAndCancel(AbilityTags, &Block, &Cancel);
+			Mapping->GetRequiredAndBlockedActivationTags(AbilityTags, &Required, &Blocked);
+		}
+		const double CompiledSeconds = FPlatformTime::Seconds() - CompiledStartTime;
+
+		UE_LOG(LogLyra, Log, TEXT("Tag relationship benchmark: %d relationships, %d ability tag containers, %d queries (%d mismatches)"), NumRelationships, NumAbilities, NumQueries, NumMismatches);
+		UE_LOG(LogLyra, Log, TEXT("  Scan: %.3f ms (%.1f ns per query)"), UncompiledSeconds * 1000.0, UncompiledSeconds * 1000000000.0 / NumQueries);
+		UE_LOG(LogLyra, Log, TEXT("  Compiled: %.3f ms (%.1f ns per query)"), CompiledSeconds * 1000.0, CompiledSeconds * 1000000000.0 / NumQueries);
+
+		Mapping->MarkAsGarbage();
+	}
+};
 
+static FAutoConsoleCommand CVarBenchmarkTagRelationships(
+	TEXT("lyra.AbilitySystem.TagRelationships.Benchmark"),
+	TEXT("Compares the compiled tag relationship lookups with a scan of a synthetic 200 entry mapping. Usage: lyra.AbilitySystem.TagRelationships.Benchmark [NumQueries]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FLyraAbilityTagRelationshipMappingBenchmark::Run));
+#endif // !UE_BUILD_SHIPPING
@@ -37,6 +37,21 @@ struct FLyraAbilityTagRelationship
 };
 
 
+/** Hashes tag containers regardless of the order of their tags, matching FGameplayTagContainer::operator== */
+template <typename ValueType>
+struct TLyraGameplayTagContainerMapKeyFuncs : TDefaultMapHashableKeyFuncs<FGameplayTagContainer, ValueType, false>
+{
+	static uint32 GetKeyHash(const FGameplayTagContainer& Key)
+	{
+		uint32 Hash = 0;
+		for (const FGameplayTag& Tag : Key)
+		{
+			Hash += GetTypeHash(Tag);
+		}
+		return Hash;
+	}
+};
+
 /** Mapping of how ability tags block or cancel other abilities */
 UCLASS()
 class ULyraAbilityTagRelationshipMapping : public UDataAsset
@@ -49,6 +64,13 @@ private:
 	TArray<FLyraAbilityTagRelationship> AbilityTagRelationships;
 
 public:
+	//~UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~End of UObject interface
+
 	/** Given a set of ability tags, parse the tag relationship and fill out tags to block and cancel */
 	void GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const;
 
@@ -57,4 +79,32 @@ public:
 
 	/** Returns true if the specified ability tags are canceled by the passed in action tag */
 	bool IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const;
+
+private:
+	// All of the relationships that apply to an ability tag (or set of ability tags), merged together
+	struct FCompiledRelationship
+	{
+		FGameplayTagContainer AbilityTagsToBlock;
+		FGameplayTagContainer AbilityTagsToCancel;
+		FGameplayTagContainer ActivationRequiredTags;
+		FGameplayTagContainer ActivationBlockedTags;
+
+		void Append(const FCompiledRelationship& Other);
+	};
+
+	// Builds CompiledRelationships from AbilityTagRelationships
+	void CompileRelationships() const;
+
+	// Returns the merged relationships of every tag (and parent tag) in AbilityTags, the reference is only valid until the next query
+	const FCompiledRelationship& FindRelationshipsForAbilityTags(const FGameplayTagContainer& AbilityTags) const;
+
+	// Merged relationships of each ability tag
+	mutable TMap<FGameplayTag, FCompiledRelationship> CompiledRelationships;
+
+	// Results for each container of ability tags queried so far (there is usually one per ability class)
+	mutable TMap<FGameplayTagContainer, FCompiledRelationship, FDefaultSetAllocator, TLyraGameplayTagContainerMapKeyFuncs<FCompiledRelationship>> CompiledContainerCache;
+
+	mutable bool bIsCompiled = false;
+
+	friend struct FLyraAbilityTagRelationshipMappingBenchmark;
 };
@@ -0,0 +1,245 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraGameplayAbilityTargetData_CompressedCartridge.h"
+
+#include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Actor.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayAbilityTargetData_CompressedCartridge)
+
+//////////////////////////////////////////////////////////////////////
+
+namespace LyraCompressedCartridge
+{
+	// Bits of the per-hit flags
+	enum EHitFlags : uint8
+	{
+		BlockingHit = 1 << 0,
+		HasActor = 1 << 1,
+		HasComponent = 1 << 2,
+		HasPhysMaterial = 1 << 3,
+	};
+	static constexpr uint32 NumHitFlagBits = 4;
+
+	// Impact offsets are sent with 0.1 cm precision
+	static constexpr uint32 OffsetScaleFactor = 10;
+	static constexpr int32 OffsetMaxBitsPerComponent = 24;
+
+	template<typename ObjectType>
+	void SerializeWeakObject(FArchive& Ar, TWeakObjectPtr<ObjectType>& WeakObject)
+	{
+		UObject* Object = WeakObject.Get();
+		Ar << Object;
+		if (Ar.IsLoading())
+		{
+			WeakObject = Cast<ObjectType>(Object);
+		}
+	}
+}
+
+bool FLyraGameplayAbilityTargetData_CompressedCartridge::CompressHandle(const FGameplayAbilityTargetDataHandle& InHandle, FGameplayAbilityTargetDataHandle& OutHandle)
+{
+	if ((InHandle.Num() == 0) || (InHandle.Num() > MAX_uint8))
+	{
+		return false;
+	}
+
+	FLyraGameplayAbilityTargetData_CompressedCartridge* Cartridge = nullptr;
+	for (int32 Index = 0; Index < InHandle.Num(); ++Index)
+	{
+		const FGameplayAbilityTargetData* Data = InHandle.Get(Index);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct()))
+		{
+			delete Cartridge;
+			return false;
+		}
+
+		const FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<const FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data);
+		const FHitResult& HitResult = SingleTargetHit->HitResult;
+
+		if (Cartridge == nullptr)
+		{
+			Cartridge = new FLyraGameplayAbilityTargetData_CompressedCartridge();
+			Cartridge->TraceStart = HitResult.TraceStart;
+			Cartridge->CartridgeID = SingleTargetHit->CartridgeID;
+			Cartridge->FireTimestamp = SingleTargetHit->FireTimestamp;
+		}
+		else if ((Cartridge->CartridgeID != SingleTargetHit->CartridgeID) || !Cartridge->TraceStart.Equals(HitResult.TraceStart))
+		{
+			// Only bullets from the same cartridge can share their trace data
+			delete Cartridge;
+			return false;
+		}
+
+		FLyraCompressedCartridgeHit& Hit = Cartridge->Hits.AddDefaulted_GetRef();
+		Hit.ImpactPoint = HitResult.ImpactPoint;
+		Hit.ImpactNormal = HitResult.ImpactNormal;
+		Hit.Actor = HitResult.HitObjectHandle.FetchActor();
+		Hit.Component = HitResult.Component;
+		Hit.PhysMaterial = HitResult.PhysMaterial;
+		Hit.bBlockingHit = HitResult.bBlockingHit;
+	}
+
+	OutHandle.Clear();
+	OutHandle.Add(Cartridge);
+	OutHandle.UniqueId = InHandle.UniqueId;
+	return true;
+}
+
+bool FLyraGameplayAbilityTargetData_CompressedCartridge::ExpandHandle(FGameplayAbilityTargetDataHandle& InOutHandle)
+{
+	const FGameplayAbilityTargetData* Data = (InOutHandle.Num() == 1) ? InOutHandle.Get(0) : nullptr;
+	if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_CompressedCartridge::StaticStruct()))
+	{
+		return false;
+	}
+
+	// Keep the cartridge alive while the handle is rebuilt
+	const TSharedPtr<FGameplayAbilityTargetData> CartridgeData = InOutHandle.Data[0];
+	const FLyraGameplayAbilityTargetData_CompressedCartridge* Cartridge = static_cast<const FLyraGameplayAbilityTargetData_CompressedCartridge*>(CartridgeData.Get());
+
+	InOutHandle.Data.Reset(Cartridge->Hits.Num());
+	for (const FLyraCompressedCartridgeHit& Hit : Cartridge->Hits)
+	{
+		FLyraGameplayAbilityTargetData_SingleTargetHit* NewTargetData = new FLyraGameplayAbilityTargetData_SingleTargetHit();
+		NewTargetData->CartridgeID = Cartridge->CartridgeID;
+		NewTargetData->FireTimestamp = Cartridge->FireTimestamp;
+
+		FHitResult& HitResult = NewTargetData->HitResult;
+		HitResult.TraceStart = Cartridge->TraceStart;
+		HitResult.TraceEnd = Hit.ImpactPoint;
+		HitResult.Location = Hit.ImpactPoint;
+		HitResult.ImpactPoint = Hit.ImpactPoint;
+		HitResult.Normal = Hit.ImpactNormal;
+		HitResult.ImpactNormal = Hit.ImpactNormal;
+		HitResult.Distance = FVector::Dist(Cartridge->TraceStart, Hit.ImpactPoint);
+		HitResult.bBlockingHit = Hit.bBlockingHit;
+		HitResult.HitObjectHandle = FActorInstanceHandle(Hit.Actor.Get());
+		HitResult.Component = Hit.Component;
+		HitResult.PhysMaterial = Hit.PhysMaterial;
+
+		InOutHandle.Add(NewTargetData);
+	}
+
+	return true;
+}
+
+uint16 FLyraGameplayAbilityTargetData_CompressedCartridge::PackUnitVector(const FVector& Vector)
+{
+	FVector3f Unit = FVector3f(Vector.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector));
+
+	// Project onto the octahedron, then fold the lower half over the upper one
+	Unit /= FMath::Abs(Unit.X) + FMath::Abs(Unit.Y) + FMath::Abs(Unit.Z);
+	FVector2f Octahedral(Unit.X, Unit.Y);
+	if (Unit.Z < 0.0f)
+	{
+		Octahedral = FVector2f(
+			(1.0f - FMath::Abs(Unit.Y)) * ((Unit.X >= 0.0f) ? 1.0f : -1.0f),
+			(1.0f - FMath::Abs(Unit.X)) * ((Unit.Y >= 0.0f) ? 1.0f : -1.0f));
+	}
+
+	const uint16 PackedX = (uint16)FMath::Clamp(FMath::RoundToInt((Octahedral.X * 0.5f + 0.5f) * 255.0f), 0, 255);
+	const uint16 PackedY = (uint16)FMath::Clamp(FMath::RoundToInt((Octahedral.Y * 0.5f + 0.5f) * 255.0f), 0, 255);
+	return (PackedX << 8) | PackedY;
+}
+
+FVector FLyraGameplayAbilityTargetData_CompressedCartridge::UnpackUnitVector(uint16 PackedVector)
+{
+	const float OctahedralX = ((PackedVector >> 8) & 0xFF) / 255.0f * 2.0f - 1.0f;
+	const float OctahedralY = (PackedVector & 0xFF) / 255.0f * 2.0f - 1.0f;
+
+	FVector3f Unit(OctahedralX, OctahedralY, 1.0f - FMath::Abs(OctahedralX) - FMath::Abs(OctahedralY));
+	const float Fold = FMath::Max(-Unit.Z, 0.0f);
+	Unit.X += (Unit.X >= 0.0f) ? -Fold : Fold;
+	Unit.Y += (Unit.Y >= 0.0f) ? -Fold : Fold;
+
+	return FVector(Unit.GetSafeNormal());
+}
+
+TArray<TWeakObjectPtr<AActor>> FLyraGameplayAbilityTargetData_CompressedCartridge::GetActors() const
+{
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	for (const FLyraCompressedCartridgeHit& Hit : Hits)
+	{
+		if (Hit.Actor.IsValid())
+		{
+			Actors.AddUnique(Hit.Actor);
+		}
+	}
+	return Actors;
+}
+
+bool FLyraGameplayAbilityTargetData_CompressedCartridge::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace LyraCompressedCartridge;
+
+	bOutSuccess = SerializePackedVector<OffsetScaleFactor, OffsetMaxBitsPerComponent>(TraceStart, Ar);
+
+	uint32 PackedCartridgeID = (uint32)CartridgeID;
+	Ar.SerializeIntPacked(PackedCartridgeID);
+	CartridgeID = (int32)PackedCartridgeID;
+
+	FLyraGameplayAbilityTargetData_SingleTargetHit::NetSerializeServerTimestamp(Ar, Map, FireTimestamp);
+
+	uint8 NumHits = (uint8)FMath::Min(Hits.Num(), (int32)MAX_uint8);
+	Ar << NumHits;
+	if (Ar.IsLoading())
+	{
+		Hits.SetNum(NumHits);
+	}
+
+	for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+	{
+		FLyraCompressedCartridgeHit& Hit = Hits[HitIndex];
+
+		uint8 Flags = 0;
+		if (Ar.IsSaving())
+		{
+			Flags |= Hit.bBlockingHit ? BlockingHit : 0;
+			Flags |= Hit.Actor.IsValid() ? HasActor : 0;
+			Flags |= Hit.Component.IsValid() ? HasComponent : 0;
+			Flags |= Hit.PhysMaterial.IsValid() ? HasPhysMaterial : 0;
+		}
+		Ar.SerializeBits(&Flags, NumHitFlagBits);
+
+		// Offsets from the trace start need far fewer bits than world positions
+		FVector Offset = Hit.ImpactPoint - TraceStart;
+		bOutSuccess &= SerializePackedVector<OffsetScaleFactor, OffsetMaxBitsPerComponent>(Offset, Ar);
+
+		// Only blocking hits have a meaningful normal
+		uint16 PackedNormal = 0;
+		if (Flags & BlockingHit)
+		{
+			if (Ar.IsSaving())
+			{
+				PackedNormal = PackUnitVector(Hit.ImpactNormal);
+			}
+			Ar << PackedNormal;
+		}
+
+		if (Flags & HasActor)
+		{
+			SerializeWeakObject(Ar, Hit.Actor);
+		}
+		if (Flags & HasComponent)
+		{
+			SerializeWeakObject(Ar, Hit.Component);
+		}
+		if (Flags & HasPhysMaterial)
+		{
+			SerializeWeakObject(Ar, Hit.PhysMaterial);
+		}
+
+		if (Ar.IsLoading())
+		{
+			Hit.bBlockingHit = (Flags & BlockingHit) != 0;
+			Hit.ImpactPoint = TraceStart + Offset;
+			Hit.ImpactNormal = (Flags & BlockingHit) ? UnpackUnitVector(PackedNormal) : FVector::ZeroVector;
+		}
+	}
+
+	return true;
+}
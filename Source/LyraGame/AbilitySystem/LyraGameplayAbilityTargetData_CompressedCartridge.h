@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Abilities/GameplayAbilityTargetTypes.h"
+
+#include "LyraGameplayAbilityTargetData_CompressedCartridge.generated.h"
+
+#define UE_API LYRAGAME_API
+
+class AActor;
+class FArchive;
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+
+/** A single impact within a compressed cartridge */
+USTRUCT()
+struct FLyraCompressedCartridgeHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector ImpactNormal = FVector::ZeroVector;
+
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Actor;
+
+	UPROPERTY()
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	UPROPERTY()
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+
+	UPROPERTY()
+	bool bBlockingHit = false;
+};
+
+/**
+ * All of the hits of one ranged weapon cartridge, packed for sending to the server.
+ *
+ * The trace start, cartridge ID and fire time are shared by every pellet and sent once.
+ * Impact points are quantized relative to the trace start and normals are packed into 16 bits.
+ * The server expands this back into FLyraGameplayAbilityTargetData_SingleTargetHit entries
+ * (one per hit, in the original order) before any game code looks at it.
+ */
+USTRUCT()
+struct UE_API FLyraGameplayAbilityTargetData_CompressedCartridge : public FGameplayAbilityTargetData
+{
+	GENERATED_BODY()
+
+	/**
+	 * Packs a handle made of FLyraGameplayAbilityTargetData_SingleTargetHit entries from a single cartridge.
+	 * Returns false (leaving OutHandle untouched) if the handle contains anything else.
+	 */
+	static bool CompressHandle(const FGameplayAbilityTargetDataHandle& InHandle, FGameplayAbilityTargetDataHandle& OutHandle);
+
+	/** Replaces a compressed cartridge in the handle with one single target hit per impact. Returns true if anything was expanded. */
+	static bool ExpandHandle(FGameplayAbilityTargetDataHandle& InOutHandle);
+
+	/** Packs a unit vector into 16 bits using an octahedral mapping */
+	static uint16 PackUnitVector(const FVector& Vector);
+	static FVector UnpackUnitVector(uint16 PackedVector);
+
+	//~FGameplayAbilityTargetData interface
+	virtual TArray<TWeakObjectPtr<AActor>> GetActors() const override;
+	virtual UScriptStruct* GetScriptStruct() const override
+	{
+		return FLyraGameplayAbilityTargetData_CompressedCartridge::StaticStruct();
+	}
+	//~End of FGameplayAbilityTargetData interface
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	UPROPERTY()
+	FVector TraceStart = FVector::ZeroVector;
+
+	UPROPERTY()
+	int32 CartridgeID = -1;
+
+	UPROPERTY()
+	double FireTimestamp = 0.0;
+
+	UPROPERTY()
+	TArray<FLyraCompressedCartridgeHit> Hits;
+};
+
+template<>
+struct TStructOpsTypeTraits<FLyraGameplayAbilityTargetData_CompressedCartridge> : public TStructOpsTypeTraitsBase2<FLyraGameplayAbilityTargetData_CompressedCartridge>
+{
+	enum
+	{
+		WithNetSerializer = true	// For now this is REQUIRED for FGameplayAbilityTargetDataHandle net serialization to work
+	};
+};
+
+#undef UE_API
@@ -2,6 +2,10 @@
 
 #include "LyraGameplayAbilityTargetData_SingleTargetHit.h"
 
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "Engine/World.h"
+#include "GameModes/LyraGameState.h"
 #include "LyraGameplayEffectContext.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayAbilityTargetData_SingleTargetHit)
@@ -26,7 +30,41 @@ bool FLyraGameplayAbilityTargetData_SingleTargetHit::NetSerialize(FArchive& Ar,
 	FGameplayAbilityTargetData_SingleTargetHit::NetSerialize(Ar, Map, bOutSuccess);
 
 	Ar << CartridgeID;
+	NetSerializeServerTimestamp(Ar, Map, FireTimestamp);
 
 	return true;
 }
 
+void FLyraGameplayAbilityTargetData_SingleTargetHit::NetSerializeServerTimestamp(FArchive& Ar, class UPackageMap* Map, double& Timestamp)
+{
+	const ALyraGameState* GameState = nullptr;
+	if (UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map))
+	{
+		const UNetConnection* Connection = PackageMapClient->GetConnection();
+		const UWorld* World = (Connection != nullptr) ? Connection->GetWorld() : nullptr;
+		GameState = (World != nullptr) ? World->GetGameState<ALyraGameState>() : nullptr;
+	}
+
+	// MAX_uint8 means the time was not encoded against a base and is sent in full
+	uint8 BaseIndex = MAX_uint8;
+	float Offset = 0.0f;
+	if (Ar.IsSaving() && (GameState != nullptr))
+	{
+		GameState->EncodeServerTimestamp(Timestamp, /*out*/ BaseIndex, /*out*/ Offset);
+	}
+
+	Ar << BaseIndex;
+	if (BaseIndex == MAX_uint8)
+	{
+		Ar << Timestamp;
+	}
+	else
+	{
+		Ar << Offset;
+		if (Ar.IsLoading())
+		{
+			Timestamp = (GameState != nullptr) ? GameState->DecodeServerTimestamp(BaseIndex, Offset) : Offset;
+		}
+	}
+}
+
@@ -18,6 +18,7 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 
 	FLyraGameplayAbilityTargetData_SingleTargetHit()
 		: CartridgeID(-1)
+		, FireTimestamp(0.0)
 	{ }
 
 	virtual void AddTargetDataToContext(FGameplayEffectContextHandle& Context, bool bIncludeActorArray) const override;
@@ -26,8 +27,15 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 	UPROPERTY()
 	int32 CartridgeID;
 
+	/** Server world time (as seen by the firing client) when the shot was fired, used to rewind hitboxes for validation */
+	UPROPERTY()
+	double FireTimestamp;
+
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+	/** Serializes a server world time as a float offset from the game state's replicated timestamp base, or in full if there is no game state */
+	static void NetSerializeServerTimestamp(FArchive& Ar, class UPackageMap* Map, double& Timestamp);
+
 	virtual UScriptStruct* GetScriptStruct() const override
 	{
 		return FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct();
@@ -6,6 +6,7 @@
 #include "GameplayCueSet.h"
 #include "AbilitySystemGlobals.h"
 #include "GameplayTagsManager.h"
+#include "Abilities/GameplayAbility.h"
 #include "UObject/UObjectThreadContext.h"
 #include "Async/Async.h"
 
@@ -34,7 +35,22 @@ namespace LyraGameplayCueManagerCvars
 		TEXT("Shows all assets that were loaded via LyraGameplayCueManager and are currently in memory."),
 		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpGameplayCues));
 
+	static FAutoConsoleCommand CVarDumpGameplayCuePreloads(
+		TEXT("Lyra.DumpGameplayCuePreloads"),
+		TEXT("Shows the gameplay cue preload queue and cue miss telemetry. Pass Misses to list the missed cues."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpGameplayCuePreloads));
+
 	static ELyraEditorLoadMode LoadMode = ELyraEditorLoadMode::LoadUpfront;
+
+	static int32 MaxConcurrentPreloads = 8;
+	static FAutoConsoleVariableRef CVarMaxConcurrentPreloads(
+		TEXT("lyra.GameplayCue.Preload.MaxConcurrentLoads"),
+		MaxConcurrentPreloads,
+		TEXT("How many gameplay cue preloads can be streaming at once, the rest wait in a queue ordered by how likely the cue is to play soon. 0 means no limit."),
+		ECVF_Default);
+
+	// Misses within this many seconds of a map load are counted separately, they are the ones that hitch a match start
+	static constexpr double MapStartSeconds = 60.0;
 }
 
 const bool bPreloadEvenInEditor = true;
@@ -123,6 +139,55 @@ bool ULyraGameplayCueManager::ShouldAsyncLoadMissingGameplayCues() const
 	return true;
 }
 
+bool ULyraGameplayCueManager::HandleMissingGameplayCue(UGameplayCueSet* OwningSet, struct FGameplayCueNotifyData& CueData, AActor* TargetActor, EGameplayCueEvent::Type EventType, FGameplayCueParameters& Parameters)
+{
+	++CuePreloadStats.NumMisses;
+	++CueMissCounts.FindOrAdd(CueData.GameplayCueTag);
+
+	const double SecondsSinceMapLoad = FPlatformTime::Seconds() - LastMapLoadTime;
+	if (SecondsSinceMapLoad < LyraGameplayCueManagerCvars::MapStartSeconds)
+	{
+		++CuePreloadStats.NumMissesAfterMapLoad;
+	}
+
+	// A queued preload was too late, count it and start it next
+	for (TArray<FPendingCuePreload>& Queue : PendingCuePreloads)
+	{
+		const int32 QueueIndex = Queue.IndexOfByPredicate([&CueData](const FPendingCuePreload& Pending) { return Pending.Path == CueData.GameplayCueNotifyObj; });
+		if (QueueIndex != INDEX_NONE)
+		{
+			++CuePreloadStats.NumMissesWhileQueued;
+
+			// Queue may be the high priority queue itself, so take the entry out before inserting it
+			FPendingCuePreload Pending = MoveTemp(Queue[QueueIndex]);
+			Queue.RemoveAt(QueueIndex);
+			PendingCuePreloads[(int32)ECuePreloadPriority::High].Insert(MoveTemp(Pending), 0);
+			break;
+		}
+	}
+
+	UE_LOG(LogLyra, Verbose, TEXT("Gameplay cue %s was invoked before being loaded (%.1f s after map load)"), *CueData.GameplayCueTag.ToString(), SecondsSinceMapLoad);
+
+	const bool bResult = Super::HandleMissingGameplayCue(OwningSet, CueData, TargetActor, EventType, Parameters);
+
+	// The base class started an async load for the cue (and returned false, as the cue was not handled yet);
+	// watch the same path to time it until it arrives
+	if (ShouldAsyncLoadMissingGameplayCues() && !CueData.LoadedGameplayCueClass && !MissLoadStartTimes.Contains(CueData.GameplayCueNotifyObj))
+	{
+		MissLoadStartTimes.Add(CueData.GameplayCueNotifyObj, FPlatformTime::Seconds());
+		++CuePreloadStats.NumMissLoadsStarted;
+
+		const TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(CueData.GameplayCueNotifyObj, FStreamableDelegate::CreateUObject(this, &ThisClass::OnMissingCueLoadComplete, CueData.GameplayCueNotifyObj), FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("GameplayCueManager"));
+		if (!Handle.IsValid())
+		{
+			// Nothing to load, the delegate will not be called
+			OnMissingCueLoadComplete(CueData.GameplayCueNotifyObj);
+		}
+	}
+
+	return bResult;
+}
+
 void ULyraGameplayCueManager::DumpGameplayCues(const TArray<FString>& Args)
 {
 	ULyraGameplayCueManager* GCM = Cast<ULyraGameplayCueManager>(UAbilitySystemGlobals::Get().GetGameplayCueManager());
@@ -177,6 +242,38 @@ void ULyraGameplayCueManager::DumpGameplayCues(const TArray<FString>& Args)
 	UE_LOG(LogLyra, Log, TEXT("  ... %d cues in total"), GCM->AlwaysLoadedCues.Num() + GCM->PreloadedCues.Num() + NumMissingCuesLoaded);
 }
 
+void ULyraGameplayCueManager::DumpGameplayCuePreloads(const TArray<FString>& Args)
+{
+	ULyraGameplayCueManager* GCM = Cast<ULyraGameplayCueManager>(UAbilitySystemGlobals::Get().GetGameplayCueManager());
+	if (!GCM)
+	{
+		UE_LOG(LogLyra, Error, TEXT("DumpGameplayCuePreloads failed. No ULyraGameplayCueManager found."));
+		return;
+	}
+
+	const FCuePreloadStats& Stats = GCM->CuePreloadStats;
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Gameplay Cue Preloads ==========="));
+	UE_LOG(LogLyra, Log, TEXT("  ... %d in flight (max %d, limit %d)"), GCM->NumCuePreloadsInFlight, Stats.MaxInFlight, LyraGameplayCueManagerCvars::MaxConcurrentPreloads);
+	UE_LOG(LogLyra, Log, TEXT("  ... %d queued (high %d, normal %d, low %d, longest %d)"),
+		GCM->PendingCuePreloads[(int32)ECuePreloadPriority::High].Num() + GCM->PendingCuePreloads[(int32)ECuePreloadPriority::Normal].Num() + GCM->PendingCuePreloads[(int32)ECuePreloadPriority::Low].Num(),
+		GCM->PendingCuePreloads[(int32)ECuePreloadPriority::High].Num(), GCM->PendingCuePreloads[(int32)ECuePreloadPriority::Normal].Num(), GCM->PendingCuePreloads[(int32)ECuePreloadPriority::Low].Num(), Stats.MaxQueueLength);
+	UE_LOG(LogLyra, Log, TEXT("  ... %d requested, %d started, %d dropped as stale, %d prioritized"), Stats.NumQueued, Stats.NumStarted, Stats.NumSkippedStale, Stats.NumPrioritized);
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Gameplay Cue Misses ==========="));
+	UE_LOG(LogLyra, Log, TEXT("  ... %d misses (%d while queued, %d within %.0f s of a map load)"), Stats.NumMisses, Stats.NumMissesWhileQueued, Stats.NumMissesAfterMapLoad, LyraGameplayCueManagerCvars::MapStartSeconds);
+	UE_LOG(LogLyra, Log, TEXT("  ... %d loads started on a miss, %d completed (%.2f ms average, %.2f ms max)"), Stats.NumMissLoadsStarted, Stats.NumMissLoadsCompleted,
+		(Stats.NumMissLoadsCompleted > 0) ? (Stats.MissLoadSeconds * 1000.0 / Stats.NumMissLoadsCompleted) : 0.0, Stats.MaxMissLoadSeconds * 1000.0);
+
+	if (Args.Contains(TEXT("Misses")))
+	{
+		for (const TPair<FGameplayTag, int32>& Pair : GCM->CueMissCounts)
+		{
+			UE_LOG(LogLyra, Log, TEXT("  %s (%d)"), *Pair.Key.ToString(), Pair.Value);
+		}
+	}
+}
+
 void ULyraGameplayCueManager::OnGameplayTagLoaded(const FGameplayTag& Tag)
 {
 	FScopeLock ScopeLock(&LoadedGameplayTagsToProcessCS);
@@ -281,15 +378,107 @@ void ULyraGameplayCueManager::ProcessTagToPreload(const FGameplayTag& Tag, UObje
 		}
 		else
 		{
-			bool bAlwaysLoadedCue = OwningObject == nullptr;
-			TWeakObjectPtr<UObject> WeakOwner = OwningObject;
-			StreamableManager.RequestAsyncLoad(CueData.GameplayCueNotifyObj, FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadCueComplete, CueData.GameplayCueNotifyObj, WeakOwner, bAlwaysLoadedCue), FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("GameplayCueManager"));
+			// Queue the load, so a burst of referenced cues (e.g., at match start) doesn't saturate the streamer
+			FPendingCuePreload Pending;
+			Pending.Tag = Tag;
+			Pending.Path = CueData.GameplayCueNotifyObj;
+			Pending.WeakOwner = OwningObject;
+			Pending.OwnerPackage = OwningObject ? OwningObject->GetOutermost() : nullptr;
+			Pending.bAlwaysLoadedCue = OwningObject == nullptr;
+
+			ECuePreloadPriority Priority = ECuePreloadPriority::Low;
+			if (PrioritizedCuePackages.Contains(Pending.OwnerPackage))
+			{
+				Priority = ECuePreloadPriority::High;
+			}
+			else if (Pending.bAlwaysLoadedCue || OwningObject->IsA<UGameplayAbility>() || (Cast<UClass>(OwningObject) && CastChecked<UClass>(OwningObject)->IsChildOf<UGameplayAbility>()))
+			{
+				Priority = ECuePreloadPriority::Normal;
+			}
+
+			TArray<FPendingCuePreload>& Queue = PendingCuePreloads[(int32)Priority];
+			Queue.Add(MoveTemp(Pending));
+			++CuePreloadStats.NumQueued;
+			CuePreloadStats.MaxQueueLength = FMath::Max(CuePreloadStats.MaxQueueLength, PendingCuePreloads[0].Num() + PendingCuePreloads[1].Num() + PendingCuePreloads[2].Num());
+
+			PumpCuePreloadQueue();
+		}
+	}
+}
+
+void ULyraGameplayCueManager::PrioritizeCuePreloadsFor(const UObject* Referencer)
+{
+	if (Referencer == nullptr)
+	{
+		return;
+	}
+
+	const FObjectKey Package = Referencer->GetOutermost();
+	PrioritizedCuePackages.Add(Package);
+
+	TArray<FPendingCuePreload>& HighQueue = PendingCuePreloads[(int32)ECuePreloadPriority::High];
+	for (int32 PriorityIndex = 0; PriorityIndex < (int32)ECuePreloadPriority::High; ++PriorityIndex)
+	{
+		TArray<FPendingCuePreload>& Queue = PendingCuePreloads[PriorityIndex];
+		for (int32 QueueIndex = 0; QueueIndex < Queue.Num();)
+		{
+			if (Queue[QueueIndex].OwnerPackage == Package)
+			{
+				HighQueue.Add(MoveTemp(Queue[QueueIndex]));
+				Queue.RemoveAt(QueueIndex);
+				++CuePreloadStats.NumPrioritized;
+			}
+			else
+			{
+				++QueueIndex;
+			}
+		}
+	}
+}
+
+void ULyraGameplayCueManager::PumpCuePreloadQueue()
+{
+	const int32 MaxInFlight = LyraGameplayCueManagerCvars::MaxConcurrentPreloads;
+
+	for (int32 PriorityIndex = (int32)ECuePreloadPriority::Count - 1; PriorityIndex >= 0; --PriorityIndex)
+	{
+		TArray<FPendingCuePreload>& Queue = PendingCuePreloads[PriorityIndex];
+		while ((Queue.Num() > 0) && ((MaxInFlight <= 0) || (NumCuePreloadsInFlight < MaxInFlight)))
+		{
+			const FPendingCuePreload Pending = Queue[0];
+			Queue.RemoveAt(0);
+
+			// The referencing content may have gone away while this was queued (e.g., after a map change)
+			if (!Pending.bAlwaysLoadedCue && !Pending.WeakOwner.IsValid())
+			{
+				++CuePreloadStats.NumSkippedStale;
+				continue;
+			}
+
+			if (UClass* LoadedGameplayCueClass = FindObject<UClass>(nullptr, *Pending.Path.ToString()))
+			{
+				RegisterPreloadedCue(LoadedGameplayCueClass, Pending.WeakOwner.Get());
+				continue;
+			}
+
+			++NumCuePreloadsInFlight;
+			++CuePreloadStats.NumStarted;
+			CuePreloadStats.MaxInFlight = FMath::Max(CuePreloadStats.MaxInFlight, NumCuePreloadsInFlight);
+
+			const TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(Pending.Path, FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadCueComplete, Pending.Path, Pending.WeakOwner, Pending.bAlwaysLoadedCue), FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("GameplayCueManager"));
+			if (!Handle.IsValid())
+			{
+				// Nothing to load, the delegate will not be called
+				--NumCuePreloadsInFlight;
+			}
 		}
 	}
 }
 
 void ULyraGameplayCueManager::OnPreloadCueComplete(FSoftObjectPath Path, TWeakObjectPtr<UObject> OwningObject, bool bAlwaysLoadedCue)
 {
+	NumCuePreloadsInFlight = FMath::Max(NumCuePreloadsInFlight - 1, 0);
+
 	if (bAlwaysLoadedCue || OwningObject.IsValid())
 	{
 		if (UClass* LoadedGameplayCueClass = Cast<UClass>(Path.ResolveObject()))
@@ -297,6 +486,22 @@ void ULyraGameplayCueManager::OnPreloadCueComplete(FSoftObjectPath Path, TWeakOb
 			RegisterPreloadedCue(LoadedGameplayCueClass, OwningObject.Get());
 		}
 	}
+
+	PumpCuePreloadQueue();
+}
+
+void ULyraGameplayCueManager::OnMissingCueLoadComplete(FSoftObjectPath Path)
+{
+	double StartTime = 0.0;
+	if (MissLoadStartTimes.RemoveAndCopyValue(Path, StartTime))
+	{
+		const double LoadSeconds = FPlatformTime::Seconds() - StartTime;
+		++CuePreloadStats.NumMissLoadsCompleted;
+		CuePreloadStats.MissLoadSeconds += LoadSeconds;
+		CuePreloadStats.MaxMissLoadSeconds = FMath::Max(CuePreloadStats.MaxMissLoadSeconds, LoadSeconds);
+
+		UE_LOG(LogLyra, Verbose, TEXT("Missed gameplay cue %s finished loading after %.2f ms"), *Path.ToString(), LoadSeconds * 1000.0);
+	}
 }
 
 void ULyraGameplayCueManager::RegisterPreloadedCue(UClass* LoadedGameplayCueClass, UObject* OwningObject)
@@ -320,6 +525,9 @@ void ULyraGameplayCueManager::RegisterPreloadedCue(UClass* LoadedGameplayCueClas
 
 void ULyraGameplayCueManager::HandlePostLoadMap(UWorld* NewWorld)
 {
+	LastMapLoadTime = FPlatformTime::Seconds();
+	PrioritizedCuePackages.Reset();
+
 	if (RuntimeGameplayCueObjectLibrary.CueSet)
 	{
 		for (UClass* CueClass : AlwaysLoadedCues)
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "GameplayCueManager.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraGameplayCueManager.generated.h"
 
@@ -10,7 +11,6 @@ class FString;
 class UClass;
 class UObject;
 class UWorld;
-struct FObjectKey;
 
 /**
  * ULyraGameplayCueManager
@@ -32,9 +32,15 @@ public:
 	virtual bool ShouldAsyncLoadRuntimeObjectLibraries() const override;
 	virtual bool ShouldSyncLoadMissingGameplayCues() const override;
 	virtual bool ShouldAsyncLoadMissingGameplayCues() const override;
+	virtual bool HandleMissingGameplayCue(UGameplayCueSet* OwningSet, struct FGameplayCueNotifyData& CueData, AActor* TargetActor, EGameplayCueEvent::Type EventType, FGameplayCueParameters& Parameters) override;
 	//~End of UGameplayCueManager interface
 
 	static void DumpGameplayCues(const TArray<FString>& Args);
+	static void DumpGameplayCuePreloads(const TArray<FString>& Args);
+
+	// Moves the queued preloads of cues referenced by content in the same package as Referencer to the front of the queue
+	// (e.g., for abilities granted to a local player, whose cues are likely to play soon)
+	void PrioritizeCuePreloadsFor(const UObject* Referencer);
 
 	// When delay loading cues, this will load the cues that must be always loaded anyway
 	void LoadAlwaysLoadedCues();
@@ -47,7 +53,9 @@ private:
 	void HandlePostGarbageCollect();
 	void ProcessLoadedTags();
 	void ProcessTagToPreload(const FGameplayTag& Tag, UObject* OwningObject);
+	void PumpCuePreloadQueue();
 	void OnPreloadCueComplete(FSoftObjectPath Path, TWeakObjectPtr<UObject> OwningObject, bool bAlwaysLoadedCue);
+	void OnMissingCueLoadComplete(FSoftObjectPath Path);
 	void RegisterPreloadedCue(UClass* LoadedGameplayCueClass, UObject* OwningObject);
 	void HandlePostLoadMap(UWorld* NewWorld);
 	void UpdateDelayLoadDelegateListeners();
@@ -63,6 +71,51 @@ private:
 		FLoadedGameplayTagToProcessData(const FGameplayTag& InTag, const TWeakObjectPtr<UObject>& InWeakOwner) : Tag(InTag), WeakOwner(InWeakOwner) {}
 	};
 
+	// Order in which queued cue preloads are started, highest first
+	enum class ECuePreloadPriority : uint8
+	{
+		// Referenced by other content
+		Low,
+
+		// Always loaded cues, and cues referenced by gameplay abilities
+		Normal,
+
+		// Referenced by content of abilities granted to a local player
+		High,
+
+		Count
+	};
+
+	struct FPendingCuePreload
+	{
+		FGameplayTag Tag;
+		FSoftObjectPath Path;
+		TWeakObjectPtr<UObject> WeakOwner;
+		FObjectKey OwnerPackage;
+		bool bAlwaysLoadedCue = false;
+	};
+
+	struct FCuePreloadStats
+	{
+		int32 NumQueued = 0;
+		int32 NumStarted = 0;
+		int32 NumSkippedStale = 0;
+		int32 NumPrioritized = 0;
+		int32 MaxQueueLength = 0;
+		int32 MaxInFlight = 0;
+
+		// Cues that were invoked before they were loaded
+		int32 NumMisses = 0;
+		int32 NumMissesWhileQueued = 0;
+		int32 NumMissesAfterMapLoad = 0;
+
+		// Loads started for missed cues, and how long the completed ones took to arrive
+		int32 NumMissLoadsStarted = 0;
+		int32 NumMissLoadsCompleted = 0;
+		double MissLoadSeconds = 0.0;
+		double MaxMissLoadSeconds = 0.0;
+	};
+
 private:
 	// Cues that were preloaded on the client due to being referenced by content
 	UPROPERTY(transient)
@@ -73,6 +126,18 @@ private:
 	UPROPERTY(transient)
 	TSet<TObjectPtr<UClass>> AlwaysLoadedCues;
 
+	// Cue preloads waiting for a free slot (see lyra.GameplayCue.Preload.MaxConcurrentLoads), by priority
+	TArray<FPendingCuePreload> PendingCuePreloads[(int32)ECuePreloadPriority::Count];
+	int32 NumCuePreloadsInFlight = 0;
+
+	// Packages whose cue preloads go first
+	TSet<FObjectKey> PrioritizedCuePackages;
+
+	FCuePreloadStats CuePreloadStats;
+	TMap<FGameplayTag, int32> CueMissCounts;
+	TMap<FSoftObjectPath, double> MissLoadStartTimes;
+	double LastMapLoadTime = 0.0;
+
 	TArray<FLoadedGameplayTagToProcessData> LoadedGameplayTagsToProcess;
 	FCriticalSection LoadedGameplayTagsToProcessCS;
 	bool bProcessLoadedTagsAfterGC = false;
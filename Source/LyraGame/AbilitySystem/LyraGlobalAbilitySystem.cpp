@@ -3,9 +3,111 @@
 #include "LyraGlobalAbilitySystem.h"
 
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Performance/LyraServerPerfTimers.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGlobalAbilitySystem)
 
+namespace LyraConsoleVariables
+{
+	static float GlobalAbilityApplyBudgetMs = 1.0f;
+	static FAutoConsoleVariableRef CVarGlobalAbilityApplyBudgetMs(
+		TEXT("lyra.GlobalAbilitySystem.ApplyBudgetMs"),
+		GlobalAbilityApplyBudgetMs,
+		TEXT("How long (in ms) the global ability system can spend per frame giving global abilities and effects to the registered ability systems, the rest waits for the next frames (0 applies everything at once)"),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGlobalPendingApplication
+
+void FGlobalPendingApplication::Start(const TArray<TObjectPtr<ULyraAbilitySystemComponent>>& InASCs)
+{
+	Reset();
+
+	ASCs.Reserve(InASCs.Num());
+	for (ULyraAbilitySystemComponent* ASC : InASCs)
+	{
+		ASCs.Add(ASC);
+	}
+	StartTime = FPlatformTime::Seconds();
+}
+
+void FGlobalPendingApplication::Remove(ULyraAbilitySystemComponent* ASC)
+{
+	for (int32 Index = NextIndex; Index < ASCs.Num(); ++Index)
+	{
+		if (ASCs[Index] == ASC)
+		{
+			// Skipped when its turn comes
+			ASCs[Index].Reset();
+		}
+	}
+}
+
+void FGlobalPendingApplication::Reset()
+{
+	ASCs.Reset();
+	NextIndex = 0;
+	StartTime = 0.0;
+	ApplySeconds = 0.0;
+	MaxFrameApplySeconds = 0.0;
+	NumFrames = 0;
+	NumApplied = 0;
+}
+
+namespace LyraGlobalAbilitySystem
+{
+	// Gives the entry to the pending ASCs until the frame is over budget, returns true if none are left
+	template <typename EntryKeyType, typename EntryType>
+	static bool ApplyPending(const EntryKeyType& Key, EntryType& Entry, double FrameStartTime, double BudgetSeconds)
+	{
+		FGlobalPendingApplication& Pending = Entry.Pending;
+		if (Pending.IsEmpty())
+		{
+			return true;
+		}
+
+		const double EntryStartTime = FPlatformTime::Seconds();
+		while (!Pending.IsEmpty())
+		{
+			if ((BudgetSeconds > 0.0) && ((FPlatformTime::Seconds() - FrameStartTime) >= BudgetSeconds))
+			{
+				break;
+			}
+
+			ULyraAbilitySystemComponent* ASC = Pending.ASCs[Pending.NextIndex++].Get();
+			if (ASC != nullptr)
+			{
+				Entry.AddToASC(Key, ASC);
+				++Pending.NumApplied;
+			}
+		}
+
+		const double EntrySeconds = FPlatformTime::Seconds() - EntryStartTime;
+		Pending.ApplySeconds += EntrySeconds;
+		Pending.MaxFrameApplySeconds = FMath::Max(Pending.MaxFrameApplySeconds, EntrySeconds);
+		++Pending.NumFrames;
+
+		if (!Pending.IsEmpty())
+		{
+			return false;
+		}
+
+		UE_LOG(LogLyraAbilitySystem, Log, TEXT("Applied global %s to %d ability systems over %d frames (%.2f ms applying, %.2f ms in the busiest frame, %.2f ms end to end)"),
+			*GetNameSafe(Key.Get()), Pending.NumApplied, Pending.NumFrames, Pending.ApplySeconds * 1000.0, Pending.MaxFrameApplySeconds * 1000.0, (FPlatformTime::Seconds() - Pending.StartTime) * 1000.0);
+
+		Pending.Reset();
+		return true;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
 void FGlobalAppliedAbilityList::AddToASC(TSubclassOf<UGameplayAbility> Ability, ULyraAbilitySystemComponent* ASC)
 {
 	if (FGameplayAbilitySpecHandle* SpecHandle = Handles.Find(ASC))
@@ -26,6 +128,8 @@ void FGlobalAppliedAbilityList::RemoveFromASC(ULyraAbilitySystemComponent* ASC)
 		ASC->ClearAbility(*SpecHandle);
 		Handles.Remove(ASC);
 	}
+
+	Pending.Remove(ASC);
 }
 
 void FGlobalAppliedAbilityList::RemoveFromAll()
@@ -38,6 +142,7 @@ void FGlobalAppliedAbilityList::RemoveFromAll()
 		}
 	}
 	Handles.Empty();
+	Pending.Reset();
 }
 
 
@@ -49,8 +154,19 @@ void FGlobalAppliedEffectList::AddToASC(TSubclassOf<UGameplayEffect> Effect, ULy
 		RemoveFromASC(ASC);
 	}
 
-	const UGameplayEffect* GameplayEffectCDO = Effect->GetDefaultObject<UGameplayEffect>();
-	const FActiveGameplayEffectHandle GameplayEffectHandle = ASC->ApplyGameplayEffectToSelf(GameplayEffectCDO, /*Level=*/ 1, ASC->MakeEffectContext());
+	if (!SharedSpec.IsValid())
+	{
+		const UGameplayEffect* GameplayEffectCDO = Effect->GetDefaultObject<UGameplayEffect>();
+		const FGameplayEffectContextHandle SharedContext(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+		SharedSpec = FGameplayEffectSpecHandle(new FGameplayEffectSpec(GameplayEffectCDO, SharedContext, /*Level=*/ 1));
+	}
+
+	// The effect is applied by the ASC to itself, as if it came from ApplyGameplayEffectToSelf
+	FGameplayEffectSpec Spec(*SharedSpec.Data);
+	Spec.SetContext(ASC->MakeEffectContext(), /*bSkipRecaptureSourceActorTags=*/ true);
+	Spec.CaptureDataFromSource();
+
+	const FActiveGameplayEffectHandle GameplayEffectHandle = ASC->ApplyGameplayEffectSpecToSelf(Spec);
 	Handles.Add(ASC, GameplayEffectHandle);
 }
 
@@ -61,6 +177,8 @@ void FGlobalAppliedEffectList::RemoveFromASC(ULyraAbilitySystemComponent* ASC)
 		ASC->RemoveActiveGameplayEffect(*EffectHandle);
 		Handles.Remove(ASC);
 	}
+
+	Pending.Remove(ASC);
 }
 
 void FGlobalAppliedEffectList::RemoveFromAll()
@@ -73,6 +191,8 @@ void FGlobalAppliedEffectList::RemoveFromAll()
 		}
 	}
 	Handles.Empty();
+	Pending.Reset();
+	SharedSpec = FGameplayEffectSpecHandle();
 }
 
 ULyraGlobalAbilitySystem::ULyraGlobalAbilitySystem()
@@ -83,11 +203,10 @@ void ULyraGlobalAbilitySystem::ApplyAbilityToAll(TSubclassOf<UGameplayAbility> A
 {
 	if ((Ability.Get() != nullptr) && (!AppliedAbilities.Contains(Ability)))
 	{
-		FGlobalAppliedAbilityList& Entry = AppliedAbilities.Add(Ability);		
-		for (ULyraAbilitySystemComponent* ASC : RegisteredASCs)
-		{
-			Entry.AddToASC(Ability, ASC);
-		}
+		FGlobalAppliedAbilityList& Entry = AppliedAbilities.Add(Ability);
+		Entry.Pending.Start(RegisteredASCs);
+
+		ApplyPendingToASCs();
 	}
 }
 
@@ -96,10 +215,9 @@ void ULyraGlobalAbilitySystem::ApplyEffectToAll(TSubclassOf<UGameplayEffect> Eff
 	if ((Effect.Get() != nullptr) && (!AppliedEffects.Contains(Effect)))
 	{
 		FGlobalAppliedEffectList& Entry = AppliedEffects.Add(Effect);
-		for (ULyraAbilitySystemComponent* ASC : RegisteredASCs)
-		{
-			Entry.AddToASC(Effect, ASC);
-		}
+		Entry.Pending.Start(RegisteredASCs);
+
+		ApplyPendingToASCs();
 	}
 }
 
@@ -127,12 +245,15 @@ void ULyraGlobalAbilitySystem::RegisterASC(ULyraAbilitySystemComponent* ASC)
 {
 	check(ASC);
 
+	// Applied right away, so take the ASC out of any bulk application still in progress
 	for (auto& Entry : AppliedAbilities)
 	{
+		Entry.Value.Pending.Remove(ASC);
 		Entry.Value.AddToASC(Entry.Key, ASC);
 	}
 	for (auto& Entry : AppliedEffects)
 	{
+		Entry.Value.Pending.Remove(ASC);
 		Entry.Value.AddToASC(Entry.Key, ASC);
 	}
 
@@ -154,3 +275,122 @@ void ULyraGlobalAbilitySystem::UnregisterASC(ULyraAbilitySystemComponent* ASC)
 	RegisteredASCs.Remove(ASC);
 }
 
+void ULyraGlobalAbilitySystem::ApplyPendingToASCs()
+{
+	using namespace LyraGlobalAbilitySystem;
+
+	LYRA_SERVER_PERF_SCOPE(GlobalAbilityApply);
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = LyraConsoleVariables::GlobalAbilityApplyBudgetMs / 1000.0;
+
+	bool bAllApplied = true;
+	for (auto& Entry : AppliedAbilities)
+	{
+		bAllApplied = ApplyPending(Entry.Key, Entry.Value, FrameStartTime, BudgetSeconds) && bAllApplied;
+	}
+	for (auto& Entry : AppliedEffects)
+	{
+		bAllApplied = ApplyPending(Entry.Key, Entry.Value, FrameStartTime, BudgetSeconds) && bAllApplied;
+	}
+
+	UWorld* World = GetWorld();
+	if (!bAllApplied && !ApplyPendingTimerHandle.IsValid() && World)
+	{
+		ApplyPendingTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]()
+		{
+			ApplyPendingTimerHandle.Invalidate();
+			ApplyPendingToASCs();
+		}));
+	}
+}
+
+bool ULyraGlobalAbilitySystem::HasPendingApplications() const
+{
+	for (const auto& Entry : AppliedAbilities)
+	{
+		if (!Entry.Value.Pending.IsEmpty())
+		{
+			return true;
+		}
+	}
+	for (const auto& Entry : AppliedEffects)
+	{
+		if (!Entry.Value.Pending.IsEmpty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+#if !UE_BUILD_SHIPPING
+void ULyraGlobalAbilitySystem::RunApplyBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	ULyraGlobalAbilitySystem* GlobalAbilitySystem = World ? World->GetSubsystem<ULyraGlobalAbilitySystem>() : nullptr;
+	if (GlobalAbilitySystem == nullptr)
+	{
+		UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Global ability benchmark: no global ability system in this world"));
+		return;
+	}
+
+	const TSubclassOf<UGameplayEffect> Effect = (Args.Num() > 0) ? TSubclassOf<UGameplayEffect>(FSoftClassPath(Args[0]).TryLoadClass<UGameplayEffect>()) : nullptr;
+	if (Effect.Get() == nullptr)
+	{
+		UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Global ability benchmark: needs a gameplay effect class, e.g. /Game/GameplayEffects/GE_Example.GE_Example_C"));
+		return;
+	}
+
+	if (GlobalAbilitySystem->AppliedEffects.Contains(Effect) || GlobalAbilitySystem->HasPendingApplications())
+	{
+		UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Global ability benchmark: %s is already applied globally or another application is in progress"), *GetNameSafe(Effect.Get()));
+		return;
+	}
+
+	const float PreviousBudgetMs = LyraConsoleVariables::GlobalAbilityApplyBudgetMs;
+	const float BudgetsMs[] = { 0.0f, 1.0f };
+
+	UE_LOG(LogLyraAbilitySystem, Log, TEXT("Global ability benchmark: applying %s to %d ability systems"), *GetNameSafe(Effect.Get()), GlobalAbilitySystem->RegisteredASCs.Num());
+	for (const float BudgetMs : BudgetsMs)
+	{
+		LyraConsoleVariables::GlobalAbilityApplyBudgetMs = BudgetMs;
+
+		// Each call stands in for one frame's slice of the application
+		int32 NumSlices = 0;
+		double TotalSeconds = 0.0;
+		double MaxSliceSeconds = 0.0;
+		do
+		{
+			const double SliceStartTime = FPlatformTime::Seconds();
+			if (NumSlices == 0)
+			{
+				GlobalAbilitySystem->ApplyEffectToAll(Effect);
+			}
+			else
+			{
+				GlobalAbilitySystem->ApplyPendingToASCs();
+			}
+			const double SliceSeconds = FPlatformTime::Seconds() - SliceStartTime;
+
+			++NumSlices;
+			TotalSeconds += SliceSeconds;
+			MaxSliceSeconds = FMath::Max(MaxSliceSeconds, SliceSeconds);
+		}
+		while (GlobalAbilitySystem->HasPendingApplications());
+
+		GlobalAbilitySystem->RemoveEffectFromAll(Effect);
+
+		UE_LOG(LogLyraAbilitySystem, Log, TEXT("  Budget %.1f ms: %.3f ms in the busiest frame, %d frames, %.3f ms total"), BudgetMs, MaxSliceSeconds * 1000.0, NumSlices, TotalSeconds * 1000.0);
+	}
+
+	LyraConsoleVariables::GlobalAbilityApplyBudgetMs = PreviousBudgetMs;
+}
+
+namespace LyraGlobalAbilitySystem
+{
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("lyra.GlobalAbilitySystem.Benchmark"),
+		TEXT("Applies a gameplay effect to every registered ability system at once and under a 1 ms frame budget, and logs the busiest frame of each. Usage: lyra.GlobalAbilitySystem.Benchmark <GameplayEffectClass>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ULyraGlobalAbilitySystem::RunApplyBenchmark));
+}
+#endif // !UE_BUILD_SHIPPING
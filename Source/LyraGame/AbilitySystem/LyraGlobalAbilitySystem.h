@@ -3,9 +3,12 @@
 #pragma once
 
 #include "ActiveGameplayEffectHandle.h"
+#include "Engine/TimerHandle.h"
+#include "GameplayEffectTypes.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "GameplayAbilitySpecHandle.h"
 #include "Templates/SubclassOf.h"
+#include "UObject/WeakObjectPtr.h"
 
 #include "LyraGlobalAbilitySystem.generated.h"
 
@@ -13,10 +16,30 @@ class UGameplayAbility;
 class UGameplayEffect;
 class ULyraAbilitySystemComponent;
 class UObject;
+class UWorld;
 struct FActiveGameplayEffectHandle;
 struct FFrame;
 struct FGameplayAbilitySpecHandle;
 
+/** Ability systems still waiting for a global ability or effect, given a few per frame under lyra.GlobalAbilitySystem.ApplyBudgetMs */
+struct FGlobalPendingApplication
+{
+	TArray<TWeakObjectPtr<ULyraAbilitySystemComponent>> ASCs;
+	int32 NextIndex = 0;
+
+	// Timings of the current bulk application
+	double StartTime = 0.0;
+	double ApplySeconds = 0.0;
+	double MaxFrameApplySeconds = 0.0;
+	int32 NumFrames = 0;
+	int32 NumApplied = 0;
+
+	void Start(const TArray<TObjectPtr<ULyraAbilitySystemComponent>>& InASCs);
+	void Remove(ULyraAbilitySystemComponent* ASC);
+	void Reset();
+	bool IsEmpty() const { return NextIndex >= ASCs.Num(); }
+};
+
 USTRUCT()
 struct FGlobalAppliedAbilityList
 {
@@ -25,6 +48,8 @@ struct FGlobalAppliedAbilityList
 	UPROPERTY()
 	TMap<TObjectPtr<ULyraAbilitySystemComponent>, FGameplayAbilitySpecHandle> Handles;
 
+	FGlobalPendingApplication Pending;
+
 	void AddToASC(TSubclassOf<UGameplayAbility> Ability, ULyraAbilitySystemComponent* ASC);
 	void RemoveFromASC(ULyraAbilitySystemComponent* ASC);
 	void RemoveFromAll();
@@ -38,6 +63,11 @@ struct FGlobalAppliedEffectList
 	UPROPERTY()
 	TMap<TObjectPtr<ULyraAbilitySystemComponent>, FActiveGameplayEffectHandle> Handles;
 
+	FGlobalPendingApplication Pending;
+
+	// Spec built once for the effect, each ASC applies a copy with its own context
+	FGameplayEffectSpecHandle SharedSpec;
+
 	void AddToASC(TSubclassOf<UGameplayEffect> Effect, ULyraAbilitySystemComponent* ASC);
 	void RemoveFromASC(ULyraAbilitySystemComponent* ASC);
 	void RemoveFromAll();
@@ -69,7 +99,18 @@ public:
 	/** Removes an ASC from the global system, along with any active global effects/abilities. */
 	void UnregisterASC(ULyraAbilitySystemComponent* ASC);
 
+#if !UE_BUILD_SHIPPING
+	// Applies an effect to every registered ASC with and without the frame budget, and logs the time of the busiest slice of each
+	static void RunApplyBenchmark(const TArray<FString>& Args, UWorld* World);
+#endif
+
 private:
+	// Gives the pending global abilities and effects to the registered ASCs, until the frame budget runs out
+	void ApplyPendingToASCs();
+
+	// Returns true if a global ability or effect is still waiting to be given to some ASCs
+	bool HasPendingApplications() const;
+
 	UPROPERTY()
 	TMap<TSubclassOf<UGameplayAbility>, FGlobalAppliedAbilityList> AppliedAbilities;
 
@@ -78,4 +119,6 @@ private:
 
 	UPROPERTY()
 	TArray<TObjectPtr<ULyraAbilitySystemComponent>> RegisteredASCs;
+
+	FTimerHandle ApplyPendingTimerHandle;
 };
@@ -16,6 +16,7 @@
 #include "Player/LyraPlayerState.h"
 #include "System/LyraSignificanceManager.h"
 #include "TimerManager.h"
+#include "Weapons/LyraLagCompensationSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCharacter)
 
@@ -99,6 +100,14 @@ void ALyraCharacter::BeginPlay()
 //@TODO: SignificanceManager->RegisterObject(this, (EFortSignificanceType)SignificanceType);
 		}
 	}
+
+	if (HasAuthority())
+	{
+		if (ULyraLagCompensationSubsystem* LagCompensation = World->GetSubsystem<ULyraLagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
 }
 
 void ALyraCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -115,6 +124,11 @@ void ALyraCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 			SignificanceManager->UnregisterObject(this);
 		}
 	}
+
+	if (ULyraLagCompensationSubsystem* LagCompensation = World->GetSubsystem<ULyraLagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
 }
 
 void ALyraCharacter::Reset()
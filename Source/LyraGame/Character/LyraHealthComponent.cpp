@@ -16,11 +16,70 @@
 #include "GameFramework/GameplayMessageSubsystem.h"
 #include "GameFramework/PlayerState.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraHealthComponent)
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Elimination_Message, "Lyra.Elimination.Message");
 
+namespace LyraConsoleVariables
+{
+	static bool bCoalesceHealthChanges = true;
+	static FAutoConsoleVariableRef CVarCoalesceHealthChanges(
+		TEXT("lyra.Health.CoalesceChanges"),
+		bCoalesceHealthChanges,
+		TEXT("Can health components that opt in (bCoalesceHealthChanges) broadcast the health changes of a frame as one change? (0 broadcasts every change)"),
+		ECVF_Default);
+}
+
+namespace LyraHealthComponent
+{
+	// Components with health changes waiting for the end of the frame
+	static TArray<TWeakObjectPtr<ULyraHealthComponent>> ComponentsPendingFlush;
+	static FDelegateHandle PostActorTickHandle;
+
+	static void FlushPendingComponents(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		// Listeners can change the health again, those changes wait for the next frame
+		TArray<TWeakObjectPtr<ULyraHealthComponent>> ComponentsToFlush = MoveTemp(ComponentsPendingFlush);
+		ComponentsPendingFlush.Reset();
+
+		// Only flush the components of the world that just ticked, the others (e.g., other PIE instances) wait for their own world
+		TArray<TWeakObjectPtr<ULyraHealthComponent>> ComponentsInOtherWorlds;
+		for (const TWeakObjectPtr<ULyraHealthComponent>& WeakComponent : ComponentsToFlush)
+		{
+			if (ULyraHealthComponent* HealthComponent = WeakComponent.Get())
+			{
+				if (HealthComponent->GetWorld() == World)
+				{
+					HealthComponent->FlushHealthChanges();
+				}
+				else
+				{
+					ComponentsInOtherWorlds.Add(WeakComponent);
+				}
+			}
+		}
+		ComponentsPendingFlush.Append(ComponentsInOtherWorlds);
+
+		if (ComponentsPendingFlush.IsEmpty())
+		{
+			FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+			PostActorTickHandle.Reset();
+		}
+	}
+
+	static void AddComponentPendingFlush(ULyraHealthComponent* HealthComponent)
+	{
+		ComponentsPendingFlush.Add(HealthComponent);
+
+		if (!PostActorTickHandle.IsValid())
+		{
+			PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&FlushPendingComponents);
+		}
+	}
+}
+
 
 ULyraHealthComponent::ULyraHealthComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -33,6 +92,7 @@ ULyraHealthComponent::ULyraHealthComponent(const FObjectInitializer& ObjectIniti
 	AbilitySystemComponent = nullptr;
 	HealthSet = nullptr;
 	DeathState = ELyraDeathState::NotDead;
+	bCoalesceHealthChanges = false;
 }
 
 void ULyraHealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -90,6 +150,8 @@ void ULyraHealthComponent::InitializeWithAbilitySystem(ULyraAbilitySystemCompone
 
 void ULyraHealthComponent::UninitializeFromAbilitySystem()
 {
+	FlushHealthChanges();
+
 	ClearGameplayTags();
 
 	if (HealthSet)
@@ -137,7 +199,53 @@ float ULyraHealthComponent::GetHealthNormalized() const
 
 void ULyraHealthComponent::HandleHealthChanged(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec* DamageEffectSpec, float DamageMagnitude, float OldValue, float NewValue)
 {
-	OnHealthChanged.Broadcast(this, OldValue, NewValue, DamageInstigator);
+	if (!bCoalesceHealthChanges || !LyraConsoleVariables::bCoalesceHealthChanges)
+	{
+		OnHealthChanged.Broadcast(this, OldValue, NewValue, DamageInstigator);
+		return;
+	}
+
+	if (PendingHealthChanges.NumChanges == 0)
+	{
+		PendingHealthChanges.OldValue = OldValue;
+		LyraHealthComponent::AddComponentPendingFlush(this);
+	}
+
+	PendingHealthChanges.NewValue = NewValue;
+	++PendingHealthChanges.NumChanges;
+
+	if (NewValue < OldValue)
+	{
+		PendingHealthChanges.TotalDamage += (OldValue - NewValue);
+	}
+	else
+	{
+		PendingHealthChanges.TotalHealing += (NewValue - OldValue);
+	}
+
+	if (DamageInstigator)
+	{
+		PendingHealthChanges.Instigators.AddUnique(DamageInstigator);
+	}
+	PendingHealthChangeInstigator = DamageInstigator;
+}
+
+void ULyraHealthComponent::FlushHealthChanges()
+{
+	if (PendingHealthChanges.NumChanges == 0)
+	{
+		return;
+	}
+
+	// Reset before broadcasting, listeners can change the health again
+	const FLyraHealthChangeSummary Summary = MoveTemp(PendingHealthChanges);
+	PendingHealthChanges = FLyraHealthChangeSummary();
+
+	AActor* LastInstigator = PendingHealthChangeInstigator.Get();
+	PendingHealthChangeInstigator.Reset();
+
+	OnHealthChanged.Broadcast(this, Summary.OldValue, Summary.NewValue, LastInstigator);
+	OnHealthChangesCoalesced.Broadcast(this, Summary);
 }
 
 void ULyraHealthComponent::HandleMaxHealthChanged(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec* DamageEffectSpec, float DamageMagnitude, float OldValue, float NewValue)
@@ -147,6 +255,9 @@ void ULyraHealthComponent::HandleMaxHealthChanged(AActor* DamageInstigator, AAct
 
 void ULyraHealthComponent::HandleOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec* DamageEffectSpec, float DamageMagnitude, float OldValue, float NewValue)
 {
+	// Don't wait for the end of the frame, listeners should see the health run out before the death starts
+	FlushHealthChanges();
+
 #if WITH_SERVER_CODE
 	if (AbilitySystemComponent && DamageEffectSpec)
 	{
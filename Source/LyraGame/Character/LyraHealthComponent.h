@@ -19,6 +19,43 @@ struct FGameplayEffectSpec;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLyraHealth_DeathEvent, AActor*, OwningActor);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FLyraHealth_AttributeChanged, ULyraHealthComponent*, HealthComponent, float, OldValue, float, NewValue, AActor*, Instigator);
 
+/**
+ * FLyraHealthChangeSummary
+ *
+ *	All of the health changes of a frame, folded together by a health component that coalesces them.
+ */
+USTRUCT(BlueprintType)
+struct FLyraHealthChangeSummary
+{
+	GENERATED_BODY()
+
+	// Health before the first change of the frame.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	float OldValue = 0.0f;
+
+	// Health after the last change of the frame.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	float NewValue = 0.0f;
+
+	// Health lost over the frame, after clamping.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	float TotalDamage = 0.0f;
+
+	// Health gained over the frame, after clamping.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	float TotalHealing = 0.0f;
+
+	// Number of health changes folded into this one.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	int32 NumChanges = 0;
+
+	// Actors that instigated the changes, in the order of their first change. This is usually empty on clients.
+	UPROPERTY(BlueprintReadOnly, Category = "Lyra|Health")
+	TArray<TObjectPtr<AActor>> Instigators;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLyraHealth_HealthChangesCoalesced, ULyraHealthComponent*, HealthComponent, const FLyraHealthChangeSummary&, Summary);
+
 /**
  * ELyraDeathState
  *
@@ -86,6 +123,9 @@ public:
 	// Applies enough damage to kill the owner.
 	UE_API virtual void DamageSelfDestruct(bool bFellOutOfWorld = false);
 
+	// Broadcasts the health changes coalesced so far this frame, if there are any.
+	UE_API void FlushHealthChanges();
+
 public:
 
 	// Delegate fired when the health value has changed. This is called on the client but the instigator may not be valid
@@ -96,6 +136,10 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FLyraHealth_AttributeChanged OnMaxHealthChanged;
 
+	// Delegate fired once per frame with all of the health changes of the frame, only when the changes are coalesced
+	UPROPERTY(BlueprintAssignable)
+	FLyraHealth_HealthChangesCoalesced OnHealthChangesCoalesced;
+
 	// Delegate fired when the death sequence has started.
 	UPROPERTY(BlueprintAssignable)
 	FLyraHealth_DeathEvent OnDeathStarted;
@@ -130,6 +174,17 @@ protected:
 	// Replicated state used to handle dying.
 	UPROPERTY(ReplicatedUsing = OnRep_DeathState)
 	ELyraDeathState DeathState;
+
+	// If set, the health changes of a frame are broadcast as one change at the end of the frame (running out of health is still handled immediately).
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lyra|Health")
+	bool bCoalesceHealthChanges;
+
+	// Health changes waiting for the end of the frame.
+	UPROPERTY(Transient)
+	FLyraHealthChangeSummary PendingHealthChanges;
+
+	// Instigator of the last pending health change.
+	TWeakObjectPtr<AActor> PendingHealthChangeInstigator;
 };
 
 #undef UE_API
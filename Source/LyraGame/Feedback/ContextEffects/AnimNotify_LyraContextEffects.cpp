@@ -52,81 +52,67 @@ void UAnimNotify_LyraContextEffects::Notify(USkeletalMeshComponent* MeshComp, UA
 		// Make sure both MeshComp and Owning Actor is valid
 		if (AActor* OwningActor = MeshComp->GetOwner())
 		{
-			// Prepare Trace Data
-			bool bHitSuccess = false;
-			FHitResult HitResult;
-			FCollisionQueryParams QueryParams;
-
-			if (TraceProperties.bIgnoreActor)
-			{
-				QueryParams.AddIgnoredActor(OwningActor);
-			}
-
-			QueryParams.bReturnPhysicalMaterial = true;
+			UWorld* World = OwningActor->GetWorld();
+			ULyraContextEffectsSubsystem* LyraContextEffectsSubsystem = World ? World->GetSubsystem<ULyraContextEffectsSubsystem>() : nullptr;
+
+			FLyraContextEffectNotifyParams Params;
+			Params.MeshComponent = MeshComp;
+			Params.Animation = Animation;
+			Params.Effect = Effect;
+			Params.Bone = bAttached ? SocketName : FName("None");
+			Params.LocationOffset = LocationOffset;
+			Params.RotationOffset = RotationOffset;
+			Params.VFXScale = VFXProperties.Scale;
+			Params.AudioVolume = AudioProperties.VolumeMultiplier;
+			Params.AudioPitch = AudioProperties.PitchMultiplier;
 
 			if (bPerformTrace)
 			{
 				// If trace is needed, set up Start Location to Attached
-				FVector TraceStart = bAttached ? MeshComp->GetSocketLocation(SocketName) : MeshComp->GetComponentLocation();
+				Params.TraceStart = bAttached ? MeshComp->GetSocketLocation(SocketName) : MeshComp->GetComponentLocation();
+				Params.TraceEnd = Params.TraceStart + TraceProperties.EndTraceLocationOffset;
+				Params.TraceChannel = TraceProperties.TraceChannel;
+				Params.bIgnoreOwningActor = TraceProperties.bIgnoreActor;
 
-				// Make sure World is valid
-				if (UWorld* World = OwningActor->GetWorld())
+				if (LyraContextEffectsSubsystem && LyraContextEffectsSubsystem->ShouldBatchSurfaceTraces())
 				{
-					// Call Line Trace, Pass in relevant properties
-					bHitSuccess = World->LineTraceSingleByChannel(HitResult, TraceStart, (TraceStart + TraceProperties.EndTraceLocationOffset),
-						TraceProperties.TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam);
+					// Batched with the other notifies of this frame, the effect plays once the surface is known
+					LyraContextEffectsSubsystem->QueueSurfaceTrace(Params);
 				}
-			}
+				else if (World)
+				{
+					// Prepare Trace Data
+					FHitResult HitResult;
+					FCollisionQueryParams QueryParams;
 
-			// Prepare Contexts in advance
-			FGameplayTagContainer Contexts;
+					if (TraceProperties.bIgnoreActor)
+					{
+						QueryParams.AddIgnoredActor(OwningActor);
+					}
 
-			// Set up Array of Objects that implement the Context Effects Interface
-			TArray<UObject*> LyraContextEffectImplementingObjects;
+					QueryParams.bReturnPhysicalMaterial = true;
 
-			// Determine if the Owning Actor is one of the Objects that implements the Context Effects Interface
-			if (OwningActor->Implements<ULyraContextEffectsInterface>())
-			{
-				// If so, add it to the Array
-				LyraContextEffectImplementingObjects.Add(OwningActor);
-			}
+					// Call Line Trace, Pass in relevant properties
+					const bool bHitSuccess = World->LineTraceSingleByChannel(HitResult, Params.TraceStart, Params.TraceEnd,
+						TraceProperties.TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam);
 
-			// Cycle through Owning Actor's Components and determine if any of them is a Component implementing the Context Effect Interface
-			for (const auto Component : OwningActor->GetComponents())
-			{
-				if (Component)
-				{
-					// If the Component implements the Context Effects Interface, add it to the list
-					if (Component->Implements<ULyraContextEffectsInterface>())
-					{
-						LyraContextEffectImplementingObjects.Add(Component);
-					}
+					ULyraContextEffectsSubsystem::DispatchAnimMotionEffect(LyraContextEffectsSubsystem, Params, bHitSuccess, HitResult);
 				}
 			}
-
-			// Cycle through all objects implementing the Context Effect Interface
-			for (UObject* LyraContextEffectImplementingObject : LyraContextEffectImplementingObjects)
+			else
 			{
-				if (LyraContextEffectImplementingObject)
-				{
-					// If the object is still valid, Execute the AnimMotionEffect Event on it, passing in relevant data
-					ILyraContextEffectsInterface::Execute_AnimMotionEffect(LyraContextEffectImplementingObject,
-						(bAttached ? SocketName : FName("None")),
-						Effect, MeshComp, LocationOffset, RotationOffset,
-						Animation, bHitSuccess, HitResult, Contexts, VFXProperties.Scale,
-						AudioProperties.VolumeMultiplier, AudioProperties.PitchMultiplier);
-				}
+				ULyraContextEffectsSubsystem::DispatchAnimMotionEffect(LyraContextEffectsSubsystem, Params, false, FHitResult());
 			}
 
 #if WITH_EDITORONLY_DATA
 			// This is for Anim Editor previewing, it is a deconstruction of the calls made by the Interface and the Subsystem
 			if (bPreviewInEditor)
 			{
-				UWorld* World = OwningActor->GetWorld();
-
 				// Get the world, make sure it's an Editor Preview World
 				if (World && World->WorldType == EWorldType::EditorPreview)
 				{
+					FGameplayTagContainer Contexts;
+
 					// Add Preview contexts if necessary
 					Contexts.AppendTags(PreviewProperties.PreviewContexts);
 
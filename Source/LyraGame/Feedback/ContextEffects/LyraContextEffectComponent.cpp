@@ -3,8 +3,10 @@
 
 #include "LyraContextEffectComponent.h"
 
+#include "Components/AudioComponent.h"
 #include "Engine/World.h"
 #include "LyraContextEffectsSubsystem.h"
+#include "NiagaraComponent.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectComponent)
@@ -57,6 +59,32 @@ void ULyraContextEffectComponent::EndPlay(const EEndPlayReason::Type EndPlayReas
 	Super::EndPlay(EndPlayReason);
 }
 
+void ULyraContextEffectComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (const UWorld* World = GetWorld())
+	{
+		if (ULyraContextEffectsSubsystem* LyraContextEffectsSubsystem = World->GetSubsystem<ULyraContextEffectsSubsystem>())
+		{
+			LyraContextEffectsSubsystem->InvalidateContextEffectImplementers(GetOwner());
+		}
+	}
+}
+
+void ULyraContextEffectComponent::OnUnregister()
+{
+	if (const UWorld* World = GetWorld())
+	{
+		if (ULyraContextEffectsSubsystem* LyraContextEffectsSubsystem = World->GetSubsystem<ULyraContextEffectsSubsystem>())
+		{
+			LyraContextEffectsSubsystem->InvalidateContextEffectImplementers(GetOwner());
+		}
+	}
+
+	Super::OnUnregister();
+}
+
 // Implementation of Interface's AnimMotionEffect function
 void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bone, const FGameplayTag MotionEffect, USceneComponent* StaticMeshComponent,
 	const FVector LocationOffset, const FRotator RotationOffset, const UAnimSequenceBase* AnimationSequence,
@@ -132,9 +160,22 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 				LocationOffset, RotationOffset, MotionEffect, TotalContexts,
 				AudioComponents, NiagaraComponents, VFXScale, AudioVolume, AudioPitch);
 
-			// Append resultant effects
-			AudioComponentsToAdd.Append(AudioComponents);
-			NiagaraComponentsToAdd.Append(NiagaraComponents);
+			// Append resultant effects, leaving out pooled components (they go back to their pool when done and would never be released here)
+			for (UAudioComponent* AudioComponent : AudioComponents)
+			{
+				if (AudioComponent && !LyraContextEffectsSubsystem->IsPooledEffectComponent(AudioComponent))
+				{
+					AudioComponentsToAdd.Add(AudioComponent);
+				}
+			}
+
+			for (UNiagaraComponent* NiagaraComponent : NiagaraComponents)
+			{
+				if (NiagaraComponent && !LyraContextEffectsSubsystem->IsPooledEffectComponent(NiagaraComponent))
+				{
+					NiagaraComponentsToAdd.Add(NiagaraComponent);
+				}
+			}
 		}
 	}
 
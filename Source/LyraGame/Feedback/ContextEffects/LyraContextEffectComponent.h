@@ -36,6 +36,10 @@ protected:
 	// Called when the game ends
 	UE_API virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	// Called when registered/unregistered with the owning actor, so cached interface implementers get refreshed
+	UE_API virtual void OnRegister() override;
+	UE_API virtual void OnUnregister() override;
+
 public:
 	// AnimMotionEffect Implementation
 	UFUNCTION(BlueprintCallable)
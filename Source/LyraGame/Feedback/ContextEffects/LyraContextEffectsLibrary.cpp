@@ -2,6 +2,8 @@
 
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
 #include "NiagaraSystem.h"
 #include "Sound/SoundBase.h"
 
@@ -10,21 +12,41 @@
 
 void ULyraContextEffectsLibrary::GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, 
 	TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems)
+{
+	FLyraContextEffectSoundArray FoundSounds;
+	FLyraContextEffectNiagaraArray FoundNiagaraSystems;
+	FindEffects(Effect, Context, FoundSounds, FoundNiagaraSystems);
+
+	Sounds.Append(FoundSounds);
+	NiagaraSystems.Append(FoundNiagaraSystems);
+}
+
+void ULyraContextEffectsLibrary::FindEffects(const FGameplayTag Effect, const FGameplayTagContainer& Context,
+	FLyraContextEffectSoundArray& Sounds, FLyraContextEffectNiagaraArray& NiagaraSystems) const
 {
 	// Make sure Effect is valid and Library is loaded
 	if (Effect.IsValid() && Context.IsValid() && EffectsLoadState == EContextEffectsLibraryLoadState::Loaded)
 	{
-		// Loop through Context Effects
-		for (const auto& ActiveContextEffect : ActiveContextEffects)
+		// Only Context Effects with an exact Effect Tag match are in the list
+		if (const TArray<int32>* ActiveEffectIndices = EffectTagToActiveEffects.Find(Effect))
 		{
-			// Make sure the Effect is an exact Tag Match and ensure the Context has all tags in the Effect (and neither or both are empty)
-			if (Effect.MatchesTagExact(ActiveContextEffect->EffectTag)
-				&& Context.HasAllExact(ActiveContextEffect->Context)
-				&& (ActiveContextEffect->Context.IsEmpty() == Context.IsEmpty()))
+			// Entries needing more tags than the Context has can never match, skip past them
+			const int32 NumContextTags = Context.Num();
+			const int32 FirstCandidate = Algo::LowerBoundBy(*ActiveEffectIndices, NumContextTags,
+				[this](int32 ActiveEffectIndex) { return ActiveContextEffects[ActiveEffectIndex]->Context.Num(); },
+				TGreater<int32>());
+
+			for (int32 CandidateIndex = FirstCandidate; CandidateIndex < ActiveEffectIndices->Num(); ++CandidateIndex)
 			{
-				// Get all Matching Sounds and Niagara Systems
-				Sounds.Append(ActiveContextEffect->Sounds);
-				NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				const ULyraActiveContextEffects* ActiveContextEffect = ActiveContextEffects[(*ActiveEffectIndices)[CandidateIndex]];
+
+				// Ensure the Context has all tags in the Effect (Effects are never indexed with an empty Context)
+				if (Context.HasAllExact(ActiveContextEffect->Context))
+				{
+					// Get all Matching Sounds and Niagara Systems
+					Sounds.Append(ActiveContextEffect->Sounds);
+					NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				}
 			}
 		}
 	}
@@ -40,6 +62,7 @@ void ULyraContextEffectsLibrary::LoadEffects()
 
 		// Clear out any old Active Effects
 		ActiveContextEffects.Empty();
+		EffectTagToActiveEffects.Empty();
 
 		// Call internal loading function
 		LoadEffectsInternal();
@@ -115,5 +138,30 @@ void ULyraContextEffectsLibrary::LyraContextEffectLibraryLoadingComplete(
 
 	// Append incoming Context Effects Array to current list of Active Context Effects
 	ActiveContextEffects.Append(LyraActiveContextEffects);
+
+	BuildEffectIndex();
+}
+
+void ULyraContextEffectsLibrary::BuildEffectIndex()
+{
+	EffectTagToActiveEffects.Reset();
+
+	for (int32 ActiveEffectIndex = 0; ActiveEffectIndex < ActiveContextEffects.Num(); ++ActiveEffectIndex)
+	{
+		const ULyraActiveContextEffects* ActiveContextEffect = ActiveContextEffects[ActiveEffectIndex];
+		if (ActiveContextEffect && ActiveContextEffect->EffectTag.IsValid() && ActiveContextEffect->Context.IsValid())
+		{
+			EffectTagToActiveEffects.FindOrAdd(ActiveContextEffect->EffectTag).Add(ActiveEffectIndex);
+		}
+	}
+
+	// Sort by specificity, keeping authoring order between entries with the same number of Context tags
+	for (TPair<FGameplayTag, TArray<int32>>& Pair : EffectTagToActiveEffects)
+	{
+		Algo::StableSortBy(Pair.Value,
+			[this](int32 ActiveEffectIndex) { return ActiveContextEffects[ActiveEffectIndex]->Context.Num(); },
+			TGreater<int32>());
+		Pair.Value.Shrink();
+	}
 }
 
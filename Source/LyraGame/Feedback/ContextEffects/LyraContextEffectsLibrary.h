@@ -67,6 +67,10 @@ public:
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FLyraContextEffectLibraryLoadingComplete, TArray<ULyraActiveContextEffects*>, LyraActiveContextEffects);
 
+// Result buffers for native effect lookups, sized so a typical footstep or impact never allocates
+using FLyraContextEffectSoundArray = TArray<USoundBase*, TInlineAllocator<8>>;
+using FLyraContextEffectNiagaraArray = TArray<UNiagaraSystem*, TInlineAllocator<8>>;
+
 /**
  * 
  */
@@ -83,6 +87,12 @@ public:
 	UFUNCTION(BlueprintCallable)
 	UE_API void GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems);
 
+	/**
+	 * Native version of GetEffects, appending the matching effects to caller provided buffers.
+	 * Uses the index built when the library finished loading, so it only visits entries for the requested effect tag.
+	 */
+	UE_API void FindEffects(const FGameplayTag Effect, const FGameplayTagContainer& Context, FLyraContextEffectSoundArray& Sounds, FLyraContextEffectNiagaraArray& NiagaraSystems) const;
+
 	UFUNCTION(BlueprintCallable)
 	UE_API void LoadEffects();
 
@@ -93,11 +103,16 @@ private:
 
 	void LyraContextEffectLibraryLoadingComplete(TArray<ULyraActiveContextEffects*> LyraActiveContextEffects);
 
+	void BuildEffectIndex();
+
 	UPROPERTY(Transient)
 	TArray< TObjectPtr<ULyraActiveContextEffects>> ActiveContextEffects;
 
 	UPROPERTY(Transient)
 	EContextEffectsLibraryLoadState EffectsLoadState = EContextEffectsLibraryLoadState::Unloaded;
+
+	// Indices into ActiveContextEffects for each effect tag, most specific context (most tags) first
+	TMap<FGameplayTag, TArray<int32>> EffectTagToActiveEffects;
 };
 
 #undef UE_API
@@ -3,11 +3,21 @@
 
 #include "LyraContextEffectsSubsystem.h"
 
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Feedback/ContextEffects/LyraContextEffectsInterface.h"
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 #include "Feedback/ContextEffects/LyraContextEffectsSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
 #include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
+#include "SignificanceManager.h"
+#include "TimerManager.h"
+#include "Sound/SoundBase.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectsSubsystem)
 
@@ -17,6 +27,83 @@ class UNiagaraSystem;
 class USceneComponent;
 class USoundBase;
 
+DECLARE_STATS_GROUP(TEXT("LyraContextEffects"), STATGROUP_LyraContextEffects, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawns Avoided"), STAT_LyraContextEffects_SpawnsAvoided, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawns Avoided Per Second"), STAT_LyraContextEffects_SpawnsAvoidedPerSecond, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Audio Components"), STAT_LyraContextEffects_PooledAudioComponents, STATGROUP_LyraContextEffects);
+
+namespace LyraConsoleVariables
+{
+	static int32 ContextEffectsMaxConcurrentPerEffect = 12;
+	static FAutoConsoleVariableRef CVarContextEffectsMaxConcurrentPerEffect(
+		TEXT("lyra.ContextEffects.MaxConcurrentPerEffect"),
+		ContextEffectsMaxConcurrentPerEffect,
+		TEXT("Maximum number of sounds and particle systems playing at once for a single context effect tag (0 = unlimited)"),
+		ECVF_Default);
+
+	static float ContextEffectsVFXCullDistance = 6000.0f;
+	static FAutoConsoleVariableRef CVarContextEffectsVFXCullDistance(
+		TEXT("lyra.ContextEffects.VFXCullDistance"),
+		ContextEffectsVFXCullDistance,
+		TEXT("Context effect particle systems further than this from every local player's view are not spawned (0 = never cull by distance)"),
+		ECVF_Default);
+
+	static float ContextEffectsVFXRecentlyRenderedTime = 0.25f;
+	static FAutoConsoleVariableRef CVarContextEffectsVFXRecentlyRenderedTime(
+		TEXT("lyra.ContextEffects.VFXRecentlyRenderedTime"),
+		ContextEffectsVFXRecentlyRenderedTime,
+		TEXT("Context effect particle systems are not spawned on actors that have not been rendered for this long (0 = never cull off-screen actors)"),
+		ECVF_Default);
+
+	static bool bContextEffectsAsyncSurfaceTraces = true;
+	static FAutoConsoleVariableRef CVarContextEffectsAsyncSurfaceTraces(
+		TEXT("lyra.ContextEffects.AsyncSurfaceTraces"),
+		bContextEffectsAsyncSurfaceTraces,
+		TEXT("Should anim notify surface traces be batched as async traces (resolved next frame) instead of traced immediately?"),
+		ECVF_Default);
+
+	static int32 ContextEffectsMaxSurfaceTracesPerFrame = 32;
+	static FAutoConsoleVariableRef CVarContextEffectsMaxSurfaceTracesPerFrame(
+		TEXT("lyra.ContextEffects.MaxSurfaceTracesPerFrame"),
+		ContextEffectsMaxSurfaceTracesPerFrame,
+		TEXT("Maximum number of anim notify surface traces started per frame, the rest wait for a later frame"),
+		ECVF_Default);
+
+	static int32 ContextEffectsMaxSurfaceTraceWaitFrames = 2;
+	static FAutoConsoleVariableRef CVarContextEffectsMaxSurfaceTraceWaitFrames(
+		TEXT("lyra.ContextEffects.MaxSurfaceTraceWaitFrames"),
+		ContextEffectsMaxSurfaceTraceWaitFrames,
+		TEXT("Surface traces that could not be started within this many frames are dropped and their effect plays without a surface"),
+		ECVF_Default);
+
+	static int32 ContextEffectsMaxPooledAudioComponents = 32;
+	static FAutoConsoleVariableRef CVarContextEffectsMaxPooledAudioComponents(
+		TEXT("lyra.ContextEffects.MaxPooledAudioComponents"),
+		ContextEffectsMaxPooledAudioComponents,
+		TEXT("Maximum number of idle audio components kept around for reuse by context effects (0 = disable audio pooling)"),
+		ECVF_Default);
+}
+
+void ULyraContextEffectsSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : FreeAudioComponents)
+	{
+		if (IsValid(AudioComponent))
+		{
+			AudioComponent->DestroyComponent();
+		}
+	}
+	FreeAudioComponents.Reset();
+	ConcurrentEffects.Reset();
+	QueuedSurfaceTraces.Reset();
+	PendingSurfaceTraces.Reset();
+	ImplementersCache.Reset();
+
+	SET_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents, 0);
+
+	Super::Deinitialize();
+}
+
 void ULyraContextEffectsSubsystem::SpawnContextEffects(
 	const AActor* SpawningActor
 	, USceneComponent* AttachToComponent
@@ -38,8 +125,8 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 		if (ULyraContextEffectsSet* EffectsLibraries = *EffectsLibrariesSetPtr)
 		{
 			// Prepare Arrays for Sounds and Niagara Systems
-			TArray<USoundBase*> TotalSounds;
-			TArray<UNiagaraSystem*> TotalNiagaraSystems;
+			FLyraContextEffectSoundArray TotalSounds;
+			FLyraContextEffectNiagaraArray TotalNiagaraSystems;
 
 			// Cycle through Effect Libraries
 			for (ULyraContextEffectsLibrary* EffectLibrary : EffectsLibraries->LyraContextEffectsLibraries)
@@ -47,16 +134,8 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 				// Check if the Effect Library is valid and data Loaded
 				if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
 				{
-					// Set up local list of Sounds and Niagara Systems
-					TArray<USoundBase*> Sounds;
-					TArray<UNiagaraSystem*> NiagaraSystems;
-
-					// Get Sounds and Niagara Systems
-					EffectLibrary->GetEffects(Effect, Contexts, Sounds, NiagaraSystems);
-
-					// Append to accumulating array
-					TotalSounds.Append(Sounds);
-					TotalNiagaraSystems.Append(NiagaraSystems);
+					// Get Sounds and Niagara Systems, appending to the accumulating arrays
+					EffectLibrary->FindEffects(Effect, Contexts, TotalSounds, TotalNiagaraSystems);
 				}
 				else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
 				{
@@ -65,29 +144,267 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 				}
 			}
 
+			// Nobody is around to see or hear effects on a dedicated server
+			if (GetWorld()->IsNetMode(NM_DedicatedServer))
+			{
+				RecordAvoidedSpawns(TotalSounds.Num() + TotalNiagaraSystems.Num());
+				return;
+			}
+
+			// Effects on actors the significance manager considers irrelevant are skipped entirely
+			if (IsOwnerInsignificant(SpawningActor))
+			{
+				RecordAvoidedSpawns(TotalSounds.Num() + TotalNiagaraSystems.Num());
+				return;
+			}
+
+			TArray<FEffectViewer, TInlineAllocator<4>> Viewers;
+			GatherViewers(Viewers);
+
+			const FVector EffectLocation = AttachToComponent ? AttachToComponent->GetSocketTransform(AttachPoint).TransformPosition(LocationOffset) : LocationOffset;
+			int32 NumAvoided = 0;
+
 			// Cycle through found Sounds
 			for (USoundBase* Sound : TotalSounds)
 			{
+				if (Sound == nullptr)
+				{
+					continue;
+				}
+
+				// Skip Sounds out of earshot of every local player (without viewers, e.g. in preview worlds, we can't tell)
+				const float MaxAudibleDistance = Sound->GetMaxDistance();
+				const bool bAudible = (Viewers.Num() == 0) || Viewers.ContainsByPredicate([&](const FEffectViewer& Viewer)
+				{
+					return FVector::DistSquared(Viewer.ListenerLocation, EffectLocation) <= FMath::Square(MaxAudibleDistance);
+				});
+
+				if (!bAudible || !HasConcurrencyBudget(Effect))
+				{
+					++NumAvoided;
+					continue;
+				}
+
 				// Spawn Sounds Attached, add Audio Component to List of ACs
-				UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
-					false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+				UAudioComponent* AudioComponent = SpawnPooledSound(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, AudioVolume, AudioPitch);
+				if (AudioComponent)
+				{
+					TrackConcurrentEffect(Effect, AudioComponent);
+				}
 
 				AudioOut.Add(AudioComponent);
 			}
 
+			// Skip particles on actors that haven't been on screen recently
+			const AActor* AttachActor = AttachToComponent ? AttachToComponent->GetOwner() : SpawningActor;
+			const bool bRecentlyRendered = (LyraConsoleVariables::ContextEffectsVFXRecentlyRenderedTime <= 0.0f) || (AttachActor == nullptr) || (Viewers.Num() == 0)
+				|| AttachActor->WasRecentlyRendered(LyraConsoleVariables::ContextEffectsVFXRecentlyRenderedTime);
+
+			const float VFXCullDistance = LyraConsoleVariables::ContextEffectsVFXCullDistance;
+			const bool bInVFXRange = (VFXCullDistance <= 0.0f) || (Viewers.Num() == 0) || Viewers.ContainsByPredicate([&](const FEffectViewer& Viewer)
+			{
+				return FVector::DistSquared(Viewer.ViewLocation, EffectLocation) <= FMath::Square(VFXCullDistance);
+			});
+
 			// Cycle through found Niagara Systems
 			for (UNiagaraSystem* NiagaraSystem : TotalNiagaraSystems)
 			{
-				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
+				if (NiagaraSystem == nullptr)
+				{
+					continue;
+				}
+
+				if (!bRecentlyRendered || !bInVFXRange || !HasConcurrencyBudget(Effect))
+				{
+					++NumAvoided;
+					continue;
+				}
+
+				// Spawn Niagara Systems Attached from the world's FX pool, add Niagara Component to List of NCs
 				UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem, AttachToComponent, AttachPoint, LocationOffset,
-					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::None, true, true);
+					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::AutoRelease, true, true);
+				if (NiagaraComponent)
+				{
+					TrackConcurrentEffect(Effect, NiagaraComponent);
+				}
 
 				NiagaraOut.Add(NiagaraComponent);
 			}
+
+			RecordAvoidedSpawns(NumAvoided);
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::GatherViewers(TArray<FEffectViewer, TInlineAllocator<4>>& OutViewers) const
+{
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FEffectViewer& Viewer = OutViewers.AddDefaulted_GetRef();
+
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(/*out*/ Viewer.ViewLocation, /*out*/ ViewRotation);
+
+			FVector ListenerFront;
+			FVector ListenerRight;
+			PlayerController->GetAudioListenerPosition(/*out*/ Viewer.ListenerLocation, /*out*/ ListenerFront, /*out*/ ListenerRight);
 		}
 	}
 }
 
+bool ULyraContextEffectsSubsystem::IsOwnerInsignificant(const AActor* OwningActor) const
+{
+	if (OwningActor)
+	{
+		if (const USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+		{
+			// Only objects registered with the manager have a meaningful significance
+			if (const USignificanceManager::FManagedObjectInfo* ManagedObjectInfo = SignificanceManager->GetManagedObject(const_cast<AActor*>(OwningActor)))
+			{
+				return ManagedObjectInfo->GetSignificance() <= 0.0f;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool ULyraContextEffectsSubsystem::HasConcurrencyBudget(FGameplayTag Effect)
+{
+	const int32 MaxConcurrent = LyraConsoleVariables::ContextEffectsMaxConcurrentPerEffect;
+	if (MaxConcurrent <= 0)
+	{
+		return true;
+	}
+
+	TArray<TWeakObjectPtr<USceneComponent>>* PlayingComponents = ConcurrentEffects.Find(Effect);
+	if (PlayingComponents == nullptr)
+	{
+		return true;
+	}
+
+	if (PlayingComponents->Num() >= MaxConcurrent)
+	{
+		// Forget about effects that have finished (pooled components may already be playing something else, that's fine for a budget)
+		PlayingComponents->RemoveAllSwap([](const TWeakObjectPtr<USceneComponent>& WeakComponent)
+		{
+			const USceneComponent* Component = WeakComponent.Get();
+			if (const UAudioComponent* AudioComponent = Cast<UAudioComponent>(Component))
+			{
+				return !AudioComponent->IsPlaying();
+			}
+			return (Component == nullptr) || !Component->IsActive();
+		}, EAllowShrinking::No);
+	}
+
+	return PlayingComponents->Num() < MaxConcurrent;
+}
+
+void ULyraContextEffectsSubsystem::TrackConcurrentEffect(FGameplayTag Effect, USceneComponent* EffectComponent)
+{
+	if (LyraConsoleVariables::ContextEffectsMaxConcurrentPerEffect > 0)
+	{
+		ConcurrentEffects.FindOrAdd(Effect).Add(EffectComponent);
+	}
+}
+
+UAudioComponent* ULyraContextEffectsSubsystem::SpawnPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPoint,
+	const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch)
+{
+	UWorld* World = GetWorld();
+	AActor* PoolOwner = World ? World->GetWorldSettings() : nullptr;
+
+	// Looping sounds never finish on their own, so they would never come back to the pool
+	if ((LyraConsoleVariables::ContextEffectsMaxPooledAudioComponents <= 0) || (AttachToComponent == nullptr) || (PoolOwner == nullptr) || Sound->IsLooping())
+	{
+		return UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
+			false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+	}
+
+	UAudioComponent* AudioComponent = nullptr;
+	while ((AudioComponent == nullptr) && (FreeAudioComponents.Num() > 0))
+	{
+		AudioComponent = FreeAudioComponents.Pop(EAllowShrinking::No);
+		if (!IsValid(AudioComponent))
+		{
+			AudioComponent = nullptr;
+		}
+	}
+	SET_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents, FreeAudioComponents.Num());
+
+	if (AudioComponent == nullptr)
+	{
+		// Owned by the world settings so the component outlives whatever it gets attached to
+		AudioComponent = NewObject<UAudioComponent>(PoolOwner);
+		AudioComponent->bAutoActivate = false;
+		AudioComponent->bAutoDestroy = false;
+		AudioComponent->OnAudioFinishedNative.AddUObject(this, &ThisClass::HandlePooledAudioFinished);
+		AudioComponent->RegisterComponentWithWorld(World);
+	}
+
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::KeepRelativeTransform, AttachPoint);
+	AudioComponent->SetRelativeLocationAndRotation(LocationOffset, RotationOffset);
+	AudioComponent->SetSound(Sound);
+	AudioComponent->SetVolumeMultiplier(AudioVolume);
+	AudioComponent->SetPitchMultiplier(AudioPitch);
+	AudioComponent->Play();
+
+	return AudioComponent;
+}
+
+bool ULyraContextEffectsSubsystem::IsPooledEffectComponent(const USceneComponent* EffectComponent) const
+{
+	if (const UNiagaraComponent* NiagaraComponent = Cast<UNiagaraComponent>(EffectComponent))
+	{
+		return NiagaraComponent->PoolingMethod != ENCPoolMethod::None;
+	}
+
+	// Pooled audio components are owned by the world settings (see SpawnPooledSound)
+	const UWorld* World = GetWorld();
+	return (EffectComponent != nullptr) && (World != nullptr) && (EffectComponent->GetOuter() == World->GetWorldSettings());
+}
+
+void ULyraContextEffectsSubsystem::HandlePooledAudioFinished(UAudioComponent* AudioComponent)
+{
+	if (!IsValid(AudioComponent))
+	{
+		return;
+	}
+
+	AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+
+	if (FreeAudioComponents.Num() < LyraConsoleVariables::ContextEffectsMaxPooledAudioComponents)
+	{
+		FreeAudioComponents.Add(AudioComponent);
+	}
+	else
+	{
+		AudioComponent->DestroyComponent();
+	}
+	SET_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents, FreeAudioComponents.Num());
+}
+
+void ULyraContextEffectsSubsystem::RecordAvoidedSpawns(int32 NumAvoided)
+{
+	INC_DWORD_STAT_BY(STAT_LyraContextEffects_SpawnsAvoided, NumAvoided);
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	AvoidedSpawnsInWindow += NumAvoided;
+
+	// Publish a rolling per second count
+	if (CurrentTime - AvoidedSpawnsWindowStart >= 1.0)
+	{
+		SpawnsAvoidedPerSecond = FMath::RoundToInt(AvoidedSpawnsInWindow / (CurrentTime - AvoidedSpawnsWindowStart));
+		AvoidedSpawnsWindowStart = CurrentTime;
+		AvoidedSpawnsInWindow = 0;
+
+		SET_DWORD_STAT(STAT_LyraContextEffects_SpawnsAvoidedPerSecond, SpawnsAvoidedPerSecond);
+	}
+}
+
 bool ULyraContextEffectsSubsystem::GetContextFromSurfaceType(
 	TEnumAsByte<EPhysicalSurface> PhysicalSurface, FGameplayTag& Context)
 {
@@ -146,5 +463,244 @@ void ULyraContextEffectsSubsystem::UnloadAndRemoveContextEffectsLibraries(AActor
 
 	// Remove ref from Active Actor/Effects Set Map
 	ActiveActorEffectsMap.Remove(OwningActor);
+	ImplementersCache.Remove(OwningActor);
+}
+
+bool ULyraContextEffectsSubsystem::ShouldBatchSurfaceTraces() const
+{
+	return LyraConsoleVariables::bContextEffectsAsyncSurfaceTraces;
+}
+
+void ULyraContextEffectsSubsystem::QueueSurfaceTrace(const FLyraContextEffectNotifyParams& Params)
+{
+	FQueuedSurfaceTrace& QueuedTrace = QueuedSurfaceTraces.AddDefaulted_GetRef();
+	QueuedTrace.Params = Params;
+	QueuedTrace.QueuedFrame = GFrameCounter;
+
+	IssueQueuedSurfaceTraces();
+}
+
+void ULyraContextEffectsSubsystem::IssueQueuedSurfaceTraces()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		QueuedSurfaceTraces.Reset();
+		return;
+	}
+
+	if (SurfaceTraceBudgetFrame != GFrameCounter)
+	{
+		SurfaceTraceBudgetFrame = GFrameCounter;
+		SurfaceTracesIssuedThisFrame = 0;
+	}
+
+	if (!SurfaceTraceDelegate.IsBound())
+	{
+		SurfaceTraceDelegate.BindUObject(this, &ThisClass::HandleSurfaceTraceDone);
+	}
+
+	const int32 MaxTracesPerFrame = FMath::Max(LyraConsoleVariables::ContextEffectsMaxSurfaceTracesPerFrame, 1);
+	int32 NumProcessed = 0;
+
+	for (; NumProcessed < QueuedSurfaceTraces.Num(); ++NumProcessed)
+	{
+		const FQueuedSurfaceTrace& QueuedTrace = QueuedSurfaceTraces[NumProcessed];
+		const FLyraContextEffectNotifyParams& Params = QueuedTrace.Params;
+
+		USkeletalMeshComponent* MeshComponent = Params.MeshComponent.Get();
+		if (MeshComponent == nullptr)
+		{
+			continue;
+		}
+
+		if (SurfaceTracesIssuedThisFrame >= MaxTracesPerFrame)
+		{
+			// Out of budget, requests that have waited too long play without a surface, the rest try again next frame
+			if (GFrameCounter - QueuedTrace.QueuedFrame < (uint64)FMath::Max(LyraConsoleVariables::ContextEffectsMaxSurfaceTraceWaitFrames, 0))
+			{
+				break;
+			}
+
+			DispatchAnimMotionEffect(this, Params, false, FHitResult(Params.TraceStart, Params.TraceEnd));
+			continue;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraContextEffectsSurfaceTrace), /*bTraceComplex=*/ false);
+		QueryParams.bReturnPhysicalMaterial = true;
+		if (Params.bIgnoreOwningActor)
+		{
+			QueryParams.AddIgnoredActor(MeshComponent->GetOwner());
+		}
+
+		const uint32 TraceId = ++NextSurfaceTraceId;
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Params.TraceStart, Params.TraceEnd, Params.TraceChannel,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &SurfaceTraceDelegate, TraceId);
+
+		PendingSurfaceTraces.Add(TraceId, Params);
+		++SurfaceTracesIssuedThisFrame;
+	}
+
+	QueuedSurfaceTraces.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+
+	if ((QueuedSurfaceTraces.Num() > 0) && !bSurfaceTraceFlushScheduled)
+	{
+		bSurfaceTraceFlushScheduled = true;
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]()
+		{
+			// Only the scheduled flush clears the flag, so notifies arriving over budget meanwhile don't schedule more flushes
+			bSurfaceTraceFlushScheduled = false;
+			IssueQueuedSurfaceTraces();
+		}));
+	}
+}
+
+void ULyraContextEffectsSubsystem::HandleSurfaceTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FLyraContextEffectNotifyParams Params;
+	if (!PendingSurfaceTraces.RemoveAndCopyValue(TraceDatum.UserData, /*out*/ Params))
+	{
+		return;
+	}
+
+	const FHitResult* BlockingHit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (BlockingHit)
+	{
+		DispatchAnimMotionEffect(this, Params, true, *BlockingHit);
+	}
+	else
+	{
+		DispatchAnimMotionEffect(this, Params, false, FHitResult(Params.TraceStart, Params.TraceEnd));
+	}
+}
+
+void ULyraContextEffectsSubsystem::DispatchAnimMotionEffect(ULyraContextEffectsSubsystem* Subsystem, const FLyraContextEffectNotifyParams& Params, bool bHitSuccess, const FHitResult& HitResult)
+{
+	USkeletalMeshComponent* MeshComponent = Params.MeshComponent.Get();
+	AActor* OwningActor = MeshComponent ? MeshComponent->GetOwner() : nullptr;
+	if (OwningActor == nullptr)
+	{
+		return;
+	}
+
+	// Set up Array of Objects that implement the Context Effects Interface
+	TArray<UObject*, TInlineAllocator<4>> LyraContextEffectImplementingObjects;
+	if (Subsystem)
+	{
+		Subsystem->GetContextEffectImplementers(OwningActor, LyraContextEffectImplementingObjects);
+	}
+	else
+	{
+		// No subsystem to cache in (e.g. in preview worlds), find them directly
+		if (OwningActor->Implements<ULyraContextEffectsInterface>())
+		{
+			LyraContextEffectImplementingObjects.Add(OwningActor);
+		}
+
+		for (UActorComponent* Component : OwningActor->GetComponents())
+		{
+			if (Component && Component->Implements<ULyraContextEffectsInterface>())
+			{
+				LyraContextEffectImplementingObjects.Add(Component);
+			}
+		}
+	}
+
+	// Prepare Contexts in advance
+	FGameplayTagContainer Contexts;
+
+	// Cycle through all objects implementing the Context Effect Interface
+	for (UObject* LyraContextEffectImplementingObject : LyraContextEffectImplementingObjects)
+	{
+		if (IsValid(LyraContextEffectImplementingObject))
+		{
+			// If the object is still valid, Execute the AnimMotionEffect Event on it, passing in relevant data
+			ILyraContextEffectsInterface::Execute_AnimMotionEffect(LyraContextEffectImplementingObject,
+				Params.Bone, Params.Effect, MeshComponent, Params.LocationOffset, Params.RotationOffset,
+				Params.Animation.Get(), bHitSuccess, HitResult, Contexts, Params.VFXScale,
+				Params.AudioVolume, Params.AudioPitch);
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::GetContextEffectImplementers(AActor* Actor, TArray<UObject*, TInlineAllocator<4>>& OutImplementers)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	FCachedImplementers* CachedImplementers = ImplementersCache.Find(Actor);
+	if (CachedImplementers == nullptr)
+	{
+		PruneImplementersCache();
+		CachedImplementers = &ImplementersCache.Add(Actor);
+	}
+
+	const int32 NumComponents = Actor->GetComponents().Num();
+	bool bNeedsRebuild = (CachedImplementers->NumComponents != NumComponents);
+
+	if (!bNeedsRebuild)
+	{
+		for (const TWeakObjectPtr<UObject>& WeakObject : CachedImplementers->Objects)
+		{
+			if (UObject* Object = WeakObject.Get())
+			{
+				OutImplementers.Add(Object);
+			}
+			else
+			{
+				// A component went away without the count changing
+				bNeedsRebuild = true;
+				break;
+			}
+		}
+	}
+
+	if (bNeedsRebuild)
+	{
+		OutImplementers.Reset();
+		CachedImplementers->Objects.Reset();
+		CachedImplementers->NumComponents = NumComponents;
+
+		// Determine if the Owning Actor is one of the Objects that implements the Context Effects Interface
+		if (Actor->Implements<ULyraContextEffectsInterface>())
+		{
+			CachedImplementers->Objects.Add(Actor);
+			OutImplementers.Add(Actor);
+		}
+
+		// Cycle through Owning Actor's Components and determine if any of them is a Component implementing the Context Effect Interface
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component && Component->Implements<ULyraContextEffectsInterface>())
+			{
+				CachedImplementers->Objects.Add(Component);
+				OutImplementers.Add(Component);
+			}
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::InvalidateContextEffectImplementers(const AActor* Actor)
+{
+	ImplementersCache.Remove(Actor);
+}
+
+void ULyraContextEffectsSubsystem::PruneImplementersCache()
+{
+	// Forget destroyed actors once in a while, actors with a context effect component are removed as soon as they end play
+	if (ImplementersCache.Num() >= ImplementersCachePruneThreshold)
+	{
+		for (auto It = ImplementersCache.CreateIterator(); It; ++It)
+		{
+			if (It.Key().ResolveObjectPtr() == nullptr)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		ImplementersCachePruneThreshold = FMath::Max(64, ImplementersCache.Num() * 2);
+	}
 }
 
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "Engine/DeveloperSettings.h"
+#include "Engine/EngineTypes.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
 
 #include "LyraContextEffectsSubsystem.generated.h"
 
@@ -15,11 +18,35 @@ enum EPhysicalSurface : int;
 class AActor;
 class UAudioComponent;
 class ULyraContextEffectsLibrary;
+class UAnimSequenceBase;
 class UNiagaraComponent;
 class USceneComponent;
+class USkeletalMeshComponent;
+class USoundBase;
 struct FFrame;
 struct FGameplayTag;
 struct FGameplayTagContainer;
+struct FHitResult;
+
+/** Everything an anim notify needs to hand an effect over to the context effect implementers of its actor */
+struct FLyraContextEffectNotifyParams
+{
+	TWeakObjectPtr<USkeletalMeshComponent> MeshComponent;
+	TWeakObjectPtr<const UAnimSequenceBase> Animation;
+	FGameplayTag Effect;
+	FName Bone;
+	FVector LocationOffset = FVector::ZeroVector;
+	FRotator RotationOffset = FRotator::ZeroRotator;
+	FVector VFXScale = FVector(1.0);
+	float AudioVolume = 1.0f;
+	float AudioPitch = 1.0f;
+
+	// Surface trace, only used when the notify wants to know what it is standing on
+	FVector TraceStart = FVector::ZeroVector;
+	FVector TraceEnd = FVector::ZeroVector;
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+	bool bIgnoreOwningActor = true;
+};
 
 /**
  *
@@ -50,7 +77,12 @@ public:
 
 
 /**
- * 
+ * Spawns context effects (footsteps, impacts, ...) for actors with registered effect libraries.
+ *
+ * Effects that nobody can see or hear are culled before any component is created, each effect tag
+ * has a cap on how many instances can play at once, and spawned components come from pools:
+ * Niagara systems use the world's auto-release FX pool and one-shot sounds reuse audio components
+ * owned by this subsystem.
  */
 UCLASS(MinimalAPI)
 class ULyraContextEffectsSubsystem : public UWorldSubsystem
@@ -58,6 +90,10 @@ class ULyraContextEffectsSubsystem : public UWorldSubsystem
 	GENERATED_BODY()
 	
 public:
+	//~USubsystem interface
+	UE_API virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
 	/** */
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	UE_API void SpawnContextEffects(
@@ -74,6 +110,9 @@ public:
 		, float AudioVolume = 1
 		, float AudioPitch = 1);
 
+	/** Returns true if the component belongs to a pool (pooled sounds and AutoRelease particles), owners must not hold on to those */
+	UE_API bool IsPooledEffectComponent(const USceneComponent* EffectComponent) const;
+
 	/** */
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	UE_API bool GetContextFromSurfaceType(TEnumAsByte<EPhysicalSurface> PhysicalSurface, FGameplayTag& Context);
@@ -86,11 +125,95 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	UE_API void UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor);
 
+	/** Returns how many effect spawns were culled or capped over the last second */
+	int32 GetSpawnsAvoidedPerSecond() const { return SpawnsAvoidedPerSecond; }
+
+	/**
+	 * Queues the surface trace of an anim notify into this frame's batch of async traces.
+	 * The effect is dispatched to the actor's context effect implementers once the trace resolves on the next frame.
+	 */
+	UE_API void QueueSurfaceTrace(const FLyraContextEffectNotifyParams& Params);
+
+	/** Returns true if anim notifies should use QueueSurfaceTrace rather than tracing immediately */
+	UE_API bool ShouldBatchSurfaceTraces() const;
+
+	/** Calls AnimMotionEffect on the owner of the notify's mesh and on all its components implementing ILyraContextEffectsInterface */
+	static UE_API void DispatchAnimMotionEffect(ULyraContextEffectsSubsystem* Subsystem, const FLyraContextEffectNotifyParams& Params, bool bHitSuccess, const FHitResult& HitResult);
+
+	/** Gets the actor and components implementing ILyraContextEffectsInterface, cached until the actor's components change */
+	UE_API void GetContextEffectImplementers(AActor* Actor, TArray<UObject*, TInlineAllocator<4>>& OutImplementers);
+
+	/** Forces the implementer list of an actor to be rebuilt on next use */
+	UE_API void InvalidateContextEffectImplementers(const AActor* Actor);
+
+private:
+	struct FQueuedSurfaceTrace
+	{
+		FLyraContextEffectNotifyParams Params;
+		uint64 QueuedFrame = 0;
+	};
+
+	struct FCachedImplementers
+	{
+		TArray<TWeakObjectPtr<UObject>, TInlineAllocator<4>> Objects;
+
+		// Component count of the actor when the list was built, a different count means components were added or removed
+		int32 NumComponents = INDEX_NONE;
+	};
+
+	void IssueQueuedSurfaceTraces();
+	void HandleSurfaceTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void PruneImplementersCache();
+
+	// Location and view of a local player, used to cull effects they would not notice
+	struct FEffectViewer
+	{
+		FVector ViewLocation;
+		FVector ListenerLocation;
+	};
+
+	void GatherViewers(TArray<FEffectViewer, TInlineAllocator<4>>& OutViewers) const;
+	bool IsOwnerInsignificant(const AActor* OwningActor) const;
+
+	// Returns true if another instance of Effect may start, forgetting instances that have finished
+	bool HasConcurrencyBudget(FGameplayTag Effect);
+	void TrackConcurrentEffect(FGameplayTag Effect, USceneComponent* EffectComponent);
+
+	UAudioComponent* SpawnPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPoint, const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch);
+	void HandlePooledAudioFinished(UAudioComponent* AudioComponent);
+
+	void RecordAvoidedSpawns(int32 NumAvoided);
+
 private:
 
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<AActor>, TObjectPtr<ULyraContextEffectsSet>> ActiveActorEffectsMap;
 
+	// Idle audio components ready to play a one-shot sound
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> FreeAudioComponents;
+
+	// Components currently playing, per effect tag
+	TMap<FGameplayTag, TArray<TWeakObjectPtr<USceneComponent>>> ConcurrentEffects;
+
+	// Surface traces waiting for budget, oldest first
+	TArray<FQueuedSurfaceTrace> QueuedSurfaceTraces;
+
+	// Surface traces in flight, keyed by the user data passed to the async trace
+	TMap<uint32, FLyraContextEffectNotifyParams> PendingSurfaceTraces;
+
+	FTraceDelegate SurfaceTraceDelegate;
+	uint32 NextSurfaceTraceId = 0;
+	uint64 SurfaceTraceBudgetFrame = 0;
+	int32 SurfaceTracesIssuedThisFrame = 0;
+	bool bSurfaceTraceFlushScheduled = false;
+
+	TMap<TObjectKey<AActor>, FCachedImplementers> ImplementersCache;
+	int32 ImplementersCachePruneThreshold = 64;
+
+	double AvoidedSpawnsWindowStart = 0.0;
+	int32 AvoidedSpawnsInWindow = 0;
+	int32 SpawnsAvoidedPerSecond = 0;
 };
 
 #undef UE_API
@@ -2,12 +2,16 @@
 
 #include "LyraNumberPopComponent_MeshText.h"
 
+#include "Algo/Reverse.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Containers/Ticker.h"
 #include "Engine/CollisionProfile.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Feedback/NumberPops/LyraNumberPopComponent.h"
 #include "LyraDamagePopStyle.h"
+#include "LyraLogChannels.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "TimerManager.h"
 #include "UObject/Package.h"
@@ -16,6 +20,114 @@
 
 class UStaticMesh;
 
+namespace LyraNumberPops
+{
+	// Whether we should show a sign as the first digit, and if so which one
+	// (if bIsSignNegative is true, we show minus, false is plus)
+	static constexpr bool bShouldShowSign = false;
+	static constexpr bool bIsSignNegative = true;
+
+	// Non-gameplay cameras while spectating have more cinematic values of aperture as default.
+	// This makes damage numbers very blurry as they are brought close to the camera, and away from the point of focus.
+	// Disable the shifting of numbers towards the camera here, if in a cinematic spectator camera.
+	//@TODO: Determine whether or not we are spectating
+	static constexpr bool bIsSpectating = false;
+
+#if !UE_BUILD_SHIPPING
+	struct FStressTest
+	{
+		TWeakObjectPtr<ULyraNumberPopComponent_MeshText> Component;
+		FTSTicker::FDelegateHandle TickerHandle;
+		float PopsPerSecond = 1000.0f;
+		double TimeRemaining = 0.0;
+		double PopsToSpawn = 0.0;
+		double TotalSeconds = 0.0;
+		double TotalAddSeconds = 0.0;
+		int64 TotalPops = 0;
+		int32 PeakLiveComponents = 0;
+		int32 PeakInstancedDigits = 0;
+	};
+	static FStressTest StressTest;
+
+	static bool TickStressTest(float DeltaTime)
+	{
+		ULyraNumberPopComponent_MeshText* Component = StressTest.Component.Get();
+		APlayerController* PC = Component ? Component->GetController<APlayerController>() : nullptr;
+		if (PC == nullptr)
+		{
+			UE_LOG(LogLyra, Warning, TEXT("lyra.NumberPops.StressTest: number pop component went away, stopping"));
+			StressTest.TickerHandle.Reset();
+			return false;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(/*out*/ ViewLocation, /*out*/ ViewRotation);
+
+		StressTest.PopsToSpawn += StressTest.PopsPerSecond * DeltaTime;
+		const int32 NumPopsThisFrame = FMath::FloorToInt(StressTest.PopsToSpawn);
+		StressTest.PopsToSpawn -= NumPopsThisFrame;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 PopIndex = 0; PopIndex < NumPopsThisFrame; ++PopIndex)
+		{
+			FLyraNumberPopRequest Request;
+			Request.WorldLocation = ViewLocation + ViewRotation.Vector() * FMath::FRandRange(300.0f, 3000.0f) + FMath::VRand() * 200.0f;
+			Request.NumberToDisplay = FMath::RandRange(1, 999);
+			Request.bIsCriticalDamage = FMath::FRand() < 0.1f;
+			Component->AddNumberPop(Request);
+		}
+		StressTest.TotalAddSeconds += FPlatformTime::Seconds() - StartTime;
+
+		StressTest.TotalPops += NumPopsThisFrame;
+		StressTest.TotalSeconds += DeltaTime;
+		StressTest.PeakLiveComponents = FMath::Max(StressTest.PeakLiveComponents, Component->GetNumLiveComponents());
+		StressTest.PeakInstancedDigits = FMath::Max(StressTest.PeakInstancedDigits, Component->GetNumInstancedDigits());
+
+		StressTest.TimeRemaining -= DeltaTime;
+		if (StressTest.TimeRemaining > 0.0)
+		{
+			return true;
+		}
+
+		UE_LOG(LogLyra, Display, TEXT("lyra.NumberPops.StressTest: %lld pops over %.1f s, %.3f ms of AddNumberPop per second (%.2f us per pop), peak %d live components, peak %d instanced digits"),
+			StressTest.TotalPops, StressTest.TotalSeconds,
+			(StressTest.TotalAddSeconds * 1000.0) / FMath::Max(StressTest.TotalSeconds, UE_DOUBLE_SMALL_NUMBER),
+			(StressTest.TotalAddSeconds * 1000000.0) / FMath::Max<int64>(StressTest.TotalPops, 1),
+			StressTest.PeakLiveComponents, StressTest.PeakInstancedDigits);
+
+		StressTest.TickerHandle.Reset();
+		return false;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdStressTest(
+		TEXT("lyra.NumberPops.StressTest"),
+		TEXT("Spawns synthetic number pops in front of the local player and reports the CPU time spent adding them (run with -nullrhi to exclude rendering). Usage: lyra.NumberPops.StressTest [PopsPerSecond=1000] [Seconds=10]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (StressTest.TickerHandle.IsValid())
+			{
+				FTSTicker::GetCoreTicker().RemoveTicker(StressTest.TickerHandle);
+				StressTest.TickerHandle.Reset();
+			}
+
+			APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+			ULyraNumberPopComponent_MeshText* Component = PC ? PC->FindComponentByClass<ULyraNumberPopComponent_MeshText>() : nullptr;
+			if (Component == nullptr)
+			{
+				UE_LOG(LogLyra, Warning, TEXT("lyra.NumberPops.StressTest: the local player controller has no mesh text number pop component"));
+				return;
+			}
+
+			StressTest = FStressTest();
+			StressTest.Component = Component;
+			StressTest.PopsPerSecond = (Args.Num() > 0) ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 1000.0f;
+			StressTest.TimeRemaining = (Args.Num() > 1) ? FMath::Max(FCString::Atof(*Args[1]), 0.1f) : 10.0f;
+			StressTest.TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickStressTest));
+		}));
+#endif // !UE_BUILD_SHIPPING
+}
+
 ULyraNumberPopComponent_MeshText::ULyraNumberPopComponent_MeshText(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -57,27 +169,16 @@ void ULyraNumberPopComponent_MeshText::AddNumberPop(const FLyraNumberPopRequest&
 	FTempNumberPopInfo PreparedNumberInfo;
 
 	// Prepare the DamageNumberArray with the digits from the damage.
-	{
-		int32 LocalDamage = NewRequest.NumberToDisplay;
-		PreparedNumberInfo.DamageNumberArray.Empty();
+	BuildDigitArray(NewRequest.NumberToDisplay, PreparedNumberInfo.DamageNumberArray);
 
-		if (LocalDamage == 0)
-		{
-			// We want to just show a zero
-			PreparedNumberInfo.DamageNumberArray.Insert(0, 0);
-		}
-		else
-		{
-			// Parse the base10 number into an array
-			while (LocalDamage > 0)
-			{
-				PreparedNumberInfo.DamageNumberArray.Insert(LocalDamage % 10, 0);
-				LocalDamage /= 10;
-			}
-		}
+	if (bUseInstancedRendering)
+	{
+		FTransform CameraTransform;
+		FVector NumberLocation;
+		DetermineNumberTransform(NewRequest, CameraTransform, NumberLocation);
 
-		// Insert a zero to reserve space for + or -. Used by the blueprint
-		PreparedNumberInfo.DamageNumberArray.Insert(0, 0);
+		AddInstancedNumberPop(NewRequest, PreparedNumberInfo.DamageNumberArray, CameraTransform, NumberLocation);
+		return;
 	}
 
 	// Grab a component from the pool for this number or create one
@@ -143,25 +244,208 @@ void ULyraNumberPopComponent_MeshText::AddNumberPop(const FLyraNumberPopRequest&
 
 	// Determine the position
 	FTransform CameraTransform;
-	FVector NumberLocation(NewRequest.WorldLocation);
+	FVector NumberLocation;
+	DetermineNumberTransform(NewRequest, CameraTransform, NumberLocation);
+	PreparedNumberInfo.StaticMeshComponent->SetWorldTransform(FTransform(CameraTransform.GetRotation(), NumberLocation));
+
+	// Now apply the material parameters to make the digits, etc...
+	SetMaterialParameters(NewRequest, PreparedNumberInfo, CameraTransform, NumberLocation);
+}
+
+void ULyraNumberPopComponent_MeshText::DetermineNumberTransform(const FLyraNumberPopRequest& Request, FTransform& OutCameraTransform, FVector& OutNumberLocation) const
+{
+	OutCameraTransform = FTransform::Identity;
+	OutNumberLocation = Request.WorldLocation;
 	if (APlayerController* PC = GetController<APlayerController>())
 	{
 		if (APlayerCameraManager* PlayerCameraManager = PC->PlayerCameraManager)
 		{
-			CameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
+			OutCameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
 
 			FVector LocationOffset(ForceInitToZero);
 
 			const float RandomMagnitude = 5.0f; //@TODO: Make this style driven
 			LocationOffset += FMath::RandPointInBox(FBox(FVector(-RandomMagnitude), FVector(RandomMagnitude)));
 
-			NumberLocation += LocationOffset;
+			OutNumberLocation += LocationOffset;
 		}
 	}
-	PreparedNumberInfo.StaticMeshComponent->SetWorldTransform(FTransform(CameraTransform.GetRotation(), NumberLocation));
+}
 
-	// Now apply the material parameters to make the digits, etc...
-	SetMaterialParameters(NewRequest, PreparedNumberInfo, CameraTransform, NumberLocation);
+void ULyraNumberPopComponent_MeshText::BuildDigitArray(int32 Number, FNumberPopDigitArray& OutDigits)
+{
+	OutDigits.Reset();
+
+	if (Number == 0)
+	{
+		// We want to just show a zero
+		OutDigits.Add(0);
+	}
+	else
+	{
+		// Parse the base10 number into an array, least significant digit first
+		while (Number > 0)
+		{
+			OutDigits.Add(Number % 10);
+			Number /= 10;
+		}
+	}
+
+	// Reserve space for + or -. Used by the blueprint
+	OutDigits.Add(0);
+
+	Algo::Reverse(OutDigits);
+}
+
+void ULyraNumberPopComponent_MeshText::LayoutDigits(const FLyraNumberPopRequest& Request, const FNumberPopDigitArray& Digits, const FTransform& CameraTransform, const FVector& NumberLocation, int32 NumSlots, TArray<FNumberPopDigitLayout, TInlineAllocator<12>>& OutLayout) const
+{
+	const int32 DamageNumberArrayLength = Digits.Num();
+	float OffsetAccumulatedValue = (DamageNumberArrayLength * -1.f) + (LyraNumberPops::bShouldShowSign ? 0.f : -1.f);
+
+	const float DistanceFromCameraToNumber = (CameraTransform.GetLocation() - NumberLocation).Size();
+	const float DistanceSpriteScale = DistanceFromCameraBeforeDoublingSize == 0.f ? 1.f : FMath::Clamp(DistanceFromCameraToNumber / DistanceFromCameraBeforeDoublingSize, 1.f, 1000000000.f);
+	const float HitSizeMultiplier = Request.bIsCriticalDamage ? CriticalHitSizeMultiplier : 1.f;
+
+	OutLayout.Reset();
+	for (int32 NumberIndex = 0; NumberIndex < NumSlots; ++NumberIndex)
+	{
+		FNumberPopDigitLayout& Layout = OutLayout.AddDefaulted_GetRef();
+
+		const float NumberYOffset = ((NumberIndex / FMath::Max(1, DamageNumberArrayLength - 1)) - 0.5f) * 2.f;
+		const FVector NumberOffset = FVector(0.f, NumberYOffset, 0.f);
+		Layout.CameraSpaceDirection = CameraTransform.TransformVectorNoScale(NumberOffset);
+
+		const float SpacingForNumber = ((NumberIndex < DamageNumberArrayLength) && ((Digits[NumberIndex] == 1) || ((NumberIndex > 0) && (Digits[NumberIndex - 1] == 1)))) ? SpacingPercentageForOnes : 1.f;
+		OffsetAccumulatedValue += SpacingForNumber;
+		Layout.Offset = OffsetAccumulatedValue;
+
+		const float ScaleToZeroMultiplier = (NumberIndex < DamageNumberArrayLength) && (((NumberIndex == 0) && LyraNumberPops::bShouldShowSign) || (NumberIndex != 0)) ? 1.f : 0.f;
+		const float FontSizeMultiplier = HitSizeMultiplier * DistanceSpriteScale * ScaleToZeroMultiplier;
+
+		Layout.ScaleX = FontXSize * FontSizeMultiplier;
+		Layout.ScaleY = FontYSize * FontSizeMultiplier;
+		Layout.Digit = Digits[FMath::Min(DamageNumberArrayLength - 1, NumberIndex)];
+		Layout.Rotation = FMath::Sign(Layout.CameraSpaceDirection.X) * NumberOfNumberRotations;
+	}
+}
+
+void ULyraNumberPopComponent_MeshText::AddInstancedNumberPop(const FLyraNumberPopRequest& Request, const FNumberPopDigitArray& Digits, const FTransform& CameraTransform, const FVector& NumberLocation)
+{
+	UStaticMesh* MeshToUse = DetermineStaticMesh(Request);
+	UWorld* LocalWorld = GetWorld();
+	if ((MeshToUse == nullptr) || (LocalWorld == nullptr))
+	{
+		return;
+	}
+
+	FInstancedNumberPopMesh& InstancedMesh = InstancedMeshMap.FindOrAdd(MeshToUse);
+	if (InstancedMesh.Component == nullptr)
+	{
+		InstancedMesh.Component = CreateInstancedDigitComponent(MeshToUse);
+	}
+	UInstancedStaticMeshComponent* Component = InstancedMesh.Component;
+
+	const float CurrentTime = LocalWorld->GetTimeSeconds();
+
+	TArray<FNumberPopDigitLayout, TInlineAllocator<12>> Layout;
+	LayoutDigits(Request, Digits, CameraTransform, NumberLocation, Digits.Num(), Layout);
+
+	const float RealGameTime = LocalWorld->GetRealTimeSeconds();
+	const FLinearColor Color = DetermineColor(Request);
+	const FTransform InstanceTransform(CameraTransform.GetRotation(), NumberLocation);
+
+	float CustomData[LyraNumberPopCustomData::Num];
+	CustomData[LyraNumberPopCustomData::ColorR] = Color.R;
+	CustomData[LyraNumberPopCustomData::ColorG] = Color.G;
+	CustomData[LyraNumberPopCustomData::ColorB] = Color.B;
+	CustomData[LyraNumberPopCustomData::SpawnTime] = RealGameTime;
+	CustomData[LyraNumberPopCustomData::Lifespan] = ComponentLifespan;
+	CustomData[LyraNumberPopCustomData::IsCriticalHit] = Request.bIsCriticalDamage ? 1.f : 0.f;
+	CustomData[LyraNumberPopCustomData::MoveToCamera] = LyraNumberPops::bIsSpectating ? 0.0f : 1.0f;
+
+	for (const FNumberPopDigitLayout& DigitLayout : Layout)
+	{
+		if (DigitLayout.ScaleX <= 0.0f)
+		{
+			// Hidden slot (e.g., the sign), no need for an instance
+			continue;
+		}
+
+		CustomData[LyraNumberPopCustomData::Digit] = DigitLayout.Digit;
+		CustomData[LyraNumberPopCustomData::Offset] = DigitLayout.Offset;
+		CustomData[LyraNumberPopCustomData::DirectionX] = DigitLayout.CameraSpaceDirection.X;
+		CustomData[LyraNumberPopCustomData::DirectionY] = DigitLayout.CameraSpaceDirection.Y;
+		CustomData[LyraNumberPopCustomData::DirectionZ] = DigitLayout.CameraSpaceDirection.Z;
+		CustomData[LyraNumberPopCustomData::ScaleX] = DigitLayout.ScaleX;
+		CustomData[LyraNumberPopCustomData::ScaleY] = DigitLayout.ScaleY;
+		CustomData[LyraNumberPopCustomData::Rotation] = DigitLayout.Rotation;
+		CustomData[LyraNumberPopCustomData::RandomSeed] = FMath::FRand();
+
+		// Reuse an instance whose animation is over, otherwise grow
+		int32 InstanceIndex = INDEX_NONE;
+		if (InstancedMesh.FreeInstances.Num() > 0)
+		{
+			InstanceIndex = InstancedMesh.FreeInstances.Pop(EAllowShrinking::No);
+			Component->UpdateInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false);
+		}
+		else
+		{
+			InstanceIndex = Component->AddInstance(InstanceTransform, /*bWorldSpace=*/ true);
+		}
+
+		InstancedMesh.LiveInstances.Add({ CurrentTime + ComponentLifespan, InstanceIndex });
+		Component->SetCustomData(InstanceIndex, MakeArrayView(CustomData, LyraNumberPopCustomData::Num), /*bMarkRenderStateDirty=*/ false);
+	}
+
+	Component->MarkRenderStateDirty();
+
+	// Start the timer if it wasn't already running
+	if (!LocalWorld->GetTimerManager().IsTimerActive(InstanceReleaseTimerHandle))
+	{
+		LocalWorld->GetTimerManager().SetTimer(InstanceReleaseTimerHandle, this, &ThisClass::ReleaseNextInstances, ComponentLifespan);
+	}
+}
+
+UInstancedStaticMeshComponent* ULyraNumberPopComponent_MeshText::CreateInstancedDigitComponent(UStaticMesh* DigitMesh)
+{
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+	Component->SetupAttachment(nullptr);
+	Component->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	Component->SetStaticMesh(DigitMesh);
+	Component->SetCastShadow(false);
+	Component->NumCustomDataFloats = LyraNumberPopCustomData::Num;
+
+	if (InstancedDigitMaterial)
+	{
+		for (int32 MatIdx = 0; MatIdx < Component->GetNumMaterials(); ++MatIdx)
+		{
+			Component->SetMaterial(MatIdx, InstancedDigitMaterial);
+		}
+	}
+
+	// Used to allow post-processes to opt out of affecting the number pop digits
+	Component->SetRenderCustomDepth(true);
+	Component->SetCustomDepthStencilValue(123);
+
+	// The digits travel a great distance from their original bounds due to
+	// world position offset (WPO) animation in the material, so expand bounds
+	Component->SetBoundsScale(2000.0f);
+
+	Component->RegisterComponent();
+	return Component;
+}
+
+int32 ULyraNumberPopComponent_MeshText::GetNumInstancedDigits() const
+{
+	int32 NumInstances = 0;
+	for (const TPair<TObjectPtr<UStaticMesh>, FInstancedNumberPopMesh>& Pair : InstancedMeshMap)
+	{
+		if (Pair.Value.Component)
+		{
+			NumInstances += Pair.Value.Component->GetInstanceCount();
+		}
+	}
+	return NumInstances;
 }
 
 void ULyraNumberPopComponent_MeshText::ReleaseNextComponents()
@@ -212,6 +496,62 @@ void ULyraNumberPopComponent_MeshText::ReleaseNextComponents()
 	}
 }
 
+void ULyraNumberPopComponent_MeshText::ReleaseNextInstances()
+{
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	const float CurrentTime = LocalWorld->GetTimeSeconds();
+
+	float NextReleaseTime = TNumericLimits<float>::Max();
+	for (TPair<TObjectPtr<UStaticMesh>, FInstancedNumberPopMesh>& Pair : InstancedMeshMap)
+	{
+		FInstancedNumberPopMesh& InstancedMesh = Pair.Value;
+		UInstancedStaticMeshComponent* Component = InstancedMesh.Component;
+
+		// Instances are added in chronological order, so the finished ones are all at the front
+		int32 NumReleased = 0;
+		for (int32 LiveIndex = InstancedMesh.FirstLiveInstance; LiveIndex < InstancedMesh.LiveInstances.Num(); ++LiveIndex, ++NumReleased)
+		{
+			const FLiveNumberPopInstance& LiveInstance = InstancedMesh.LiveInstances[LiveIndex];
+			if (CurrentTime < LiveInstance.ReleaseTime)
+			{
+				NextReleaseTime = FMath::Min(NextReleaseTime, LiveInstance.ReleaseTime);
+				break;
+			}
+
+			// Scale the instance to nothing so its last digit doesn't stay on screen until it is reused
+			if (Component)
+			{
+				FTransform InstanceTransform;
+				Component->GetInstanceTransform(LiveInstance.InstanceIndex, InstanceTransform, /*bWorldSpace=*/ true);
+				InstanceTransform.SetScale3D(FVector::ZeroVector);
+				Component->UpdateInstanceTransform(LiveInstance.InstanceIndex, InstanceTransform, /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false);
+			}
+			InstancedMesh.FreeInstances.Add(LiveInstance.InstanceIndex);
+		}
+		InstancedMesh.FirstLiveInstance += NumReleased;
+
+		// Compact the live list once most of it has been consumed, rather than shifting it on every release
+		if (InstancedMesh.FirstLiveInstance > (InstancedMesh.LiveInstances.Num() / 2))
+		{
+			InstancedMesh.LiveInstances.RemoveAt(0, InstancedMesh.FirstLiveInstance, EAllowShrinking::No);
+			InstancedMesh.FirstLiveInstance = 0;
+		}
+
+		if ((NumReleased > 0) && Component)
+		{
+			Component->MarkRenderStateDirty();
+		}
+	}
+
+	// If we still have instances animating, set the timer to release the next one
+	if (NextReleaseTime < TNumericLimits<float>::Max())
+	{
+		LocalWorld->GetTimerManager().SetTimer(InstanceReleaseTimerHandle, this, &ThisClass::ReleaseNextInstances, FMath::Max(NextReleaseTime - CurrentTime, UE_KINDA_SMALL_NUMBER));
+	}
+}
+
 FLinearColor ULyraNumberPopComponent_MeshText::DetermineColor(const FLyraNumberPopRequest& Request) const
 {
 	for (ULyraDamagePopStyle* Style : Styles)
@@ -251,67 +591,52 @@ void ULyraNumberPopComponent_MeshText::SetMaterialParameters(const FLyraNumberPo
 	{
 		const float RealGameTime = World->GetRealTimeSeconds();
 
-		// Whether we should show a sign as the first digit, and if so which one
-		// (if bIsSignNegative is true, we show minus, false is plus)
-		const bool bShouldShowSign = false;
-		const bool bIsSignNegative = true;
-
-		for (UMaterialInstanceDynamic* MeshMID : NewDamageNumberInfo.MeshMIDs)
+		// IF the damage number has more digits than we support
+		// THEN force the damage number to the highest number we can support
+		const int32 MaxSupportedDigits = FMath::Min(FMath::Min(PositionParameterNames.Num(), ScaleRotationAngleParameterNames.Num()), DurationParameterNames.Num());
+		if (!ensure(NewDamageNumberInfo.DamageNumberArray.Num() <= MaxSupportedDigits))
 		{
-			MeshMID->SetScalarParameterValue(SignDigitParameterName, bIsSignNegative ? 0.5f : 0.0f);
-			MeshMID->SetVectorParameterValue(ColorParameterName, DetermineColor(Request));
+			NewDamageNumberInfo.DamageNumberArray.SetNum(MaxSupportedDigits);
 
-			// IF the damage number has more digits than we support
-			// THEN force the damage number to the highest number we can support
-			const int32 MaxSupportedDigits = FMath::Min(FMath::Min(PositionParameterNames.Num(), ScaleRotationAngleParameterNames.Num()), DurationParameterNames.Num());
-			if (!ensure(NewDamageNumberInfo.DamageNumberArray.Num() <= MaxSupportedDigits))
+			// Set all number digits to 9 so we show the largest number we can
+			// Skip digit 0 because that digit is for the +/- sign
+			for (int32 DigitIndex = 1; DigitIndex < NewDamageNumberInfo.DamageNumberArray.Num(); ++DigitIndex)
 			{
-				NewDamageNumberInfo.DamageNumberArray.SetNum(MaxSupportedDigits);
-
-				// Set all number digits to 9 so we show the largest number we can
-				// Skip digit 0 because that digit is for the +/- sign
-				for (int32 DigitIndex = 1; DigitIndex < NewDamageNumberInfo.DamageNumberArray.Num(); ++DigitIndex)
-				{
-					NewDamageNumberInfo.DamageNumberArray[DigitIndex] = 9;
-				}
+				NewDamageNumberInfo.DamageNumberArray[DigitIndex] = 9;
 			}
+		}
 
-			MeshMID->SetScalarParameterValue(AnimationLifespanParameterName, ComponentLifespan);
-			MeshMID->SetScalarParameterValue(IsCriticalHitParameterName, Request.bIsCriticalDamage ? 1.f : 0.f);
+		const int32 DamageNumberArrayLength = NewDamageNumberInfo.DamageNumberArray.Num();
+		const int32 LastIndex = (DamageNumberArrayLength >= 4) ? DamageNumberArrayLength : 4;
+
+		TArray<FNumberPopDigitLayout, TInlineAllocator<12>> Layout;
+		LayoutDigits(Request, NewDamageNumberInfo.DamageNumberArray, CameraTransform, NumberLocation, LastIndex, Layout);
 
-			const int32 DamageNumberArrayLength = NewDamageNumberInfo.DamageNumberArray.Num();
-			float OffsetAccumulatedValue = (DamageNumberArrayLength * -1.f) + (bShouldShowSign ? 0.f : -1.f);
+		const FLinearColor Color = DetermineColor(Request);
 
-			const int32 LastIndex = (DamageNumberArrayLength >= 4) ? DamageNumberArrayLength : 4;
+		for (UMaterialInstanceDynamic* MeshMID : NewDamageNumberInfo.MeshMIDs)
+		{
+			MeshMID->SetScalarParameterValue(SignDigitParameterName, LyraNumberPops::bIsSignNegative ? 0.5f : 0.0f);
+			MeshMID->SetVectorParameterValue(ColorParameterName, Color);
+
+			MeshMID->SetScalarParameterValue(AnimationLifespanParameterName, ComponentLifespan);
+			MeshMID->SetScalarParameterValue(IsCriticalHitParameterName, Request.bIsCriticalDamage ? 1.f : 0.f);
 
 			for (int32 NumberIndex = 0; NumberIndex < LastIndex; ++NumberIndex)
 			{
-				const float NumberYOffset = ((NumberIndex / FMath::Max(1, DamageNumberArrayLength - 1)) - 0.5f) * 2.f;
-				const FVector NumberOffset = FVector(0.f, NumberYOffset, 0.f);
-				const FVector CameraSpaceDirection = CameraTransform.TransformVectorNoScale(NumberOffset);
+				const FNumberPopDigitLayout& DigitLayout = Layout[NumberIndex];
 
-				const float SpacingForNumber = ((NumberIndex < DamageNumberArrayLength) && ((NewDamageNumberInfo.DamageNumberArray[NumberIndex] == 1) || ((NumberIndex > 0) && (NewDamageNumberInfo.DamageNumberArray[NumberIndex - 1] == 1)))) ? SpacingPercentageForOnes : 1.f;
-				OffsetAccumulatedValue += SpacingForNumber;
-
-				FLinearColor RGBAPositionParameter(CameraSpaceDirection);
-				RGBAPositionParameter.A = OffsetAccumulatedValue;
+				FLinearColor RGBAPositionParameter(DigitLayout.CameraSpaceDirection);
+				RGBAPositionParameter.A = DigitLayout.Offset;
 
 				const FName PositionParameterName = PositionParameterNames[NumberIndex];
 				MeshMID->SetVectorParameterValue(PositionParameterName, RGBAPositionParameter);
 
-				const float DistanceFromCameraToNumber = (CameraTransform.GetLocation() - NumberLocation).Size();
-				const float DistanceSpriteScale = DistanceFromCameraBeforeDoublingSize == 0.f ? 1.f : FMath::Clamp(DistanceFromCameraToNumber / DistanceFromCameraBeforeDoublingSize, 1.f, 1000000000.f);
-
-				const float ScaleToZeroMultiplier = (NumberIndex < DamageNumberArrayLength) && (((NumberIndex == 0) && bShouldShowSign) || (NumberIndex != 0)) ? 1.f : 0.f;
-
-				const float HitSizeMultiplier = Request.bIsCriticalDamage ? CriticalHitSizeMultiplier : 1.f;
-				const float FontSizeMultiplier = HitSizeMultiplier * DistanceSpriteScale * ScaleToZeroMultiplier;
-
 				FLinearColor RGBAScaleRotationParameter;
-				RGBAScaleRotationParameter.R = FontXSize * FontSizeMultiplier;
-				RGBAScaleRotationParameter.G = FontYSize * FontSizeMultiplier;
-				RGBAScaleRotationParameter.B = NewDamageNumberInfo.DamageNumberArray[FMath::Min(DamageNumberArrayLength - 1, NumberIndex)];
-				RGBAScaleRotationParameter.A = FMath::Sign(CameraSpaceDirection.X) * NumberOfNumberRotations;
+				RGBAScaleRotationParameter.R = DigitLayout.ScaleX;
+				RGBAScaleRotationParameter.G = DigitLayout.ScaleY;
+				RGBAScaleRotationParameter.B = DigitLayout.Digit;
+				RGBAScaleRotationParameter.A = DigitLayout.Rotation;
 
 				const FName ScaleRotationAngleParameterName = ScaleRotationAngleParameterNames[NumberIndex];
 				MeshMID->SetVectorParameterValue(ScaleRotationAngleParameterName, RGBAScaleRotationParameter);
@@ -324,13 +649,7 @@ void ULyraNumberPopComponent_MeshText::SetMaterialParameters(const FLyraNumberPo
 				MeshMID->SetVectorParameterValue(DurationParameterName, RGBADurationParameter);
 			}
 
-			// Non-gameplay cameras while spectating have more cinematic values of aperture as default.
-			// This makes damage numbers very blurry as they are brought close to the camera, and away from the point of focus.
-			// Disable the shifting of numbers towards the camera here, if in a cinematic spectator camera.
-			//@TODO: Determine whether or not we are spectating
-			const bool bIsSpectating = false;
-			MeshMID->SetScalarParameterValue(MoveToCameraParameterName, bIsSpectating ? 0.0f : 1.0f);
+			MeshMID->SetScalarParameterValue(MoveToCameraParameterName, LyraNumberPops::bIsSpectating ? 0.0f : 1.0f);
 		}
 	}
 }
-
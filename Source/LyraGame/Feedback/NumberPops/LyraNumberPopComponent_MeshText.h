@@ -6,8 +6,10 @@
 
 #include "LyraNumberPopComponent_MeshText.generated.h"
 
+class UInstancedStaticMeshComponent;
 class ULyraDamagePopStyle;
 class UMaterialInstanceDynamic;
+class UMaterialInterface;
 class UObject;
 class UStaticMesh;
 class UStaticMeshComponent;
@@ -44,16 +46,85 @@ struct FLiveNumberPopEntry
 	{}
 };
 
+/** A digit instance that is still animating */
+struct FLiveNumberPopInstance
+{
+	/** The world time that this instance can be reused */
+	float ReleaseTime = 0.0f;
+
+	int32 InstanceIndex = INDEX_NONE;
+};
+
+/** Instanced digits drawn with one mesh, reused once their animation has finished */
+USTRUCT()
+struct FInstancedNumberPopMesh
+{
+	GENERATED_BODY()
+
+	UPROPERTY(transient)
+	TObjectPtr<UInstancedStaticMeshComponent> Component = nullptr;
+
+	/** Instances still animating in chronological order, starting at FirstLiveInstance */
+	TArray<FLiveNumberPopInstance> LiveInstances;
+	int32 FirstLiveInstance = 0;
+
+	/** Instances whose animation has finished, ready to be reused */
+	TArray<int32> FreeInstances;
+};
+
+/** Digits of a damage number, the first entry reserves space for a + or - sign */
+using FNumberPopDigitArray = TArray<int32, TInlineAllocator<12>>;
+
 /** Struct that holds the info for a new damage number */
 struct FTempNumberPopInfo
 {
 	UStaticMeshComponent* StaticMeshComponent = nullptr;
 
-	TArray<UMaterialInstanceDynamic*> MeshMIDs;
+	TArray<UMaterialInstanceDynamic*, TInlineAllocator<4>> MeshMIDs;
 
-	TArray<int32> DamageNumberArray;
+	FNumberPopDigitArray DamageNumberArray;
 };
 
+/** Where and how a single digit slot of a number pop is drawn, shared by the material parameter and instanced paths */
+struct FNumberPopDigitLayout
+{
+	FVector CameraSpaceDirection = FVector::ZeroVector;
+	float Offset = 0.0f;
+	float ScaleX = 0.0f;
+	float ScaleY = 0.0f;
+	float Digit = 0.0f;
+	float Rotation = 0.0f;
+};
+
+/**
+ * Per-instance custom data layout used by the instanced number pop mode.
+ * The instanced digit material reads these with PerInstanceCustomData and animates the digit with WPO,
+ * the same way the regular material uses the per-digit vector parameters.
+ */
+namespace LyraNumberPopCustomData
+{
+	enum Type : int32
+	{
+		Digit = 0,			// Digit to show (0-9)
+		ColorR,
+		ColorG,
+		ColorB,
+		SpawnTime,			// Real time seconds the pop was spawned at
+		Lifespan,			// Animation length in seconds, the digit must be hidden once it is over as the instance stays around
+		Offset,				// Accumulated horizontal offset of the digit, in digit widths
+		DirectionX,			// Camera space direction the digit is offset along
+		DirectionY,
+		DirectionZ,
+		ScaleX,				// Size of the digit, 0 for hidden
+		ScaleY,
+		Rotation,			// Number of rotations during the animation, signed
+		RandomSeed,
+		IsCriticalHit,
+		MoveToCamera,
+		Num
+	};
+}
+
 
 
 
@@ -70,9 +141,29 @@ public:
 	virtual void AddNumberPop(const FLyraNumberPopRequest& NewRequest) override;
 	//~End of ULyraNumberPopComponent interface
 
+	/** Number of digit instances currently allocated by the instanced mode, across all meshes */
+	int32 GetNumInstancedDigits() const;
+
+	/** Number of pooled components currently showing a number */
+	int32 GetNumLiveComponents() const { return LiveComponents.Num(); }
+
 protected:
 	void SetMaterialParameters(const FLyraNumberPopRequest& Request, FTempNumberPopInfo& NewDamageNumberInfo, const FTransform& CameraTransform, const FVector& NumberLocation);
 
+	/** Picks the camera to face and the (slightly randomized) location of a new number */
+	void DetermineNumberTransform(const FLyraNumberPopRequest& Request, FTransform& OutCameraTransform, FVector& OutNumberLocation) const;
+
+	/** Adds a number pop as instances of the digit mesh instead of a pooled component */
+	void AddInstancedNumberPop(const FLyraNumberPopRequest& Request, const FNumberPopDigitArray& Digits, const FTransform& CameraTransform, const FVector& NumberLocation);
+
+	/** Fills OutDigits with the base 10 digits of Number, preceded by a slot reserved for the sign */
+	static void BuildDigitArray(int32 Number, FNumberPopDigitArray& OutDigits);
+
+	/** Computes the layout of NumSlots digit slots, slots past the end of the number get a zero scale */
+	void LayoutDigits(const FLyraNumberPopRequest& Request, const FNumberPopDigitArray& Digits, const FTransform& CameraTransform, const FVector& NumberLocation, int32 NumSlots, TArray<FNumberPopDigitLayout, TInlineAllocator<12>>& OutLayout) const;
+
+	UInstancedStaticMeshComponent* CreateInstancedDigitComponent(UStaticMesh* DigitMesh);
+
 	FLinearColor DetermineColor(const FLyraNumberPopRequest& Request) const;
 	UStaticMesh* DetermineStaticMesh(const FLyraNumberPopRequest& Request) const;
 
@@ -80,6 +171,9 @@ protected:
 	/** Releases components back to the pool that have exceeded their lifespan */
 	void ReleaseNextComponents();
 
+	/** Hides the digit instances that have exceeded their lifespan and frees them for reuse */
+	void ReleaseNextInstances();
+
 	/** Style patterns to attempt to apply to the incoming number pops */
 	UPROPERTY(EditDefaultsOnly, Category="Number Pop|Style")
 	TArray<TObjectPtr<ULyraDamagePopStyle>> Styles;
@@ -130,6 +224,21 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Material Bindings")
 	TArray<FName> DurationParameterNames;
 
+	/**
+	 * Draws every digit as an instance of one instanced static mesh component per style mesh, instead of one
+	 * pooled component with its own material instances per pop. Requires a digit mesh/material that reads
+	 * the per-instance custom data described by LyraNumberPopCustomData.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing")
+	bool bUseInstancedRendering = false;
+
+	/** Material used for the instanced digits (the style mesh's own materials are used if not set) */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing", meta = (EditCondition = "bUseInstancedRendering"))
+	TObjectPtr<UMaterialInterface> InstancedDigitMaterial;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UStaticMesh>, FInstancedNumberPopMesh> InstancedMeshMap;
+
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<UStaticMesh>, FPooledNumberPopComponentList> PooledComponentMap;
 
@@ -137,4 +246,6 @@ protected:
 	TArray<FLiveNumberPopEntry> LiveComponents;
 
 	FTimerHandle ReleaseTimerHandle;
+
+	FTimerHandle InstanceReleaseTimerHandle;
 };
@@ -1,11 +1,14 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "LyraExperienceManagerComponent.h"
+#include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
 #include "Net/UnrealNetwork.h"
 #include "LyraExperienceDefinition.h"
 #include "LyraExperienceActionSet.h"
 #include "LyraExperienceManager.h"
+#include "LyraExperienceWarmSwitchSubsystem.h"
 #include "GameFeaturesSubsystem.h"
 #include "System/LyraAssetManager.h"
 #include "GameFeatureAction.h"
@@ -45,8 +48,38 @@ namespace LyraConsoleVariables
 	{
 		return FMath::Max(0.0f, ExperienceLoadRandomDelayMin + FMath::FRand() * ExperienceLoadRandomDelayRange);
 	}
+
+	static bool bOverlapGameFeatureLoads = true;
+	static FAutoConsoleVariableRef CVarOverlapGameFeatureLoads(
+		TEXT("lyra.Experience.OverlapGameFeatureLoads"),
+		bOverlapGameFeatureLoads,
+		TEXT("Should the game feature plugins of an experience start loading while its bundles are still streaming? If false they start once the bundles are loaded."),
+		ECVF_Default);
+
+	static float ExperienceActionActivationBudgetMs = 5.0f;
+	static FAutoConsoleVariableRef CVarExperienceActionActivationBudgetMs(
+		TEXT("lyra.Experience.ActionActivationBudgetMs"),
+		ExperienceActionActivationBudgetMs,
+		TEXT("Time (in milliseconds) spent activating experience actions per frame before continuing on the next frame. At least one action is activated per frame. 0 activates them all at once."),
+		ECVF_Default);
 }
 
+static FAutoConsoleCommandWithWorld DumpExperienceLoadTimingsCommand(
+	TEXT("lyra.Experience.DumpLoadTimings"),
+	TEXT("Writes the per-phase and per-plugin timings of the current experience load to the log"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+		if (const ULyraExperienceManagerComponent* ExperienceComponent = GameState ? GameState->FindComponentByClass<ULyraExperienceManagerComponent>() : nullptr)
+		{
+			ExperienceComponent->LogLoadTimings();
+		}
+		else
+		{
+			UE_LOG(LogLyraExperience, Warning, TEXT("No experience manager component in this world"));
+		}
+	}));
+
 ULyraExperienceManagerComponent::ULyraExperienceManagerComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -131,6 +164,19 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 
 	LoadState = ELyraExperienceLoadState::Loading;
 
+	LoadTimings = FLyraExperienceLoadTimings();
+	LoadTimings.ExperienceId = CurrentExperience->GetPrimaryAssetId();
+	LoadTimings.StartTime = FPlatformTime::Seconds();
+
+	// The plugins to enable are known up front, so they can load while the bundles stream in
+	bGameFeaturePluginLoadsStarted = false;
+	CollectGameFeaturePluginURLs(CurrentExperience, GameFeaturePluginURLs);
+	if (LyraConsoleVariables::bOverlapGameFeatureLoads)
+	{
+		LoadTimings.bGameFeatureLoadsOverlapped = true;
+		StartGameFeaturePluginLoads();
+	}
+
 	ULyraAssetManager& AssetManager = ULyraAssetManager::Get();
 
 	TSet<FPrimaryAssetId> BundleAssetList;
@@ -148,20 +194,7 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 	// Load assets associated with the experience
 
 	TArray<FName> BundlesToLoad;
-	BundlesToLoad.Add(FLyraBundles::Equipped);
-
-	//@TODO: Centralize this client/server stuff into the LyraAssetManager
-	const ENetMode OwnerNetMode = GetOwner()->GetNetMode();
-	const bool bLoadClient = GIsEditor || (OwnerNetMode != NM_DedicatedServer);
-	const bool bLoadServer = GIsEditor || (OwnerNetMode != NM_Client);
-	if (bLoadClient)
-	{
-		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
-	}
-	if (bLoadServer)
-	{
-		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
-	}
+	GetBundlesToLoad(GetOwner()->GetNetMode(), BundlesToLoad);
 
 	TSharedPtr<FStreamableHandle> BundleLoadHandle = nullptr;
 	if (BundleAssetList.Num() > 0)
@@ -211,6 +244,23 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 	}
 }
 
+void ULyraExperienceManagerComponent::GetBundlesToLoad(ENetMode OwnerNetMode, TArray<FName>& OutBundlesToLoad)
+{
+	OutBundlesToLoad.Add(FLyraBundles::Equipped);
+
+	//@TODO: Centralize this client/server stuff into the LyraAssetManager
+	const bool bLoadClient = GIsEditor || (OwnerNetMode != NM_DedicatedServer);
+	const bool bLoadServer = GIsEditor || (OwnerNetMode != NM_Client);
+	if (bLoadClient)
+	{
+		OutBundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
+	}
+	if (bLoadServer)
+	{
+		OutBundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
+	}
+}
+
 void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 {
 	check(LoadState == ELyraExperienceLoadState::Loading);
@@ -220,17 +270,31 @@ void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 		*CurrentExperience->GetPrimaryAssetId().ToString(),
 		*GetClientServerContextString(this));
 
+	LoadTimings.BundleLoadSeconds = FPlatformTime::Seconds() - LoadTimings.StartTime;
+
+	// Load and activate the features, unless they already started with the bundles
+	StartGameFeaturePluginLoads();
+
+	LoadState = ELyraExperienceLoadState::LoadingGameFeatures;
+	if (NumGameFeaturePluginsLoading == 0)
+	{
+		OnExperienceFullLoadCompleted();
+	}
+}
+
+void ULyraExperienceManagerComponent::CollectGameFeaturePluginURLs(const ULyraExperienceDefinition* Experience, TArray<FString>& OutPluginURLs)
+{
 	// find the URLs for our GameFeaturePlugins - filtering out dupes and ones that don't have a valid mapping
-	GameFeaturePluginURLs.Reset();
+	OutPluginURLs.Reset();
 
-	auto CollectGameFeaturePluginURLs = [This=this](const UPrimaryDataAsset* Context, const TArray<FString>& FeaturePluginList)
+	auto CollectGameFeaturePluginURLs = [&OutPluginURLs](const UPrimaryDataAsset* Context, const TArray<FString>& FeaturePluginList)
 	{
 		for (const FString& PluginName : FeaturePluginList)
 		{
 			FString PluginURL;
 			if (UGameFeaturesSubsystem::Get().GetPluginURLByName(PluginName, /*out*/ PluginURL))
 			{
-				This->GameFeaturePluginURLs.AddUnique(PluginURL);
+				OutPluginURLs.AddUnique(PluginURL);
 			}
 			else
 			{
@@ -249,40 +313,69 @@ void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 		// 		}
 	};
 
-	CollectGameFeaturePluginURLs(CurrentExperience, CurrentExperience->GameFeaturesToEnable);
-	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : CurrentExperience->ActionSets)
+	CollectGameFeaturePluginURLs(Experience, Experience->GameFeaturesToEnable);
+	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : Experience->ActionSets)
 	{
 		if (ActionSet != nullptr)
 		{
 			CollectGameFeaturePluginURLs(ActionSet, ActionSet->GameFeaturesToEnable);
 		}
 	}
+}
 
-	// Load and activate the features	
+void ULyraExperienceManagerComponent::StartGameFeaturePluginLoads()
+{
+	if (bGameFeaturePluginLoadsStarted)
+	{
+		return;
+	}
+	bGameFeaturePluginLoadsStarted = true;
+
+	LoadTimings.GameFeatureLoadStartTime = FPlatformTime::Seconds();
+
+	ULyraExperienceWarmSwitchSubsystem* WarmSwitch = GetWarmSwitchSubsystem();
+
+	// Plugins that are already active complete immediately, so count them all before starting any
 	NumGameFeaturePluginsLoading = GameFeaturePluginURLs.Num();
-	if (NumGameFeaturePluginsLoading > 0)
+	for (const FString& PluginURL : GameFeaturePluginURLs)
 	{
-		LoadState = ELyraExperienceLoadState::LoadingGameFeatures;
-		for (const FString& PluginURL : GameFeaturePluginURLs)
-		{
-			ULyraExperienceManager::NotifyOfPluginActivation(PluginURL);
-			UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoadComplete));
-		}
+		FLyraExperienceLoadTimings::FPluginTiming& PluginTiming = LoadTimings.Plugins.AddDefaulted_GetRef();
+		PluginTiming.PluginURL = PluginURL;
+		PluginTiming.StartTime = FPlatformTime::Seconds();
+		PluginTiming.bWasKeptActive = WarmSwitch && WarmSwitch->IsPluginRetained(PluginURL);
+
+		ULyraExperienceManager::NotifyOfPluginActivation(PluginURL);
+		UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoadComplete, PluginURL));
 	}
-	else
+
+	// Every plugin we use has its own request now, the ones kept from the previous experience can be let go
+	if (WarmSwitch)
 	{
-		OnExperienceFullLoadCompleted();
+		WarmSwitch->OnExperiencePluginsRequested(GameFeaturePluginURLs);
 	}
 }
 
-void ULyraExperienceManagerComponent::OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result)
+void ULyraExperienceManagerComponent::OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result, FString PluginURL)
 {
+	const double Now = FPlatformTime::Seconds();
+	if (FLyraExperienceLoadTimings::FPluginTiming* PluginTiming = LoadTimings.Plugins.FindByPredicate([&PluginURL](const FLyraExperienceLoadTimings::FPluginTiming& Timing) { return Timing.PluginURL == PluginURL; }))
+	{
+		PluginTiming->Seconds = Now - PluginTiming->StartTime;
+		PluginTiming->bSuccess = !Result.HasError();
+	}
+
 	// decrement the number of plugins that are loading
 	NumGameFeaturePluginsLoading--;
 
 	if (NumGameFeaturePluginsLoading == 0)
 	{
-		OnExperienceFullLoadCompleted();
+		LoadTimings.GameFeatureLoadSeconds = Now - LoadTimings.GameFeatureLoadStartTime;
+
+		// When the plugins load alongside the bundles, the bundles completing finishes the load instead
+		if (LoadState == ELyraExperienceLoadState::LoadingGameFeatures)
+		{
+			OnExperienceFullLoadCompleted();
+		}
 	}
 }
 
@@ -299,51 +392,102 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 			FTimerHandle DummyHandle;
 
 			LoadState = ELyraExperienceLoadState::LoadingChaosTestingDelay;
+			LoadTimings.ChaosDelayStartTime = FPlatformTime::Seconds();
 			GetWorld()->GetTimerManager().SetTimer(DummyHandle, this, &ThisClass::OnExperienceFullLoadCompleted, DelaySecs, /*bLooping=*/ false);
 
 			return;
 		}
 	}
+	else
+	{
+		LoadTimings.ChaosDelaySeconds = FPlatformTime::Seconds() - LoadTimings.ChaosDelayStartTime;
+	}
 
 	LoadState = ELyraExperienceLoadState::ExecutingActions;
 
-	// Execute the actions
-	FGameFeatureActivatingContext Context;
-
-	// Only apply to our specific world context if set
-	const FWorldContext* ExistingWorldContext = GEngine->GetWorldContextFromWorld(GetWorld());
-	if (ExistingWorldContext)
-	{
-		Context.SetRequiredWorldContextHandle(ExistingWorldContext->ContextHandle);
-	}
+	// Gather the actions, they are activated over as many frames as lyra.Experience.ActionActivationBudgetMs requires
+	ExperienceActions.Reset();
+	NumActionsActivated = 0;
 
-	auto ActivateListOfActions = [&Context](const TArray<UGameFeatureAction*>& ActionList)
+	auto AddListOfActions = [this](const TArray<UGameFeatureAction*>& ActionList)
 	{
 		for (UGameFeatureAction* Action : ActionList)
 		{
 			if (Action != nullptr)
 			{
-				//@TODO: The fact that these don't take a world are potentially problematic in client-server PIE
-				// The current behavior matches systems like gameplay tags where loading and registering apply to the entire process,
-				// but actually applying the results to actors is restricted to a specific world
-				Action->OnGameFeatureRegistering();
-				Action->OnGameFeatureLoading();
-				Action->OnGameFeatureActivating(Context);
+				ExperienceActions.Add(Action);
 			}
 		}
 	};
 
-	ActivateListOfActions(CurrentExperience->Actions);
+	AddListOfActions(CurrentExperience->Actions);
 	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : CurrentExperience->ActionSets)
 	{
 		if (ActionSet != nullptr)
 		{
-			ActivateListOfActions(ActionSet->Actions);
+			AddListOfActions(ActionSet->Actions);
 		}
 	}
 
+	LoadTimings.NumActions = ExperienceActions.Num();
+	LoadTimings.ActionActivationStartTime = FPlatformTime::Seconds();
+
+	ActivateExperienceActions();
+}
+
+void ULyraExperienceManagerComponent::ActivateExperienceActions()
+{
+	check(LoadState == ELyraExperienceLoadState::ExecutingActions);
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = LyraConsoleVariables::ExperienceActionActivationBudgetMs / 1000.0;
+	++LoadTimings.NumActionActivationFrames;
+
+	// Execute the actions
+	FGameFeatureActivatingContext Context;
+
+	// Only apply to our specific world context if set
+	const FWorldContext* ExistingWorldContext = GEngine->GetWorldContextFromWorld(GetWorld());
+	if (ExistingWorldContext)
+	{
+		Context.SetRequiredWorldContextHandle(ExistingWorldContext->ContextHandle);
+	}
+
+	while (NumActionsActivated < ExperienceActions.Num())
+	{
+		UGameFeatureAction* Action = ExperienceActions[NumActionsActivated++];
+
+		//@TODO: The fact that these don't take a world are potentially problematic in client-server PIE
+		// The current behavior matches systems like gameplay tags where loading and registering apply to the entire process,
+		// but actually applying the results to actors is restricted to a specific world
+		Action->OnGameFeatureRegistering();
+		Action->OnGameFeatureLoading();
+		Action->OnGameFeatureActivating(Context);
+
+		if ((BudgetSeconds > 0.0) && (NumActionsActivated < ExperienceActions.Num()) && ((FPlatformTime::Seconds() - FrameStartTime) >= BudgetSeconds))
+		{
+			ActionActivationTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ThisClass::ActivateExperienceActions);
+			return;
+		}
+	}
+
+	OnExperienceActionsActivated();
+}
+
+void ULyraExperienceManagerComponent::OnExperienceActionsActivated()
+{
+	const double Now = FPlatformTime::Seconds();
+	LoadTimings.ActionActivationSeconds = Now - LoadTimings.ActionActivationStartTime;
+	LoadTimings.TotalSeconds = Now - LoadTimings.StartTime;
+	if (const ULyraExperienceWarmSwitchSubsystem* WarmSwitch = GetWarmSwitchSubsystem())
+	{
+		LoadTimings.TimeToPlayableSeconds = WarmSwitch->GetSecondsSincePreviousExperienceEnded();
+	}
+
 	LoadState = ELyraExperienceLoadState::Loaded;
 
+	LogLoadTimings();
+
 	OnExperienceLoaded_HighPriority.Broadcast(CurrentExperience);
 	OnExperienceLoaded_HighPriority.Clear();
 
@@ -359,6 +503,38 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 #endif
 }
 
+void ULyraExperienceManagerComponent::LogLoadTimings() const
+{
+	if (!LoadTimings.ExperienceId.IsValid())
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: No experience load has started"));
+		return;
+	}
+
+	if (LoadState != ELyraExperienceLoadState::Loaded)
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: %s is still loading (%.3f s so far)"), *LoadTimings.ExperienceId.ToString(), FPlatformTime::Seconds() - LoadTimings.StartTime);
+	}
+
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: Load timings for %s (%s): total %.3f s"),
+		*LoadTimings.ExperienceId.ToString(), *GetNameSafe(GetWorld()), LoadTimings.TotalSeconds);
+	if (LoadTimings.TimeToPlayableSeconds >= 0.0)
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("  Since previous experience ended: %.3f s"), LoadTimings.TimeToPlayableSeconds);
+	}
+	UE_LOG(LogLyraExperience, Log, TEXT("  Bundles:        %.3f s"), LoadTimings.BundleLoadSeconds);
+	UE_LOG(LogLyraExperience, Log, TEXT("  Game features:  %.3f s%s"), LoadTimings.GameFeatureLoadSeconds, LoadTimings.bGameFeatureLoadsOverlapped ? TEXT(" (overlapped with bundles)") : TEXT(""));
+	for (const FLyraExperienceLoadTimings::FPluginTiming& PluginTiming : LoadTimings.Plugins)
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("    %-64s %.3f s%s%s"), *PluginTiming.PluginURL, PluginTiming.Seconds, PluginTiming.bWasKeptActive ? TEXT(" (kept active)") : TEXT(""), PluginTiming.bSuccess ? TEXT("") : TEXT(" (failed or pending)"));
+	}
+	if (LoadTimings.ChaosDelaySeconds > 0.0)
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("  Chaos delay:    %.3f s"), LoadTimings.ChaosDelaySeconds);
+	}
+	UE_LOG(LogLyraExperience, Log, TEXT("  Actions:        %.3f s (%d actions over %d frames)"), LoadTimings.ActionActivationSeconds, LoadTimings.NumActions, LoadTimings.NumActionActivationFrames);
+}
+
 void ULyraExperienceManagerComponent::OnActionDeactivationCompleted()
 {
 	check(IsInGameThread());
@@ -381,9 +557,23 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 {
 	Super::EndPlay(EndPlayReason);
 
-	// deactivate any features this experience loaded
+	// Only the plugins that were requested hold an activation request to release, the loads may not have started yet
+	// (e.g., when play ends during the bundle load and the loads don't overlap it)
+	const TArray<FString> RequestedPluginURLs = bGameFeaturePluginLoadsStarted ? GameFeaturePluginURLs : TArray<FString>();
+
+	// deactivate any features this experience loaded, except the ones kept for the next experience
+	TArray<FString> PluginURLsToDeactivate;
+	if (ULyraExperienceWarmSwitchSubsystem* WarmSwitch = GetWarmSwitchSubsystem())
+	{
+		WarmSwitch->OnExperienceEnded(RequestedPluginURLs, PluginURLsToDeactivate);
+	}
+	else
+	{
+		PluginURLsToDeactivate = RequestedPluginURLs;
+	}
+
 	//@TODO: This should be handled FILO as well
-	for (const FString& PluginURL : GameFeaturePluginURLs)
+	for (const FString& PluginURL : PluginURLsToDeactivate)
 	{
 		if (ULyraExperienceManager::RequestToDeactivatePlugin(PluginURL))
 		{
@@ -391,8 +581,13 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 		}
 	}
 
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ActionActivationTimerHandle);
+	}
+
 	//@TODO: Ensure proper handling of a partially-loaded state too
-	if (LoadState == ELyraExperienceLoadState::Loaded)
+	if ((LoadState == ELyraExperienceLoadState::Loaded) || (LoadState == ELyraExperienceLoadState::ExecutingActions))
 	{
 		LoadState = ELyraExperienceLoadState::Deactivating;
 
@@ -409,27 +604,19 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 			Context.SetRequiredWorldContextHandle(ExistingWorldContext->ContextHandle);
 		}
 
-		auto DeactivateListOfActions = [&Context](const TArray<UGameFeatureAction*>& ActionList)
-		{
-			for (UGameFeatureAction* Action : ActionList)
-			{
-				if (Action)
-				{
-					Action->OnGameFeatureDeactivating(Context);
-					Action->OnGameFeatureUnregistering();
-				}
-			}
-		};
-
-		DeactivateListOfActions(CurrentExperience->Actions);
-		for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : CurrentExperience->ActionSets)
+		// Only the actions that were activated (all of them unless activation was still spread over frames)
+		for (int32 ActionIndex = 0; ActionIndex < NumActionsActivated; ++ActionIndex)
 		{
-			if (ActionSet != nullptr)
+			if (UGameFeatureAction* Action = ExperienceActions[ActionIndex])
 			{
-				DeactivateListOfActions(ActionSet->Actions);
+				Action->OnGameFeatureDeactivating(Context);
+				Action->OnGameFeatureUnregistering();
 			}
 		}
 
+		ExperienceActions.Reset();
+		NumActionsActivated = 0;
+
 		NumExpectedPausers = Context.GetNumPausers();
 
 		if (NumExpectedPausers > 0)
@@ -444,6 +631,13 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 	}
 }
 
+ULyraExperienceWarmSwitchSubsystem* ULyraExperienceManagerComponent::GetWarmSwitchSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<ULyraExperienceWarmSwitchSubsystem>() : nullptr;
+}
+
 bool ULyraExperienceManagerComponent::ShouldShowLoadingScreen(FString& OutReason) const
 {
 	if (LoadState != ELyraExperienceLoadState::Loaded)
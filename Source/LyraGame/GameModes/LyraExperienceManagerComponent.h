@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "Engine/TimerHandle.h"
 #include "LoadingProcessInterface.h"
 
 #include "LyraExperienceManagerComponent.generated.h"
@@ -11,7 +12,9 @@
 
 namespace UE::GameFeatures { struct FResult; }
 
+class UGameFeatureAction;
 class ULyraExperienceDefinition;
+class ULyraExperienceWarmSwitchSubsystem;
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnLyraExperienceLoaded, const ULyraExperienceDefinition* /*Experience*/);
 
@@ -26,6 +29,49 @@ enum class ELyraExperienceLoadState
 	Deactivating
 };
 
+/** Where the time went while loading an experience, in seconds */
+struct FLyraExperienceLoadTimings
+{
+	struct FPluginTiming
+	{
+		FString PluginURL;
+		double StartTime = 0.0;
+		double Seconds = 0.0;
+		bool bSuccess = false;
+
+		// Kept active from the previous experience (see ULyraExperienceWarmSwitchSubsystem)
+		bool bWasKeptActive = false;
+	};
+
+	FPrimaryAssetId ExperienceId;
+	double StartTime = 0.0;
+
+	// Streaming the experience and action set bundles
+	double BundleLoadSeconds = 0.0;
+
+	// From the first game feature plugin load starting to the last one completing
+	double GameFeatureLoadStartTime = 0.0;
+	double GameFeatureLoadSeconds = 0.0;
+	bool bGameFeatureLoadsOverlapped = false;
+
+	// lyra.chaos.ExperienceDelayLoad delay
+	double ChaosDelayStartTime = 0.0;
+	double ChaosDelaySeconds = 0.0;
+
+	// Activating the actions, possibly over several frames
+	double ActionActivationStartTime = 0.0;
+	double ActionActivationSeconds = 0.0;
+	int32 NumActions = 0;
+	int32 NumActionActivationFrames = 0;
+
+	double TotalSeconds = 0.0;
+
+	// From the previous experience ending to this one being loaded, negative for the first experience
+	double TimeToPlayableSeconds = -1.0;
+
+	TArray<FPluginTiming> Plugins;
+};
+
 UCLASS(MinimalAPI)
 class ULyraExperienceManagerComponent final : public UGameStateComponent, public ILoadingProcessInterface
 {
@@ -66,14 +112,31 @@ public:
 	// Returns true if the experience is fully loaded
 	UE_API bool IsExperienceLoaded() const;
 
+	// Returns the timings of the current (or last) experience load
+	const FLyraExperienceLoadTimings& GetLoadTimings() const { return LoadTimings; }
+
+	// Writes the timings of the current (or last) experience load to the log
+	UE_API void LogLoadTimings() const;
+
+	// Returns the bundles loaded for experiences in a world with the given net mode
+	static UE_API void GetBundlesToLoad(ENetMode OwnerNetMode, TArray<FName>& OutBundlesToLoad);
+
+	// Returns the URLs of the game feature plugins enabled by an experience and its action sets
+	static UE_API void CollectGameFeaturePluginURLs(const ULyraExperienceDefinition* Experience, TArray<FString>& OutPluginURLs);
+
 private:
 	UFUNCTION()
 	void OnRep_CurrentExperience();
 
 	void StartExperienceLoad();
 	void OnExperienceLoadComplete();
-	void OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result);
+	void StartGameFeaturePluginLoads();
+	void OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result, FString PluginURL);
 	void OnExperienceFullLoadCompleted();
+	void ActivateExperienceActions();
+	void OnExperienceActionsActivated();
+
+	ULyraExperienceWarmSwitchSubsystem* GetWarmSwitchSubsystem() const;
 
 	void OnActionDeactivationCompleted();
 	void OnAllActionsDeactivated();
@@ -86,6 +149,16 @@ private:
 
 	int32 NumGameFeaturePluginsLoading = 0;
 	TArray<FString> GameFeaturePluginURLs;
+	bool bGameFeaturePluginLoadsStarted = false;
+
+	// Actions of the experience and its action sets, in activation order. The first NumActionsActivated are active.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UGameFeatureAction>> ExperienceActions;
+	int32 NumActionsActivated = 0;
+
+	FTimerHandle ActionActivationTimerHandle;
+
+	FLyraExperienceLoadTimings LoadTimings;
 
 	int32 NumObservedPausers = 0;
 	int32 NumExpectedPausers = 0;
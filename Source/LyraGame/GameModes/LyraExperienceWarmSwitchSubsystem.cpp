@@ -0,0 +1,191 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraExperienceWarmSwitchSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFeaturesSubsystem.h"
+#include "LyraExperienceActionSet.h"
+#include "LyraExperienceDefinition.h"
+#include "LyraExperienceManager.h"
+#include "LyraExperienceManagerComponent.h"
+#include "LyraLogChannels.h"
+#include "System/LyraAssetManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraExperienceWarmSwitchSubsystem)
+
+namespace LyraConsoleVariables
+{
+	static bool bExperienceWarmSwitch = false;
+	static FAutoConsoleVariableRef CVarExperienceWarmSwitch(
+		TEXT("lyra.Experience.WarmSwitch"),
+		bExperienceWarmSwitch,
+		TEXT("Should the game feature plugins of an experience stay active after it ends, so the next experience only deactivates the ones it does not use?"),
+		ECVF_Default);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs PrefetchExperienceCommand(
+	TEXT("lyra.Experience.Prefetch"),
+	TEXT("Starts loading the bundles and plugins of the experience expected to run next (requires lyra.Experience.WarmSwitch). Usage: lyra.Experience.Prefetch <PrimaryAssetId>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		ULyraExperienceWarmSwitchSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<ULyraExperienceWarmSwitchSubsystem>() : nullptr;
+		if ((Subsystem != nullptr) && (Args.Num() > 0))
+		{
+			Subsystem->PrefetchExperience(FPrimaryAssetId::FromString(Args[0]));
+		}
+	}));
+
+bool ULyraExperienceWarmSwitchSubsystem::IsWarmSwitchEnabled()
+{
+	return LyraConsoleVariables::bExperienceWarmSwitch;
+}
+
+void ULyraExperienceWarmSwitchSubsystem::Deinitialize()
+{
+	ReleaseRetainedPlugins({});
+
+	PrefetchExperienceHandle.Reset();
+	PrefetchActionSetHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULyraExperienceWarmSwitchSubsystem::PrefetchExperience(FPrimaryAssetId ExperienceId)
+{
+	if (!IsWarmSwitchEnabled() || !ExperienceId.IsValid() || (ExperienceId == PrefetchedExperienceId))
+	{
+		return;
+	}
+
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: Prefetching %s for the next match"), *ExperienceId.ToString());
+
+	PrefetchedExperienceId = ExperienceId;
+	PrefetchedPluginURLs.Reset();
+	bPrefetchedPluginsKnown = false;
+	PrefetchActionSetHandle.Reset();
+
+	const UWorld* World = GetGameInstance()->GetWorld();
+	TArray<FName> BundlesToLoad;
+	ULyraExperienceManagerComponent::GetBundlesToLoad(World ? World->GetNetMode() : NM_Standalone, BundlesToLoad);
+
+	PrefetchExperienceHandle = ULyraAssetManager::Get().LoadPrimaryAsset(ExperienceId, BundlesToLoad);
+	if (!PrefetchExperienceHandle.IsValid() || PrefetchExperienceHandle->HasLoadCompleted())
+	{
+		OnPrefetchedExperienceLoaded();
+	}
+	else
+	{
+		PrefetchExperienceHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnPrefetchedExperienceLoaded));
+	}
+}
+
+void ULyraExperienceWarmSwitchSubsystem::OnPrefetchedExperienceLoaded()
+{
+	ULyraAssetManager& AssetManager = ULyraAssetManager::Get();
+
+	TSubclassOf<ULyraExperienceDefinition> ExperienceClass = AssetManager.GetPrimaryAssetObjectClass<ULyraExperienceDefinition>(PrefetchedExperienceId);
+	if (ExperienceClass == nullptr)
+	{
+		UE_LOG(LogLyraExperience, Warning, TEXT("EXPERIENCE: Failed to prefetch %s"), *PrefetchedExperienceId.ToString());
+		return;
+	}
+
+	const ULyraExperienceDefinition* Experience = GetDefault<ULyraExperienceDefinition>(ExperienceClass);
+
+	// Stream the action set bundles in, the experience bundles were loaded with the experience
+	TArray<FPrimaryAssetId> ActionSetIds;
+	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : Experience->ActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			ActionSetIds.Add(ActionSet->GetPrimaryAssetId());
+		}
+	}
+
+	if (ActionSetIds.Num() > 0)
+	{
+		const UWorld* World = GetGameInstance()->GetWorld();
+		TArray<FName> BundlesToLoad;
+		ULyraExperienceManagerComponent::GetBundlesToLoad(World ? World->GetNetMode() : NM_Standalone, BundlesToLoad);
+
+		PrefetchActionSetHandle = AssetManager.ChangeBundleStateForPrimaryAssets(ActionSetIds, BundlesToLoad, {});
+	}
+
+	// Load (but do not activate) the plugins that are not already running, activation needs the next world
+	ULyraExperienceManagerComponent::CollectGameFeaturePluginURLs(Experience, PrefetchedPluginURLs);
+	bPrefetchedPluginsKnown = true;
+
+	UGameFeaturesSubsystem& GameFeatures = UGameFeaturesSubsystem::Get();
+	for (const FString& PluginURL : PrefetchedPluginURLs)
+	{
+		if (!GameFeatures.IsGameFeaturePluginActive(PluginURL, /*bCheckForActivating=*/ true) && !GameFeatures.IsGameFeaturePluginLoaded(PluginURL))
+		{
+			GameFeatures.LoadGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateLambda([](const UE::GameFeatures::FResult&) {}));
+		}
+	}
+}
+
+void ULyraExperienceWarmSwitchSubsystem::OnExperienceEnded(const TArray<FString>& RequestedPluginURLs, TArray<FString>& OutPluginURLsToDeactivate)
+{
+	PreviousExperienceEndTime = FPlatformTime::Seconds();
+
+	if (!IsWarmSwitchEnabled())
+	{
+		OutPluginURLsToDeactivate.Append(RequestedPluginURLs);
+		return;
+	}
+
+	// Without a prefetched experience, expect the same one again and keep everything
+	// (only requested plugins, so each retained entry has an activation request to release later)
+	for (const FString& PluginURL : RequestedPluginURLs)
+	{
+		if (!bPrefetchedPluginsKnown || PrefetchedPluginURLs.Contains(PluginURL))
+		{
+			// One entry per activation request, released one by one
+			RetainedPluginURLs.Add(PluginURL);
+		}
+		else
+		{
+			OutPluginURLsToDeactivate.Add(PluginURL);
+		}
+	}
+
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: Keeping %d game feature plugins active for the next experience (%d deactivated)"), RetainedPluginURLs.Num(), OutPluginURLsToDeactivate.Num());
+}
+
+void ULyraExperienceWarmSwitchSubsystem::OnExperiencePluginsRequested(const TArray<FString>& PluginURLs)
+{
+	// The new experience holds its own requests now
+	ReleaseRetainedPlugins(PluginURLs);
+
+	PrefetchedExperienceId = FPrimaryAssetId();
+	PrefetchedPluginURLs.Reset();
+	bPrefetchedPluginsKnown = false;
+	PrefetchExperienceHandle.Reset();
+	PrefetchActionSetHandle.Reset();
+}
+
+void ULyraExperienceWarmSwitchSubsystem::ReleaseRetainedPlugins(const TArray<FString>& PluginURLsToKeep)
+{
+	for (const FString& PluginURL : RetainedPluginURLs)
+	{
+		if (ULyraExperienceManager::RequestToDeactivatePlugin(PluginURL) && !PluginURLsToKeep.Contains(PluginURL))
+		{
+			UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(PluginURL);
+		}
+	}
+
+	RetainedPluginURLs.Reset();
+}
+
+bool ULyraExperienceWarmSwitchSubsystem::IsPluginRetained(const FString& PluginURL) const
+{
+	return RetainedPluginURLs.Contains(PluginURL);
+}
+
+double ULyraExperienceWarmSwitchSubsystem::GetSecondsSincePreviousExperienceEnded() const
+{
+	return (PreviousExperienceEndTime >= 0.0) ? (FPlatformTime::Seconds() - PreviousExperienceEndTime) : -1.0;
+}
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+
+#include "LyraExperienceWarmSwitchSubsystem.generated.h"
+
+#define UE_API LYRAGAME_API
+
+struct FStreamableHandle;
+
+/**
+ * Keeps experiences warm between matches (opt-in with lyra.Experience.WarmSwitch)
+ *
+ * When an experience ends, its game feature plugins stay active instead of being deactivated, and the next
+ * experience only deactivates the ones it does not use. The next experience can be prefetched (e.g., while the
+ * post-match screen shows) so its bundles are resident and its plugins loaded by the time it starts.
+ */
+UCLASS(MinimalAPI)
+class ULyraExperienceWarmSwitchSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true if experiences should be kept warm between matches */
+	static UE_API bool IsWarmSwitchEnabled();
+
+	//~USubsystem interface
+	UE_API virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	/** Starts loading the bundles and game feature plugins of the experience expected to run next */
+	UFUNCTION(BlueprintCallable, Category = "Lyra|Experience")
+	UE_API void PrefetchExperience(FPrimaryAssetId ExperienceId);
+
+	/** Called when an experience ends with the plugins it requested, decides which of them stay active for the next one */
+	UE_API void OnExperienceEnded(const TArray<FString>& RequestedPluginURLs, TArray<FString>& OutPluginURLsToDeactivate);
+
+	/** Called once an experience has requested its plugins, deactivates the kept plugins it does not use */
+	UE_API void OnExperiencePluginsRequested(const TArray<FString>& PluginURLs);
+
+	/** Returns true if the plugin was kept active by this subsystem when the previous experience ended */
+	UE_API bool IsPluginRetained(const FString& PluginURL) const;
+
+	/** Returns the seconds since the previous experience ended, or a negative value if none has */
+	UE_API double GetSecondsSincePreviousExperienceEnded() const;
+
+private:
+	void OnPrefetchedExperienceLoaded();
+	void ReleaseRetainedPlugins(const TArray<FString>& PluginURLsToKeep);
+
+	// Plugins kept active after their experience ended. Their activation request is released by the next experience.
+	TArray<FString> RetainedPluginURLs;
+
+	// The experience expected to run next, and the plugins it needs
+	FPrimaryAssetId PrefetchedExperienceId;
+	TArray<FString> PrefetchedPluginURLs;
+	bool bPrefetchedPluginsKnown = false;
+
+	TSharedPtr<FStreamableHandle> PrefetchExperienceHandle;
+	TSharedPtr<FStreamableHandle> PrefetchActionSetHandle;
+
+	double PreviousExperienceEndTime = -1.0;
+};
+
+#undef UE_API
@@ -18,6 +18,12 @@ class FLifetimeProperty;
 
 extern ENGINE_API float GAverageFPS;
 
+namespace LyraGameState
+{
+	// How often the server moves the network timestamp base; offsets within this range keep sub-millisecond float precision
+	static constexpr double ServerTimestampBaseInterval = 300.0;
+}
+
 
 ALyraGameState::ALyraGameState(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -87,6 +93,7 @@ void ALyraGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(ThisClass, ServerFPS);
+	DOREPLIFETIME(ThisClass, ServerTimestampBase);
 	DOREPLIFETIME_CONDITION(ThisClass, RecorderPlayerState, COND_ReplayOnly);
 }
 
@@ -97,9 +104,35 @@ void ALyraGameState::Tick(float DeltaSeconds)
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		ServerFPS = GAverageFPS;
+
+		const double ServerTime = GetServerWorldTimeSeconds();
+		if (ServerTime - ServerTimestampBase.Time >= LyraGameState::ServerTimestampBaseInterval)
+		{
+			PreviousServerTimestampBase = ServerTimestampBase;
+			ServerTimestampBase.Time = ServerTime;
+			// MAX_uint8 is reserved by serializers to mean 'not encoded against a base'
+			ServerTimestampBase.Index = (ServerTimestampBase.Index + 1) % MAX_uint8;
+		}
 	}
 }
 
+void ALyraGameState::OnRep_ServerTimestampBase(const FLyraServerTimestampBase& OldBase)
+{
+	PreviousServerTimestampBase = OldBase;
+}
+
+void ALyraGameState::EncodeServerTimestamp(double Timestamp, uint8& OutBaseIndex, float& OutOffset) const
+{
+	OutBaseIndex = ServerTimestampBase.Index;
+	OutOffset = (float)(Timestamp - ServerTimestampBase.Time);
+}
+
+double ALyraGameState::DecodeServerTimestamp(uint8 BaseIndex, float Offset) const
+{
+	const FLyraServerTimestampBase& Base = (BaseIndex == PreviousServerTimestampBase.Index && BaseIndex != ServerTimestampBase.Index) ? PreviousServerTimestampBase : ServerTimestampBase;
+	return Base.Time + Offset;
+}
+
 void ALyraGameState::MulticastMessageToClients_Implementation(const FLyraVerbMessage Message)
 {
 	if (GetNetMode() == NM_Client)
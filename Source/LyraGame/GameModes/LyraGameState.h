@@ -18,6 +18,21 @@ class ULyraExperienceManagerComponent;
 class UObject;
 struct FFrame;
 
+/** A server world time that timestamps sent over the network are encoded relative to */
+USTRUCT()
+struct FLyraServerTimestampBase
+{
+	GENERATED_BODY()
+
+	// Server world time of the base
+	UPROPERTY()
+	double Time = 0.0;
+
+	// Incremented each time the base moves, so a timestamp can name the base it was encoded against
+	UPROPERTY()
+	uint8 Index = 0;
+};
+
 /**
  * ALyraGameState
  *
@@ -66,6 +81,12 @@ public:
 	// Gets the server's FPS, replicated to clients
 	UE_API float GetServerFPS() const;
 
+	// Splits a server world time into the index of the timestamp base it is relative to and a small offset that fits in a float
+	UE_API void EncodeServerTimestamp(double Timestamp, uint8& OutBaseIndex, float& OutOffset) const;
+
+	// Reverses EncodeServerTimestamp, falling back to the current base if the index is no longer known
+	UE_API double DecodeServerTimestamp(uint8 BaseIndex, float Offset) const;
+
 	// Indicate the local player state is recording a replay
 	UE_API void SetRecorderPlayerState(APlayerState* NewPlayerState);
 
@@ -89,6 +110,16 @@ protected:
 	UPROPERTY(Replicated)
 	float ServerFPS;
 
+	// The base that network timestamps are encoded against, moved forward periodically by the server to keep offsets small
+	UPROPERTY(ReplicatedUsing = OnRep_ServerTimestampBase)
+	FLyraServerTimestampBase ServerTimestampBase;
+
+	// The base before the current one, so timestamps encoded just before a move can still be decoded
+	FLyraServerTimestampBase PreviousServerTimestampBase;
+
+	UFUNCTION()
+	UE_API void OnRep_ServerTimestampBase(const FLyraServerTimestampBase& OldBase);
+
 	// The player state that recorded a replay, it is used to select the right pawn to follow
 	// This is only set in replay streams and is not replicated normally
 	UPROPERTY(Transient, ReplicatedUsing = OnRep_RecorderPlayerState)
@@ -7,6 +7,8 @@
 
 #include "LyraInventoryItemInstance.generated.h"
 
+#define UE_API LYRAGAME_API
+
 class FLifetimeProperty;
 
 class ULyraInventoryItemDefinition;
@@ -31,7 +33,7 @@ public:
 
 	// Adds a specified number of stacks to the tag (does nothing if StackCount is below 1)
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category=Inventory)
-	void AddStatTagStack(FGameplayTag Tag, int32 StackCount);
+	UE_API void AddStatTagStack(FGameplayTag Tag, int32 StackCount);
 
 	// Removes a specified number of stacks from the tag (does nothing if StackCount is below 1)
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= Inventory)
@@ -39,7 +41,7 @@ public:
 
 	// Returns the stack count of the specified tag (or 0 if the tag is not present)
 	UFUNCTION(BlueprintCallable, Category=Inventory)
-	int32 GetStatTagStackCount(FGameplayTag Tag) const;
+	UE_API int32 GetStatTagStackCount(FGameplayTag Tag) const;
 
 	// Returns true if there is at least one stack of the specified tag
 	UFUNCTION(BlueprintCallable, Category=Inventory)
@@ -75,3 +77,5 @@ private:
 	UPROPERTY(Replicated)
 	TSubclassOf<ULyraInventoryItemDefinition> ItemDef;
 };
+
+#undef UE_API
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Modules/ModuleManager.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 
 /**
@@ -10,10 +11,12 @@ class FLyraGameModule : public FDefaultGameModuleImpl
 {
 	virtual void StartupModule() override
 	{
+		FLyraServerPerfTimers::Startup();
 	}
 
 	virtual void ShutdownModule() override
 	{
+		FLyraServerPerfTimers::Shutdown();
 	}
 };
 
@@ -0,0 +1,264 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Performance/LyraHitchDetector.h"
+
+#include "Async/Async.h"
+#include "ChartCreation.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/UObjectGlobals.h"
+
+CSV_DECLARE_CATEGORY_EXTERN(LyraPerformance);
+
+namespace LyraConsoleVariables
+{
+	static bool bHitchDetectorEnabled = true;
+	static FAutoConsoleVariableRef CVarHitchDetectorEnabled(
+		TEXT("lyra.Hitch.Detector"),
+		bHitchDetectorEnabled,
+		TEXT("Should the frame timings of the last few seconds be written to Saved/Profiling/Hitches when a hitch happens?\n")
+		TEXT("Read when the game instance starts."),
+		ECVF_Default);
+
+	static float HitchThresholdMs = 100.0f;
+	static FAutoConsoleVariableRef CVarHitchThresholdMs(
+		TEXT("lyra.Hitch.ThresholdMs"),
+		HitchThresholdMs,
+		TEXT("Frames longer than this (in milliseconds) are reported as hitches."),
+		ECVF_Default);
+
+	static float HitchBufferSeconds = 10.0f;
+	static FAutoConsoleVariableRef CVarHitchBufferSeconds(
+		TEXT("lyra.Hitch.BufferSeconds"),
+		HitchBufferSeconds,
+		TEXT("How many seconds of frames before a hitch are captured (sized for up to 120 frames per second).\n")
+		TEXT("Read when the game instance starts."),
+		ECVF_Default);
+
+	static float HitchMinSecondsBetweenCaptures = 30.0f;
+	static FAutoConsoleVariableRef CVarHitchMinSecondsBetweenCaptures(
+		TEXT("lyra.Hitch.MinSecondsBetweenCaptures"),
+		HitchMinSecondsBetweenCaptures,
+		TEXT("Hitches happening less than this many seconds after the last capture are only counted, not captured."),
+		ECVF_Default);
+
+	static int32 HitchMaxCaptures = 20;
+	static FAutoConsoleVariableRef CVarHitchMaxCaptures(
+		TEXT("lyra.Hitch.MaxCaptures"),
+		HitchMaxCaptures,
+		TEXT("Maximum number of hitch captures written per session (0 for no limit)."),
+		ECVF_Default);
+}
+
+namespace LyraHitchDetector
+{
+	static constexpr int32 NumTimers = (int32)ELyraServerPerfTimer::Count;
+	static constexpr double MaxFramesPerSecond = 120.0;
+	static constexpr int32 MinBufferFrames = 128;
+	static constexpr int32 MaxBufferFrames = 16384;
+
+	static FString GetMarkersString(ELyraHitchFrameMarkers Markers)
+	{
+		FString Result;
+		if (EnumHasAnyFlags(Markers, ELyraHitchFrameMarkers::GarbageCollection))
+		{
+			Result += TEXT("GC ");
+		}
+		if (EnumHasAnyFlags(Markers, ELyraHitchFrameMarkers::LevelStreaming))
+		{
+			Result += TEXT("LevelStreaming ");
+		}
+		if (EnumHasAnyFlags(Markers, ELyraHitchFrameMarkers::MapLoad))
+		{
+			Result += TEXT("MapLoad ");
+		}
+		Result.TrimEndInline();
+		return Result;
+	}
+
+	static FString FormatCapture(const TArray<FLyraHitchFrameRecord>& Records, const FLyraHitchFrameRecord& HitchFrame, float ThresholdMs)
+	{
+		FString Result;
+		Result.Reserve(Records.Num() * 160);
+
+		Result += FString::Printf(TEXT("# Hitch of %.2f ms on frame %llu (threshold %.2f ms), %d frames captured") LINE_TERMINATOR,
+			HitchFrame.FrameMs, HitchFrame.FrameNumber, ThresholdMs, Records.Num());
+
+		Result += TEXT("Time,Frame,FrameMs,GameThreadMs,RenderThreadMs,RHIThreadMs,GPUMs,IdleMs");
+		for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+		{
+			Result += FString::Printf(TEXT(",%sMs"), FLyraServerPerfTimers::GetTimerName((ELyraServerPerfTimer)TimerIndex));
+		}
+		Result += TEXT(",Markers") LINE_TERMINATOR;
+
+		for (const FLyraHitchFrameRecord& Record : Records)
+		{
+			// Times are relative to the end of the hitch frame
+			Result += FString::Printf(TEXT("%.4f,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f"),
+				Record.Time - HitchFrame.Time, Record.FrameNumber,
+				Record.FrameMs, Record.GameThreadMs, Record.RenderThreadMs, Record.RHIThreadMs, Record.GPUMs, Record.IdleMs);
+			for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+			{
+				Result += FString::Printf(TEXT(",%.3f"), Record.TimerMs[TimerIndex]);
+			}
+			Result += TEXT(",");
+			Result += GetMarkersString(Record.Markers);
+			Result += LINE_TERMINATOR;
+		}
+
+		return Result;
+	}
+}
+
+void FLyraHitchDetector::Start()
+{
+	using namespace LyraHitchDetector;
+
+	if (!LyraConsoleVariables::bHitchDetectorEnabled)
+	{
+		return;
+	}
+
+	BufferSeconds = FMath::Max(LyraConsoleVariables::HitchBufferSeconds, 1.0f);
+	const int32 BufferFrames = FMath::Clamp(FMath::CeilToInt32(BufferSeconds * MaxFramesPerSecond), MinBufferFrames, MaxBufferFrames);
+
+	Frames.Reset();
+	Frames.SetNum(BufferFrames);
+	NextFrame = 0;
+	NumFrames = 0;
+	PendingMarkers = ELyraHitchFrameMarkers::None;
+	FLyraServerPerfTimers::GetTotalCycles(LastTimerCycles);
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FLyraHitchDetector::HandlePreGarbageCollect);
+	FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FLyraHitchDetector::HandleLevelStreaming);
+	FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FLyraHitchDetector::HandleLevelStreaming);
+	FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FLyraHitchDetector::HandlePreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FLyraHitchDetector::HandlePostLoadMap);
+
+	bActive = true;
+}
+
+void FLyraHitchDetector::Stop()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().RemoveAll(this);
+	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
+	FWorldDelegates::LevelRemovedFromWorld.RemoveAll(this);
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	Frames.Empty();
+	NumFrames = 0;
+	bActive = false;
+}
+
+void FLyraHitchDetector::RecordFrame(const FFrameData& FrameData)
+{
+	using namespace LyraHitchDetector;
+
+	FLyraHitchFrameRecord& Record = Frames[NextFrame];
+	Record.Time = FPlatformTime::Seconds();
+	Record.FrameNumber = GFrameCounter;
+	Record.FrameMs = (float)(FrameData.TrueDeltaSeconds * 1000.0);
+	Record.GameThreadMs = (float)(FrameData.GameThreadTimeSeconds * 1000.0);
+	Record.RenderThreadMs = (float)(FrameData.RenderThreadTimeSeconds * 1000.0);
+	Record.RHIThreadMs = (float)(FrameData.RHIThreadTimeSeconds * 1000.0);
+	Record.GPUMs = (float)(FrameData.GPUTimeSeconds * 1000.0);
+	Record.IdleMs = (float)(FrameData.IdleSeconds * 1000.0);
+	Record.Markers = PendingMarkers;
+	PendingMarkers = ELyraHitchFrameMarkers::None;
+
+	uint64 TimerCycles[NumTimers];
+	FLyraServerPerfTimers::GetTotalCycles(TimerCycles);
+	for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+	{
+		Record.TimerMs[TimerIndex] = (float)FPlatformTime::ToMilliseconds64(TimerCycles[TimerIndex] - LastTimerCycles[TimerIndex]);
+		LastTimerCycles[TimerIndex] = TimerCycles[TimerIndex];
+	}
+
+	NextFrame = (NextFrame + 1) % Frames.Num();
+	NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+
+	if (Record.FrameMs > LyraConsoleVariables::HitchThresholdMs)
+	{
+		CSV_EVENT(LyraPerformance, TEXT("Hitch %.1fms"), Record.FrameMs);
+
+		const bool bReachedMaxCaptures = (LyraConsoleVariables::HitchMaxCaptures > 0) && (NumCaptures >= LyraConsoleVariables::HitchMaxCaptures);
+		const bool bTooSoon = (Record.Time - LastCaptureTime) < LyraConsoleVariables::HitchMinSecondsBetweenCaptures;
+		if (bReachedMaxCaptures || bTooSoon)
+		{
+			UE_LOG(LogLyra, Verbose, TEXT("Hitch of %.2f ms on frame %llu (not captured)"), Record.FrameMs, Record.FrameNumber);
+		}
+		else
+		{
+			WriteCapture(Record);
+		}
+	}
+}
+
+void FLyraHitchDetector::WriteCapture(const FLyraHitchFrameRecord& HitchFrame)
+{
+	using namespace LyraHitchDetector;
+
+	LastCaptureTime = HitchFrame.Time;
+	++NumCaptures;
+
+	// Copy the frames within the buffer duration, oldest first (the hitch frame is the most recent one)
+	int32 NumCapturedFrames = 0;
+	while (NumCapturedFrames < NumFrames)
+	{
+		const int32 FrameIndex = (NextFrame - 1 - NumCapturedFrames + Frames.Num()) % Frames.Num();
+		if ((HitchFrame.Time - Frames[FrameIndex].Time) > BufferSeconds)
+		{
+			break;
+		}
+		++NumCapturedFrames;
+	}
+
+	TArray<FLyraHitchFrameRecord> Records;
+	Records.Reserve(NumCapturedFrames);
+	for (int32 Offset = NumCapturedFrames; Offset > 0; --Offset)
+	{
+		Records.Add(Frames[(NextFrame - Offset + Frames.Num()) % Frames.Num()]);
+	}
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT("Hitches") / FString::Printf(TEXT("Hitch_%s_%llu.csv"), *FDateTime::Now().ToString(), HitchFrame.FrameNumber);
+	UE_LOG(LogLyra, Log, TEXT("Hitch of %.2f ms on frame %llu, writing the last %d frames to %s"), HitchFrame.FrameMs, HitchFrame.FrameNumber, Records.Num(), *FPaths::ConvertRelativePathToFull(Filename));
+
+	// Formatting and writing the capture can take a while, keep it off the game thread
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Records = MoveTemp(Records), HitchFrame, Filename, ThresholdMs = LyraConsoleVariables::HitchThresholdMs]()
+	{
+		if (!FFileHelper::SaveStringToFile(FormatCapture(Records, HitchFrame, ThresholdMs), *Filename))
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Failed to write hitch capture %s"), *Filename);
+		}
+	});
+}
+
+void FLyraHitchDetector::HandlePreGarbageCollect()
+{
+	PendingMarkers |= ELyraHitchFrameMarkers::GarbageCollection;
+}
+
+void FLyraHitchDetector::HandleLevelStreaming(ULevel* Level, UWorld* World)
+{
+	PendingMarkers |= ELyraHitchFrameMarkers::LevelStreaming;
+}
+
+void FLyraHitchDetector::HandlePreLoadMap(const FString& MapName)
+{
+	PendingMarkers |= ELyraHitchFrameMarkers::MapLoad;
+}
+
+void FLyraHitchDetector::HandlePostLoadMap(UWorld* World)
+{
+	PendingMarkers |= ELyraHitchFrameMarkers::MapLoad;
+}
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Misc/EnumClassFlags.h"
+#include "Performance/LyraServerPerfTimers.h"
+
+class ULevel;
+class UWorld;
+struct FFrameData;
+
+/** Events that happened during a recorded frame */
+enum class ELyraHitchFrameMarkers : uint8
+{
+	None = 0,
+
+	// A garbage collection ran
+	GarbageCollection = 1 << 0,
+
+	// A streaming level was added to or removed from a world
+	LevelStreaming = 1 << 1,
+
+	// A map load started or finished
+	MapLoad = 1 << 2,
+};
+ENUM_CLASS_FLAGS(ELyraHitchFrameMarkers);
+
+/** Timings of a single frame kept by the hitch detector */
+struct FLyraHitchFrameRecord
+{
+	double Time = 0.0;
+	uint64 FrameNumber = 0;
+
+	float FrameMs = 0.0f;
+	float GameThreadMs = 0.0f;
+	float RenderThreadMs = 0.0f;
+	float RHIThreadMs = 0.0f;
+	float GPUMs = 0.0f;
+	float IdleMs = 0.0f;
+
+	// Time spent in each of the server performance timers, indexed by ELyraServerPerfTimer
+	float TimerMs[(int32)ELyraServerPerfTimer::Count] = {};
+
+	ELyraHitchFrameMarkers Markers = ELyraHitchFrameMarkers::None;
+};
+
+/**
+ * FLyraHitchDetector
+ *
+ * Keeps the per-frame timings of the last few seconds in a fixed size ring buffer, and writes the buffer
+ * to Saved/Profiling/Hitches when a frame takes longer than lyra.Hitch.ThresholdMs, so intermittent hitches
+ * can be investigated after the fact.
+ * Recording a frame only copies a few values into preallocated memory, and captures are formatted and
+ * written to disk by a background task, so the detector is cheap enough to leave on in production.
+ */
+class FLyraHitchDetector
+{
+public:
+	void Start();
+	void Stop();
+
+	bool IsActive() const { return bActive; }
+
+	/** Records the frame that just ended, and captures the buffer if it was a hitch */
+	void RecordFrame(const FFrameData& FrameData);
+
+private:
+	void WriteCapture(const FLyraHitchFrameRecord& HitchFrame);
+
+	void HandlePreGarbageCollect();
+	void HandleLevelStreaming(ULevel* Level, UWorld* World);
+	void HandlePreLoadMap(const FString& MapName);
+	void HandlePostLoadMap(UWorld* World);
+
+	// Ring buffer of the most recent frames
+	TArray<FLyraHitchFrameRecord> Frames;
+	int32 NextFrame = 0;
+	int32 NumFrames = 0;
+
+	// Server performance timer totals at the end of the previous frame
+	uint64 LastTimerCycles[(int32)ELyraServerPerfTimer::Count] = {};
+
+	// Markers raised since the last recorded frame
+	ELyraHitchFrameMarkers PendingMarkers = ELyraHitchFrameMarkers::None;
+
+	double BufferSeconds = 10.0;
+	double LastCaptureTime = -UE_BIG_NUMBER;
+	int32 NumCaptures = 0;
+
+	bool bActive = false;
+};
@@ -6,11 +6,19 @@
 #include "Engine/GameInstance.h"
 #include "Engine/NetConnection.h"
 #include "Engine/World.h"
+#include "Features/IModularFeatures.h"
+#include "GameFramework/GameplayMessageSubsystem.h"
 #include "GameFramework/PlayerState.h"
 #include "GameModes/LyraGameState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Misc/Paths.h"
 #include "Performance/LyraPerformanceStatTypes.h"
 #include "Performance/LatencyMarkerModule.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "ProfilingDebugging/CsvProfiler.h"
+#include "Serialization/JsonWriter.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraPerformanceStatSubsystem)
 
@@ -18,11 +26,304 @@ CSV_DEFINE_CATEGORY(LyraPerformance, /*bIsEnabledByDefault=*/false);
 
 class FSubsystemCollectionBase;
 
+namespace LyraConsoleVariables
+{
+	static int32 PerfStatHistoryMode = 2;
+	static FAutoConsoleVariableRef CVarPerfStatHistoryMode(
+		TEXT("lyra.PerfStats.History"),
+		PerfStatHistoryMode,
+		TEXT("Long-running percentile tracking of the performance stats. 0: off, 1: on, 2: on for dedicated servers only (default).\n")
+		TEXT("Read when the game instance starts."),
+		ECVF_Default);
+
+	static float PerfStatHistoryIntervalSeconds = 10.0f;
+	static FAutoConsoleVariableRef CVarPerfStatHistoryIntervalSeconds(
+		TEXT("lyra.PerfStats.History.IntervalSeconds"),
+		PerfStatHistoryIntervalSeconds,
+		TEXT("How often (in seconds) the percentile history is rolled over and exported."),
+		ECVF_Default);
+
+	static FString PerfStatHistoryWindows = TEXT("10,60,300");
+	static FAutoConsoleVariableRef CVarPerfStatHistoryWindows(
+		TEXT("lyra.PerfStats.History.Windows"),
+		PerfStatHistoryWindows,
+		TEXT("Comma separated list of the windows (in seconds) percentiles are reported over. Rounded up to whole intervals."),
+		ECVF_Default);
+
+	static FString PerfStatHistoryExportFormat = TEXT("csv");
+	static FAutoConsoleVariableRef CVarPerfStatHistoryExportFormat(
+		TEXT("lyra.PerfStats.History.ExportFormat"),
+		PerfStatHistoryExportFormat,
+		TEXT("Format of the file the percentile history is exported to in Saved/Profiling/PerfHistory: csv, json (one object per line) or none."),
+		ECVF_Default);
+}
+
+namespace LyraPerformanceStats
+{
+	static const FString& GetStatName(const ELyraDisplayablePerformanceStat Stat)
+	{
+		static TArray<FString> StatNames;
+		if (StatNames.Num() == 0)
+		{
+			for (ELyraDisplayablePerformanceStat EnumStat : TEnumRange<ELyraDisplayablePerformanceStat>())
+			{
+				StatNames.Add(StaticEnum<ELyraDisplayablePerformanceStat>()->GetNameStringByValue((int64)EnumStat));
+			}
+		}
+		return StatNames[(int32)Stat];
+	}
+
+	static FAutoConsoleCommandWithWorld LogHistoryCommand(
+		TEXT("lyra.PerfStats.History.Dump"),
+		TEXT("Writes the long-running percentiles of the performance stats to the log"),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+			if (ULyraPerformanceStatSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<ULyraPerformanceStatSubsystem>() : nullptr)
+			{
+				Subsystem->LogStatHistory();
+			}
+		}));
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraPerformanceStatHistory
+
+void FLyraPerformanceStatHistory::Start()
+{
+	IntervalSeconds = FMath::Max(LyraConsoleVariables::PerfStatHistoryIntervalSeconds, 1.0f);
+
+	WindowIntervals.Reset();
+	TArray<FString> WindowStrings;
+	LyraConsoleVariables::PerfStatHistoryWindows.ParseIntoArray(WindowStrings, TEXT(","));
+	for (const FString& WindowString : WindowStrings)
+	{
+		const double WindowSeconds = FCString::Atod(*WindowString.TrimStartAndEnd());
+		if (WindowSeconds > 0.0)
+		{
+			WindowIntervals.AddUnique(FMath::Max(1, FMath::CeilToInt32(WindowSeconds / IntervalSeconds)));
+		}
+	}
+	if (WindowIntervals.Num() == 0)
+	{
+		WindowIntervals.Add(1);
+	}
+	WindowIntervals.Sort();
+
+	ClosedIntervals.Reset();
+	ClosedIntervals.Reserve(WindowIntervals.Last() + 1);
+	for (FLyraStatPercentileSketch& Sketch : CurrentInterval.Sketches)
+	{
+		Sketch.Reset();
+	}
+	CurrentInterval.StartTime = FPlatformTime::Seconds();
+
+	const FString Format = LyraConsoleVariables::PerfStatHistoryExportFormat;
+	if (Format.Equals(TEXT("csv"), ESearchCase::IgnoreCase) || Format.Equals(TEXT("json"), ESearchCase::IgnoreCase))
+	{
+		bExportJson = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+
+		const FString Filename = FPaths::ProfilingDir() / TEXT("PerfHistory") / FString::Printf(TEXT("PerfHistory_%s.%s"), *FDateTime::Now().ToString(), bExportJson ? TEXT("jsonl") : TEXT("csv"));
+		ExportWriter.Reset(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_AllowRead));
+		if (ExportWriter.IsValid())
+		{
+			UE_LOG(LogLyra, Log, TEXT("Exporting performance stat percentiles every %.0f seconds to %s"), IntervalSeconds, *FPaths::ConvertRelativePathToFull(Filename));
+
+			if (!bExportJson)
+			{
+				WriteExportLine(TEXT("Time,WindowSeconds,Stat,Samples,P50,P95,P99,Max"));
+			}
+		}
+		else
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Failed to create performance stat history file %s"), *Filename);
+		}
+	}
+
+	bActive = true;
+}
+
+void FLyraPerformanceStatHistory::Stop()
+{
+	if (bActive && ExportWriter.IsValid())
+	{
+		// Don't lose the samples of the last (partial) interval
+		CloseInterval(FPlatformTime::Seconds());
+	}
+
+	ExportWriter.Reset();
+	ClosedIntervals.Reset();
+	bActive = false;
+}
+
+void FLyraPerformanceStatHistory::RecordStat(const ELyraDisplayablePerformanceStat Stat, const double Value)
+{
+	CurrentInterval.Sketches[(int32)Stat].RecordSample(Value);
+}
+
+void FLyraPerformanceStatHistory::Tick(const double CurrentTime)
+{
+	if ((CurrentTime - CurrentInterval.StartTime) >= IntervalSeconds)
+	{
+		CloseInterval(CurrentTime);
+	}
+}
+
+void FLyraPerformanceStatHistory::CloseInterval(const double CurrentTime)
+{
+	if (ClosedIntervals.Num() >= WindowIntervals.Last())
+	{
+		// Only the longest window's worth of intervals is kept around
+		ClosedIntervals.RemoveAt(0, ClosedIntervals.Num() - WindowIntervals.Last() + 1, EAllowShrinking::No);
+	}
+	ClosedIntervals.Add(MoveTemp(CurrentInterval));
+
+	CurrentInterval = FInterval();
+	CurrentInterval.StartTime = CurrentTime;
+
+	if (ExportWriter.IsValid())
+	{
+		ExportIntervals();
+	}
+}
+
+void FLyraPerformanceStatHistory::BuildWindow(const int32 NumIntervals, TStaticArray<FLyraStatPercentileSketch, (int32)ELyraDisplayablePerformanceStat::Count>& OutSketches) const
+{
+	for (FLyraStatPercentileSketch& Sketch : OutSketches)
+	{
+		Sketch.Reset();
+	}
+
+	const int32 FirstInterval = FMath::Max(0, ClosedIntervals.Num() - NumIntervals);
+	for (int32 IntervalIndex = FirstInterval; IntervalIndex < ClosedIntervals.Num(); ++IntervalIndex)
+	{
+		for (int32 StatIndex = 0; StatIndex < OutSketches.Num(); ++StatIndex)
+		{
+			OutSketches[StatIndex].Merge(ClosedIntervals[IntervalIndex].Sketches[StatIndex]);
+		}
+	}
+}
+
+void FLyraPerformanceStatHistory::ExportIntervals()
+{
+	const FString Time = FDateTime::UtcNow().ToIso8601();
+
+	FString JsonLine;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonLine);
+	if (bExportJson)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("time"), Time);
+		JsonWriter->WriteArrayStart(TEXT("windows"));
+	}
+
+	TStaticArray<FLyraStatPercentileSketch, (int32)ELyraDisplayablePerformanceStat::Count> WindowSketches;
+	for (const int32 NumIntervals : WindowIntervals)
+	{
+		BuildWindow(NumIntervals, WindowSketches);
+
+		const double WindowSeconds = NumIntervals * IntervalSeconds;
+		if (bExportJson)
+		{
+			JsonWriter->WriteObjectStart();
+			JsonWriter->WriteValue(TEXT("seconds"), WindowSeconds);
+			JsonWriter->WriteObjectStart(TEXT("stats"));
+		}
+
+		for (ELyraDisplayablePerformanceStat Stat : TEnumRange<ELyraDisplayablePerformanceStat>())
+		{
+			const FLyraStatPercentileSketch& Sketch = WindowSketches[(int32)Stat];
+			if (Sketch.GetNumSamples() == 0)
+			{
+				continue;
+			}
+
+			if (bExportJson)
+			{
+				JsonWriter->WriteObjectStart(LyraPerformanceStats::GetStatName(Stat));
+				JsonWriter->WriteValue(TEXT("samples"), (int64)Sketch.GetNumSamples());
+				JsonWriter->WriteValue(TEXT("p50"), Sketch.GetPercentile(0.50));
+				JsonWriter->WriteValue(TEXT("p95"), Sketch.GetPercentile(0.95));
+				JsonWriter->WriteValue(TEXT("p99"), Sketch.GetPercentile(0.99));
+				JsonWriter->WriteValue(TEXT("max"), Sketch.GetMax());
+				JsonWriter->WriteObjectEnd();
+			}
+			else
+			{
+				WriteExportLine(FString::Printf(TEXT("%s,%.0f,%s,%llu,%g,%g,%g,%g"),
+					*Time, WindowSeconds, *LyraPerformanceStats::GetStatName(Stat), Sketch.GetNumSamples(),
+					Sketch.GetPercentile(0.50), Sketch.GetPercentile(0.95), Sketch.GetPercentile(0.99), Sketch.GetMax()));
+			}
+		}
+
+		if (bExportJson)
+		{
+			JsonWriter->WriteObjectEnd();
+			JsonWriter->WriteObjectEnd();
+		}
+	}
+
+	if (bExportJson)
+	{
+		JsonWriter->WriteArrayEnd();
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+		WriteExportLine(JsonLine);
+	}
+
+	ExportWriter->Flush();
+}
+
+void FLyraPerformanceStatHistory::WriteExportLine(const FString& Line)
+{
+	FTCHARToUTF8 UTF8Line(*(Line + LINE_TERMINATOR_ANSI));
+	ExportWriter->Serialize(const_cast<ANSICHAR*>(UTF8Line.Get()), UTF8Line.Length());
+}
+
+void FLyraPerformanceStatHistory::LogHistory() const
+{
+	if (!bActive)
+	{
+		UE_LOG(LogLyra, Log, TEXT("Performance stat history is not recording (see lyra.PerfStats.History)"));
+		return;
+	}
+
+	TStaticArray<FLyraStatPercentileSketch, (int32)ELyraDisplayablePerformanceStat::Count> WindowSketches;
+	for (const int32 NumIntervals : WindowIntervals)
+	{
+		BuildWindow(NumIntervals, WindowSketches);
+
+		UE_LOG(LogLyra, Log, TEXT("Performance stats over the last %.0f seconds:"), FMath::Min(NumIntervals, ClosedIntervals.Num()) * IntervalSeconds);
+		for (ELyraDisplayablePerformanceStat Stat : TEnumRange<ELyraDisplayablePerformanceStat>())
+		{
+			const FLyraStatPercentileSketch& Sketch = WindowSketches[(int32)Stat];
+			if (Sketch.GetNumSamples() > 0)
+			{
+				UE_LOG(LogLyra, Log, TEXT("  %-24s samples=%-8llu p50=%-10g p95=%-10g p99=%-10g max=%g"),
+					*LyraPerformanceStats::GetStatName(Stat), Sketch.GetNumSamples(),
+					Sketch.GetPercentile(0.50), Sketch.GetPercentile(0.95), Sketch.GetPercentile(0.99), Sketch.GetMax());
+			}
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 // FLyraPerformanceStatCache
 
 void FLyraPerformanceStatCache::StartCharting()
 {
+	IModularFeatures& ModularFeatures = IModularFeatures::Get();
+	ModularFeatures.OnModularFeatureRegistered().AddRaw(this, &FLyraPerformanceStatCache::HandleModularFeatureChanged);
+	ModularFeatures.OnModularFeatureUnregistered().AddRaw(this, &FLyraPerformanceStatCache::HandleModularFeatureChanged);
+	RefreshLatencyMarkerModules();
+
+	const int32 HistoryMode = LyraConsoleVariables::PerfStatHistoryMode;
+	if ((HistoryMode == 1) || ((HistoryMode == 2) && IsRunningDedicatedServer()))
+	{
+		History.Start();
+	}
+
+	HitchDetector.Start();
 }
 
 void FLyraPerformanceStatCache::ProcessFrame(const FFrameData& FrameData)
@@ -43,6 +344,23 @@ void FLyraPerformanceStatCache::ProcessFrame(const FFrameData& FrameData)
 		RecordStat(ELyraDisplayablePerformanceStat::FrameTime_GPU, FrameData.GPUTimeSeconds);	
 	}
 
+	if (History.IsActive())
+	{
+		History.Tick(FPlatformTime::Seconds());
+	}
+
+	if (HitchDetector.IsActive())
+	{
+		HitchDetector.RecordFrame(FrameData);
+	}
+
+	if (const UGameplayMessageSubsystem* MessageSubsystem = MySubsystem->GetGameInstance()->GetSubsystem<UGameplayMessageSubsystem>())
+	{
+		const uint64 GameplayMessageCycles = MessageSubsystem->GetTotalCallbackCycles();
+		RecordStat(ELyraDisplayablePerformanceStat::GameplayMessageTime, FPlatformTime::ToSeconds64(GameplayMessageCycles - LastGameplayMessageCycles));
+		LastGameplayMessageCycles = GameplayMessageCycles;
+	}
+
 	if (UWorld* World = MySubsystem->GetGameInstance()->GetWorld())
 	{
 		// Record some networking related stats
@@ -74,7 +392,6 @@ void FLyraPerformanceStatCache::ProcessFrame(const FFrameData& FrameData)
 			}
 			
 			// Finally, record some input latency related stats if they are enabled
-			TArray<ILatencyMarkerModule*> LatencyMarkerModules = IModularFeatures::Get().GetModularFeatureImplementations<ILatencyMarkerModule>(ILatencyMarkerModule::GetModularFeatureName());
 			for (ILatencyMarkerModule* LatencyMarkerModule : LatencyMarkerModules)
 			{
 				if (LatencyMarkerModule->GetEnabled())
@@ -126,11 +443,36 @@ void FLyraPerformanceStatCache::ProcessFrame(const FFrameData& FrameData)
 
 void FLyraPerformanceStatCache::StopCharting()
 {
+	History.Stop();
+	HitchDetector.Stop();
+
+	IModularFeatures& ModularFeatures = IModularFeatures::Get();
+	ModularFeatures.OnModularFeatureRegistered().RemoveAll(this);
+	ModularFeatures.OnModularFeatureUnregistered().RemoveAll(this);
+	LatencyMarkerModules.Reset();
 }
 
 void FLyraPerformanceStatCache::RecordStat(const ELyraDisplayablePerformanceStat Stat, const double Value)
 {
 	PerfStateCache.FindOrAdd(Stat).RecordSample(Value);
+
+	if (History.IsActive())
+	{
+		History.RecordStat(Stat, Value);
+	}
+}
+
+void FLyraPerformanceStatCache::RefreshLatencyMarkerModules()
+{
+	LatencyMarkerModules = IModularFeatures::Get().GetModularFeatureImplementations<ILatencyMarkerModule>(ILatencyMarkerModule::GetModularFeatureName());
+}
+
+void FLyraPerformanceStatCache::HandleModularFeatureChanged(const FName& Type, IModularFeature* ModularFeature)
+{
+	if (Type == ILatencyMarkerModule::GetModularFeatureName())
+	{
+		RefreshLatencyMarkerModules();
+	}
 }
 
 double FLyraPerformanceStatCache::GetCachedStat(ELyraDisplayablePerformanceStat Stat) const
@@ -177,3 +519,8 @@ const FSampledStatCache* ULyraPerformanceStatSubsystem::GetCachedStatData(const
 	return Tracker->GetCachedStatData(Stat);
 }
 
+void ULyraPerformanceStatSubsystem::LogStatHistory() const
+{
+	Tracker->GetHistory().LogHistory();
+}
+
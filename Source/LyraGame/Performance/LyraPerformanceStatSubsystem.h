@@ -4,8 +4,10 @@
 
 #include "ChartCreation.h"
 #include "LyraPerformanceStatTypes.h"
+#include "Performance/LyraHitchDetector.h"
 #include "Algo/MaxElement.h"
 #include "Algo/MinElement.h"
+#include "Containers/StaticArray.h"
 #include "Stats/StatsData.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 
@@ -13,7 +15,10 @@
 
 enum class ELyraDisplayablePerformanceStat : uint8;
 
+class FArchive;
 class FSubsystemCollectionBase;
+class ILatencyMarkerModule;
+class IModularFeature;
 class ULyraPerformanceStatSubsystem;
 class UObject;
 struct FFrame;
@@ -119,6 +124,195 @@ private:
 
 //////////////////////////////////////////////////////////////////////
 
+/**
+ * Streaming percentile sketch with a bounded relative error.
+ * Samples are counted in logarithmically sized buckets, so memory depends on the range of the values
+ * seen rather than on the number of samples, and sketches can be merged to cover longer windows.
+ */
+class FLyraStatPercentileSketch
+{
+public:
+	// Relative error of the reported percentiles
+	static constexpr double RelativeAccuracy = 0.01;
+
+	// Samples at or below this value are counted as zero
+	static constexpr double MinTrackedValue = 1e-9;
+
+	void RecordSample(const double Sample)
+	{
+		MaxSample = (NumSamples == 0) ? Sample : FMath::Max(MaxSample, Sample);
+		++NumSamples;
+
+		if (Sample <= MinTrackedValue)
+		{
+			++NumZeroSamples;
+			return;
+		}
+
+		AddToBucket(GetBucketIndex(Sample), 1);
+	}
+
+	void Merge(const FLyraStatPercentileSketch& Other)
+	{
+		if (Other.NumSamples == 0)
+		{
+			return;
+		}
+
+		MaxSample = (NumSamples == 0) ? Other.MaxSample : FMath::Max(MaxSample, Other.MaxSample);
+		NumSamples += Other.NumSamples;
+		NumZeroSamples += Other.NumZeroSamples;
+
+		for (int32 Index = 0; Index < Other.Buckets.Num(); ++Index)
+		{
+			if (Other.Buckets[Index] > 0)
+			{
+				AddToBucket(Other.FirstBucket + Index, Other.Buckets[Index]);
+			}
+		}
+	}
+
+	void Reset()
+	{
+		Buckets.Reset();
+		FirstBucket = 0;
+		NumSamples = 0;
+		NumZeroSamples = 0;
+		MaxSample = 0.0;
+	}
+
+	/** Returns the value below which the given fraction (0-1) of the samples fall */
+	double GetPercentile(const double Fraction) const
+	{
+		if (NumSamples == 0)
+		{
+			return 0.0;
+		}
+
+		const uint64 Rank = (uint64)(FMath::Clamp(Fraction, 0.0, 1.0) * (double)(NumSamples - 1));
+		uint64 NumSeen = NumZeroSamples;
+		if (Rank < NumSeen)
+		{
+			return 0.0;
+		}
+
+		for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+		{
+			NumSeen += Buckets[Index];
+			if (Rank < NumSeen)
+			{
+				return FMath::Min(GetBucketValue(FirstBucket + Index), MaxSample);
+			}
+		}
+
+		return MaxSample;
+	}
+
+	inline uint64 GetNumSamples() const { return NumSamples; }
+	inline double GetMax() const { return MaxSample; }
+
+private:
+	static double GetLogGamma()
+	{
+		static const double LogGamma = FMath::Loge((1.0 + RelativeAccuracy) / (1.0 - RelativeAccuracy));
+		return LogGamma;
+	}
+
+	static int32 GetBucketIndex(const double Value)
+	{
+		return FMath::CeilToInt32(FMath::Loge(Value) / GetLogGamma());
+	}
+
+	// Value in the middle (relative error wise) of the bucket
+	static double GetBucketValue(const int32 BucketIndex)
+	{
+		const double LogGamma = GetLogGamma();
+		return 2.0 * FMath::Exp(BucketIndex * LogGamma) / (FMath::Exp(LogGamma) + 1.0);
+	}
+
+	void AddToBucket(const int32 BucketIndex, const uint32 Count)
+	{
+		if (Buckets.Num() == 0)
+		{
+			FirstBucket = BucketIndex;
+			Buckets.Add(0);
+		}
+		else if (BucketIndex < FirstBucket)
+		{
+			Buckets.InsertZeroed(0, FirstBucket - BucketIndex);
+			FirstBucket = BucketIndex;
+		}
+		else if (BucketIndex >= FirstBucket + Buckets.Num())
+		{
+			Buckets.AddZeroed(BucketIndex - FirstBucket - Buckets.Num() + 1);
+		}
+
+		Buckets[BucketIndex - FirstBucket] += Count;
+	}
+
+	// Sample counts for the contiguous range of buckets seen so far, starting at FirstBucket
+	TArray<uint32> Buckets;
+	int32 FirstBucket = 0;
+
+	uint64 NumSamples = 0;
+	uint64 NumZeroSamples = 0;
+	double MaxSample = 0.0;
+};
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * Long-running percentile history of the performance stats.
+ * Samples are accumulated into fixed length intervals, and every time an interval ends the p50/p95/p99/max
+ * of each stat is computed over windows made of the most recent intervals, and optionally exported to disk.
+ */
+class FLyraPerformanceStatHistory
+{
+public:
+	void Start();
+	void Stop();
+
+	bool IsActive() const { return bActive; }
+
+	void RecordStat(const ELyraDisplayablePerformanceStat Stat, const double Value);
+
+	/** Closes the current interval when it is over */
+	void Tick(const double CurrentTime);
+
+	/** Writes the percentiles of every window to the log */
+	void LogHistory() const;
+
+private:
+	struct FInterval
+	{
+		TStaticArray<FLyraStatPercentileSketch, (int32)ELyraDisplayablePerformanceStat::Count> Sketches;
+		double StartTime = 0.0;
+	};
+
+	void CloseInterval(const double CurrentTime);
+	void BuildWindow(const int32 NumIntervals, TStaticArray<FLyraStatPercentileSketch, (int32)ELyraDisplayablePerformanceStat::Count>& OutSketches) const;
+	void ExportIntervals();
+	void WriteExportLine(const FString& Line);
+
+	// The interval being recorded
+	FInterval CurrentInterval;
+
+	// The most recently closed intervals, oldest first
+	TArray<FInterval> ClosedIntervals;
+
+	// Length of each window, in intervals
+	TArray<int32> WindowIntervals;
+
+	double IntervalSeconds = 10.0;
+
+	TUniquePtr<FArchive> ExportWriter;
+	bool bExportJson = false;
+
+	bool bActive = false;
+};
+
+//////////////////////////////////////////////////////////////////////
+
 // Observer which caches the stats for the previous frame
 struct FLyraPerformanceStatCache : public IPerformanceDataConsumer
 {
@@ -146,9 +340,15 @@ public:
 	 */
 	const FSampledStatCache* GetCachedStatData(const ELyraDisplayablePerformanceStat Stat) const;
 
+	/** Returns the long-running percentile history, which is only recording when IsActive */
+	const FLyraPerformanceStatHistory& GetHistory() const { return History; }
+
 protected:
 
 	void RecordStat(const ELyraDisplayablePerformanceStat Stat, const double Value);
+
+	void RefreshLatencyMarkerModules();
+	void HandleModularFeatureChanged(const FName& Type, IModularFeature* ModularFeature);
 	
 	ULyraPerformanceStatSubsystem* MySubsystem;
 
@@ -156,6 +356,16 @@ protected:
 	 * Caches the sampled data for each of the performance stats currently available
 	 */
 	TMap<ELyraDisplayablePerformanceStat, FSampledStatCache> PerfStateCache;
+
+	FLyraPerformanceStatHistory History;
+
+	FLyraHitchDetector HitchDetector;
+
+	// Cached list of latency marker modules, refreshed when modular features are (un)registered
+	TArray<ILatencyMarkerModule*> LatencyMarkerModules;
+
+	// Gameplay message callback time at the end of the previous frame
+	uint64 LastGameplayMessageCycles = 0;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -172,6 +382,9 @@ public:
 
 	const FSampledStatCache* GetCachedStatData(const ELyraDisplayablePerformanceStat Stat) const;
 
+	/** Writes the long-running percentile history to the log (see lyra.PerfStats.History) */
+	void LogStatHistory() const;
+
 	//~USubsystem interface
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
@@ -86,6 +86,9 @@ enum class ELyraDisplayablePerformanceStat : uint8
 	// OS render queue start to GPU render end
 	Latency_Render,
 
+	// Time spent in gameplay message listener callbacks (in seconds)
+	GameplayMessageTime,
+
 	// New stats should go above here
 	Count UMETA(Hidden)
 };
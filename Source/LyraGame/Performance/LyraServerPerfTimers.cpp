@@ -0,0 +1,238 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Performance/LyraServerPerfTimers.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+bool GLyraServerPerfTimersEnabled = true;
+
+namespace LyraConsoleVariables
+{
+	static FAutoConsoleVariableRef CVarServerPerfTimers(
+		TEXT("lyra.ServerPerf.Timers"),
+		GLyraServerPerfTimersEnabled,
+		TEXT("Should the scoped server performance timers record (queried with lyra.ServerPerf.Dump or the /server/perf RPC)?"),
+		ECVF_Default);
+}
+
+namespace LyraServerPerfTimers
+{
+	static constexpr int32 NumTimers = (int32)ELyraServerPerfTimer::Count;
+	static constexpr int32 HistorySize = 128;
+
+	// Totals accumulated by a single thread. Only the owning thread writes, the game thread reads.
+	struct FThreadBuffer
+	{
+		std::atomic<uint64> Cycles[NumTimers] = {};
+		std::atomic<uint64> Calls[NumTimers] = {};
+	};
+
+	// Every thread buffer ever created. Buffers are never freed (there are as many as threads that ran a timer),
+	// so the game thread can keep reading them after their thread exits.
+	static FCriticalSection ThreadBuffersLock;
+	static TArray<FThreadBuffer*> ThreadBuffers;
+
+	static FThreadBuffer* RegisterThreadBuffer()
+	{
+		FThreadBuffer* Buffer = new FThreadBuffer();
+
+		FScopeLock Lock(&ThreadBuffersLock);
+		ThreadBuffers.Add(Buffer);
+		return Buffer;
+	}
+
+	static void GatherTotals(uint64 (&OutCycles)[NumTimers], uint64 (&OutCalls)[NumTimers])
+	{
+		FMemory::Memzero(OutCycles);
+		FMemory::Memzero(OutCalls);
+
+		FScopeLock Lock(&ThreadBuffersLock);
+		for (const FThreadBuffer* Buffer : ThreadBuffers)
+		{
+			for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+			{
+				OutCycles[TimerIndex] += Buffer->Cycles[TimerIndex].load(std::memory_order_relaxed);
+				OutCalls[TimerIndex] += Buffer->Calls[TimerIndex].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Game thread only
+	struct FHistory
+	{
+		uint64 LastCycles[NumTimers] = {};
+		uint64 LastCalls[NumTimers] = {};
+		uint64 LastFrameCycles = 0;
+
+		uint64 FrameCycles[HistorySize][NumTimers] = {};
+		uint32 FrameCalls[HistorySize][NumTimers] = {};
+		uint64 FrameTimes[HistorySize] = {};
+
+		int32 NextFrame = 0;
+		int32 NumFrames = 0;
+	};
+	static FHistory History;
+
+	static FDelegateHandle EndFrameHandle;
+
+	static void DumpTimers()
+	{
+		double AvgFrameMs, MaxFrameMs;
+		FLyraServerPerfTimers::GetFrameTimeStats(AvgFrameMs, MaxFrameMs);
+
+		UE_LOG(LogLyra, Log, TEXT("Server perf timers over the last %d frames (frame avg %.2f ms, max %.2f ms):"), FLyraServerPerfTimers::GetNumSampledFrames(), AvgFrameMs, MaxFrameMs);
+		for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+		{
+			const ELyraServerPerfTimer Timer = (ELyraServerPerfTimer)TimerIndex;
+			const FLyraServerPerfTimerStats Stats = FLyraServerPerfTimers::GetTimerStats(Timer);
+			UE_LOG(LogLyra, Log, TEXT("  %-24s avg %.3f ms  max %.3f ms  calls %.1f"), FLyraServerPerfTimers::GetTimerName(Timer), Stats.AvgMsPerFrame, Stats.MaxMsPerFrame, Stats.AvgCallsPerFrame);
+		}
+	}
+
+	static FAutoConsoleCommand DumpCommand(
+		TEXT("lyra.ServerPerf.Dump"),
+		TEXT("Writes the per-frame cost of the server performance timers to the log"),
+		FConsoleCommandDelegate::CreateStatic(&DumpTimers));
+}
+
+void FLyraServerPerfTimers::Startup()
+{
+	using namespace LyraServerPerfTimers;
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FLyraServerPerfTimers::SampleFrame);
+}
+
+void FLyraServerPerfTimers::Shutdown()
+{
+	using namespace LyraServerPerfTimers;
+
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+}
+
+void FLyraServerPerfTimers::AddTime(ELyraServerPerfTimer Timer, uint64 Cycles)
+{
+	using namespace LyraServerPerfTimers;
+
+	thread_local FThreadBuffer* ThreadBuffer = RegisterThreadBuffer();
+
+	// Single writer, so a relaxed load/store pair is enough (no read-modify-write needed)
+	const int32 TimerIndex = (int32)Timer;
+	ThreadBuffer->Cycles[TimerIndex].store(ThreadBuffer->Cycles[TimerIndex].load(std::memory_order_relaxed) + Cycles, std::memory_order_relaxed);
+	ThreadBuffer->Calls[TimerIndex].store(ThreadBuffer->Calls[TimerIndex].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void FLyraServerPerfTimers::SampleFrame()
+{
+	using namespace LyraServerPerfTimers;
+
+	uint64 TotalCycles[NumTimers];
+	uint64 TotalCalls[NumTimers];
+	GatherTotals(TotalCycles, TotalCalls);
+
+	const uint64 CurrentFrameCycles = FPlatformTime::Cycles64();
+	if (History.LastFrameCycles != 0)
+	{
+		const int32 FrameIndex = History.NextFrame;
+		for (int32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+		{
+			History.FrameCycles[FrameIndex][TimerIndex] = TotalCycles[TimerIndex] - History.LastCycles[TimerIndex];
+			History.FrameCalls[FrameIndex][TimerIndex] = (uint32)(TotalCalls[TimerIndex] - History.LastCalls[TimerIndex]);
+		}
+		History.FrameTimes[FrameIndex] = CurrentFrameCycles - History.LastFrameCycles;
+
+		History.NextFrame = (History.NextFrame + 1) % HistorySize;
+		History.NumFrames = FMath::Min(History.NumFrames + 1, HistorySize);
+	}
+
+	FMemory::Memcpy(History.LastCycles, TotalCycles, sizeof(TotalCycles));
+	FMemory::Memcpy(History.LastCalls, TotalCalls, sizeof(TotalCalls));
+	History.LastFrameCycles = CurrentFrameCycles;
+}
+
+const TCHAR* FLyraServerPerfTimers::GetTimerName(ELyraServerPerfTimer Timer)
+{
+	switch (Timer)
+	{
+	case ELyraServerPerfTimer::ReplicationGraphGather: return TEXT("ReplicationGraphGather");
+	case ELyraServerPerfTimer::AbilityActivation: return TEXT("AbilityActivation");
+	case ELyraServerPerfTimer::DamageExecution: return TEXT("DamageExecution");
+	case ELyraServerPerfTimer::AIServices: return TEXT("AIServices");
+	case ELyraServerPerfTimer::MeleeHits: return TEXT("MeleeHits");
+	case ELyraServerPerfTimer::GlobalAbilityApply: return TEXT("GlobalAbilityApply");
+	default: return TEXT("Unknown");
+	}
+}
+
+int32 FLyraServerPerfTimers::GetNumSampledFrames()
+{
+	return LyraServerPerfTimers::History.NumFrames;
+}
+
+FLyraServerPerfTimerStats FLyraServerPerfTimers::GetTimerStats(ELyraServerPerfTimer Timer)
+{
+	using namespace LyraServerPerfTimers;
+
+	FLyraServerPerfTimerStats Stats;
+	if (History.NumFrames == 0)
+	{
+		return Stats;
+	}
+
+	const int32 TimerIndex = (int32)Timer;
+	uint64 SumCycles = 0;
+	uint64 MaxCycles = 0;
+	uint64 SumCalls = 0;
+	for (int32 FrameIndex = 0; FrameIndex < History.NumFrames; ++FrameIndex)
+	{
+		SumCycles += History.FrameCycles[FrameIndex][TimerIndex];
+		MaxCycles = FMath::Max(MaxCycles, History.FrameCycles[FrameIndex][TimerIndex]);
+		SumCalls += History.FrameCalls[FrameIndex][TimerIndex];
+	}
+
+	Stats.AvgMsPerFrame = FPlatformTime::ToMilliseconds64(SumCycles) / History.NumFrames;
+	Stats.MaxMsPerFrame = FPlatformTime::ToMilliseconds64(MaxCycles);
+	Stats.AvgCallsPerFrame = (double)SumCalls / History.NumFrames;
+	return Stats;
+}
+
+void FLyraServerPerfTimers::GetFrameTimeStats(double& OutAvgMs, double& OutMaxMs)
+{
+	using namespace LyraServerPerfTimers;
+
+	OutAvgMs = 0.0;
+	OutMaxMs = 0.0;
+	if (History.NumFrames == 0)
+	{
+		return;
+	}
+
+	uint64 SumCycles = 0;
+	uint64 MaxCycles = 0;
+	for (int32 FrameIndex = 0; FrameIndex < History.NumFrames; ++FrameIndex)
+	{
+		SumCycles += History.FrameTimes[FrameIndex];
+		MaxCycles = FMath::Max(MaxCycles, History.FrameTimes[FrameIndex]);
+	}
+
+	OutAvgMs = FPlatformTime::ToMilliseconds64(SumCycles) / History.NumFrames;
+	OutMaxMs = FPlatformTime::ToMilliseconds64(MaxCycles);
+}
+
+void FLyraServerPerfTimers::GetTotalCycles(TArrayView<uint64> OutCycles)
+{
+	using namespace LyraServerPerfTimers;
+
+	check(OutCycles.Num() == NumTimers);
+
+	uint64 TotalCycles[NumTimers];
+	uint64 TotalCalls[NumTimers];
+	GatherTotals(TotalCycles, TotalCalls);
+
+	FMemory::Memcpy(OutCycles.GetData(), TotalCycles, sizeof(TotalCycles));
+}
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "HAL/Platform.h"
+#include "Containers/ArrayView.h"
+#include "HAL/PlatformTime.h"
+
+#define UE_API LYRAGAME_API
+
+// Whether the timers record, driven by lyra.ServerPerf.Timers
+extern UE_API bool GLyraServerPerfTimersEnabled;
+
+/** Hot paths measured by the server performance timers */
+enum class ELyraServerPerfTimer : uint8
+{
+	// Replication graph per-connection gather (always relevant and player state nodes)
+	ReplicationGraphGather,
+
+	// Lyra gameplay ability activation
+	AbilityActivation,
+
+	// Damage gameplay effect executions
+	DamageExecution,
+
+	// Behavior tree services of the AI bots
+	AIServices,
+
+	// Processing of the hits reported by melee traces
+	MeleeHits,
+
+	// Global abilities and effects given to the registered ability systems
+	GlobalAbilityApply,
+
+	Count
+};
+
+/** Cost of a timer over the recently sampled frames */
+struct FLyraServerPerfTimerStats
+{
+	double AvgMsPerFrame = 0.0;
+	double MaxMsPerFrame = 0.0;
+	double AvgCallsPerFrame = 0.0;
+};
+
+/**
+ * FLyraServerPerfTimers
+ *
+ * Always-on (including shipping server builds) scoped timers for Lyra hot paths, so the per-subsystem frame
+ * cost of a live server can be queried without attaching a profiler.
+ * Each thread accumulates into its own buffer, so timing a scope never takes a lock or touches a cache line
+ * shared with another thread. At the end of every frame the game thread folds all of the buffers into a short
+ * per-frame history, which is what the queries report on.
+ */
+class FLyraServerPerfTimers
+{
+public:
+	static void Startup();
+	static void Shutdown();
+
+	static bool IsEnabled() { return GLyraServerPerfTimersEnabled; }
+
+	/** Adds the time spent in one call of a timer, from the calling thread */
+	static UE_API void AddTime(ELyraServerPerfTimer Timer, uint64 Cycles);
+
+	static UE_API const TCHAR* GetTimerName(ELyraServerPerfTimer Timer);
+
+	/** Number of frames the stats are computed over (at most the history size) */
+	static UE_API int32 GetNumSampledFrames();
+
+	static UE_API FLyraServerPerfTimerStats GetTimerStats(ELyraServerPerfTimer Timer);
+
+	/** Average and worst frame time over the sampled frames, in milliseconds */
+	static UE_API void GetFrameTimeStats(double& OutAvgMs, double& OutMaxMs);
+
+	/** Cycles spent in each timer (indexed by ELyraServerPerfTimer) since startup, summed over all threads */
+	static UE_API void GetTotalCycles(TArrayView<uint64> OutCycles);
+
+private:
+	static void SampleFrame();
+};
+
+/** Times the enclosing scope. Scopes of the same timer must not be nested, as they would be counted twice. */
+class FLyraScopedServerPerfTimer
+{
+public:
+	explicit FLyraScopedServerPerfTimer(ELyraServerPerfTimer InTimer)
+		: Timer(InTimer)
+		, StartCycles(FLyraServerPerfTimers::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FLyraScopedServerPerfTimer()
+	{
+		if (StartCycles != 0)
+		{
+			FLyraServerPerfTimers::AddTime(Timer, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	ELyraServerPerfTimer Timer;
+	uint64 StartCycles;
+};
+
+#define LYRA_SERVER_PERF_SCOPE(TimerName) FLyraScopedServerPerfTimer ANONYMOUS_VARIABLE(LyraServerPerfScope)(ELyraServerPerfTimer::TimerName)
+
+#undef UE_API
@@ -201,6 +201,14 @@ void ULyraGameSettingRegistry::AddPerformanceStatPage(UGameSettingCollection* Pe
 				StatCategory_Performance->AddSetting(Setting);
 			}
 			//----------------------------------------------------------------------------------
+			{
+				ULyraSettingValueDiscrete_PerfStat* Setting = NewObject<ULyraSettingValueDiscrete_PerfStat>();
+				Setting->SetStat(ELyraDisplayablePerformanceStat::GameplayMessageTime);
+				Setting->SetDisplayName(LOCTEXT("PerfStat_GameplayMessageTime", "Gameplay Message Time"));
+				Setting->SetDescriptionRichText(LOCTEXT("PerfStatDescription_GameplayMessageTime", "The amount of time spent handling gameplay messages (UI, accolades, etc...). Use GameplayMessageSubsystem.Stats.Dump for a breakdown."));
+				StatCategory_Performance->AddSetting(Setting);
+			}
+			//----------------------------------------------------------------------------------
 		}
 
 		// Network stats
@@ -12,6 +12,7 @@
 #include "AbilitySystem/LyraGameplayCueManager.h"
 #include "Misc/ScopedSlowTask.h"
 #include "System/LyraAssetManagerStartupJob.h"
+#include "Tasks/Task.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraAssetManager)
 
@@ -25,6 +26,28 @@ static FAutoConsoleCommand CVarDumpLoadedAssets(
 	FConsoleCommandDelegate::CreateStatic(ULyraAssetManager::DumpLoadedAssets)
 );
 
+static FAutoConsoleCommand CVarDumpStartupJobTimings(
+	TEXT("Lyra.DumpStartupJobTimings"),
+	TEXT("Shows when each asset manager startup job started and how long it took."),
+	FConsoleCommandDelegate::CreateStatic(ULyraAssetManager::DumpStartupJobTimings)
+);
+
+namespace LyraConsoleVariables
+{
+	static bool bParallelStartupJobs = true;
+	static FAutoConsoleVariableRef CVarParallelStartupJobs(
+		TEXT("lyra.AssetManager.ParallelStartupJobs"),
+		bParallelStartupJobs,
+		TEXT("Should independent startup jobs run concurrently (overlapping their async loads, and running thread safe jobs on worker threads)? If false they run one after another."),
+		ECVF_Default);
+}
+
+namespace LyraStartupJobs
+{
+	// How long to process async loading between progress updates while waiting for running jobs
+	static constexpr double WaitSliceSeconds = 1.0 / 30.0;
+}
+
 //////////////////////////////////////////////////////////////////////
 
 #define STARTUP_JOB_WEIGHTED(JobFunc, JobWeight) StartupJobs.Add(FLyraAssetManagerStartupJob(#JobFunc, [this](const FLyraAssetManagerStartupJob& StartupJob, TSharedPtr<FStreamableHandle>& LoadHandle){JobFunc;}, JobWeight))
@@ -110,11 +133,14 @@ void ULyraAssetManager::StartInitialLoading()
 	// This does all of the scanning, need to do this now even if loads are deferred
 	Super::StartInitialLoading();
 
+	// Start streaming the base game data in first, so it loads while the other jobs run
+	const int32 LoadGameDataJob = STARTUP_JOB_WEIGHTED(LoadHandle = StartLoadingGameData(), 24.f);
+
 	STARTUP_JOB(InitializeGameplayCueManager());
 
 	{
 		// Load base game data asset
-		STARTUP_JOB_WEIGHTED(GetGameData(), 25.f);
+		StartupJobs[STARTUP_JOB(GetGameData())].AddDependency(LoadGameDataJob);
 	}
 
 	// Run all the queued up startup jobs
@@ -136,6 +162,17 @@ const ULyraGameData& ULyraAssetManager::GetGameData()
 	return GetOrLoadTypedGameData<ULyraGameData>(LyraGameDataPath);
 }
 
+TSharedPtr<FStreamableHandle> ULyraAssetManager::StartLoadingGameData()
+{
+	// The editor loads game data synchronously (see LoadGameDataOfClass)
+	if (GIsEditor || LyraGameDataPath.IsNull() || GameDataMap.Contains(ULyraGameData::StaticClass()))
+	{
+		return nullptr;
+	}
+
+	return LoadPrimaryAssetsWithType(ULyraGameData::StaticClass()->GetFName());
+}
+
 const ULyraPawnData* ULyraAssetManager::GetDefaultPawnData() const
 {
 	return GetAsset(DefaultPawnData);
@@ -195,54 +232,205 @@ void ULyraAssetManager::DoAllStartupJobs()
 	SCOPED_BOOT_TIMING("ULyraAssetManager::DoAllStartupJobs");
 	const double AllStartupJobsStartTime = FPlatformTime::Seconds();
 
-	if (IsRunningDedicatedServer())
+	// No need for periodic progress updates on dedicated servers
+	const bool bReportProgress = !IsRunningDedicatedServer();
+
+	enum class EJobState : uint8
+	{
+		Pending,
+		Running,
+		Done
+	};
+
+	struct FJobState
 	{
-		// No need for periodic progress updates, just run the jobs
-		for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+		TSharedPtr<FStreamableHandle> Handle;
+		UE::Tasks::FTask Task;
+		double StartTime = 0.0;
+		float Progress = 0.0f;
+		EJobState State = EJobState::Pending;
+
+		bool IsFinished() const
 		{
-			StartupJob.DoJob();
+			return (!Handle.IsValid() || !Handle->IsLoadingInProgress()) && Task.IsCompleted();
 		}
+	};
+
+	const int32 NumJobs = StartupJobs.Num();
+	TArray<FJobState> JobStates;
+	JobStates.SetNum(NumJobs);
+
+	StartupJobTimings.Reset(NumJobs);
+
+	float TotalJobValue = 0.0f;
+	for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+	{
+		TotalJobValue += StartupJob.JobWeight;
 	}
-	else
+
+	auto ReportProgress = [this, &JobStates, TotalJobValue, bReportProgress]()
 	{
-		if (StartupJobs.Num() > 0)
+		if (!bReportProgress)
 		{
-			float TotalJobValue = 0.0f;
-			for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+			return;
+		}
+
+		float AccumulatedJobValue = 0.0f;
+		for (int32 JobIndex = 0; JobIndex < JobStates.Num(); ++JobIndex)
+		{
+			const FJobState& JobState = JobStates[JobIndex];
+			const float JobProgress = (JobState.State == EJobState::Done) ? 1.0f : (JobState.State == EJobState::Running) ? FMath::Clamp(JobState.Progress, 0.0f, 1.0f) : 0.0f;
+			AccumulatedJobValue += JobProgress * StartupJobs[JobIndex].JobWeight;
+		}
+
+		UpdateInitialGameContentLoadPercent((TotalJobValue > 0.0f) ? (AccumulatedJobValue / TotalJobValue) : 1.0f);
+	};
+
+	// Jobs may only depend on jobs added before them, so the first pending job can always start once the running ones are done
+	auto AreDependenciesDone = [this, &JobStates](int32 JobIndex)
+	{
+		for (const int32 Dependency : StartupJobs[JobIndex].Dependencies)
+		{
+			if (ensureMsgf((Dependency >= 0) && (Dependency < JobIndex), TEXT("Startup job \"%s\" has an invalid dependency %d"), *StartupJobs[JobIndex].JobName, Dependency)
+				&& (JobStates[Dependency].State != EJobState::Done))
 			{
-				TotalJobValue += StartupJob.JobWeight;
+				return false;
 			}
+		}
+		return true;
+	};
 
-			float AccumulatedJobValue = 0.0f;
-			for (FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
-			{
-				const float JobValue = StartupJob.JobWeight;
-				StartupJob.SubstepProgressDelegate.BindLambda([This = this, AccumulatedJobValue, JobValue, TotalJobValue](float NewProgress)
-					{
-						const float SubstepAdjustment = FMath::Clamp(NewProgress, 0.0f, 1.0f) * JobValue;
-						const float OverallPercentWithSubstep = (AccumulatedJobValue + SubstepAdjustment) / TotalJobValue;
+	// Running one job at a time keeps the original order, as every dependency is an earlier job
+	const int32 MaxRunningJobs = LyraConsoleVariables::bParallelStartupJobs ? NumJobs : 1;
+	int32 NumRunningJobs = 0;
+	int32 NumDoneJobs = 0;
 
-						This->UpdateInitialGameContentLoadPercent(OverallPercentWithSubstep);
-					});
+	while (NumDoneJobs < NumJobs)
+	{
+		bool bMadeProgress = false;
 
-				StartupJob.DoJob();
+		// Start every job whose dependencies are done
+		for (int32 JobIndex = 0; (JobIndex < NumJobs) && (NumRunningJobs < MaxRunningJobs); ++JobIndex)
+		{
+			FJobState& JobState = JobStates[JobIndex];
+			if ((JobState.State != EJobState::Pending) || !AreDependenciesDone(JobIndex))
+			{
+				continue;
+			}
 
-				StartupJob.SubstepProgressDelegate.Unbind();
+			FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+			JobState.State = EJobState::Running;
+			JobState.StartTime = FPlatformTime::Seconds();
+			++NumRunningJobs;
+			bMadeProgress = true;
 
-				AccumulatedJobValue += JobValue;
+			if (StartupJob.bThreadSafe && LyraConsoleVariables::bParallelStartupJobs)
+			{
+				// Progress is only reported for game thread jobs
+				JobState.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&StartupJob]()
+					{
+						TSharedPtr<FStreamableHandle> Handle = StartupJob.StartJob();
+						ensureMsgf(!Handle.IsValid(), TEXT("Thread safe startup job \"%s\" created a load handle, it must run on the game thread"), *StartupJob.JobName);
+					});
+			}
+			else
+			{
+				if (bReportProgress)
+				{
+					StartupJob.SubstepProgressDelegate.BindLambda([&JobState](float NewProgress)
+						{
+							JobState.Progress = NewProgress;
+						});
+				}
+
+				JobState.Handle = StartupJob.StartJob();
+			}
+		}
 
-				UpdateInitialGameContentLoadPercent(AccumulatedJobValue / TotalJobValue);
+		// Complete the jobs that finished loading
+		for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+		{
+			FJobState& JobState = JobStates[JobIndex];
+			if ((JobState.State != EJobState::Running) || !JobState.IsFinished())
+			{
+				continue;
 			}
+
+			FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+			StartupJob.FinishJob(JobState.Handle);
+			StartupJob.SubstepProgressDelegate.Unbind();
+
+			FLyraAssetManagerStartupJobTiming& Timing = StartupJobTimings.AddDefaulted_GetRef();
+			Timing.JobName = StartupJob.JobName;
+			Timing.StartSeconds = JobState.StartTime - AllStartupJobsStartTime;
+			Timing.DurationSeconds = FPlatformTime::Seconds() - JobState.StartTime;
+			Timing.bThreadSafe = JobState.Task.IsValid();
+
+			JobState.Handle.Reset();
+			JobState.State = EJobState::Done;
+			--NumRunningJobs;
+			++NumDoneJobs;
+			bMadeProgress = true;
 		}
-		else
+
+		if (!bMadeProgress)
 		{
-			UpdateInitialGameContentLoadPercent(1.0f);
+			// Wait for one of the running jobs to finish
+			bool bAnyJobLoading = false;
+			for (const FJobState& JobState : JobStates)
+			{
+				bAnyJobLoading |= (JobState.State == EJobState::Running) && JobState.Handle.IsValid() && JobState.Handle->IsLoadingInProgress();
+			}
+
+			if (bAnyJobLoading)
+			{
+				ProcessAsyncLoadingUntilComplete([&JobStates]()
+					{
+						return JobStates.ContainsByPredicate([](const FJobState& JobState) { return (JobState.State == EJobState::Running) && JobState.IsFinished(); });
+					}, LyraStartupJobs::WaitSliceSeconds);
+			}
+			else
+			{
+				for (FJobState& JobState : JobStates)
+				{
+					if ((JobState.State == EJobState::Running) && !JobState.Task.IsCompleted())
+					{
+						JobState.Task.Wait();
+						break;
+					}
+				}
+			}
 		}
+
+		ReportProgress();
+	}
+
+	if (bReportProgress && (NumJobs == 0))
+	{
+		UpdateInitialGameContentLoadPercent(1.0f);
 	}
 
 	StartupJobs.Empty();
 
-	UE_LOG(LogLyra, Display, TEXT("All startup jobs took %.2f seconds to complete"), FPlatformTime::Seconds() - AllStartupJobsStartTime);
+	double SerialSeconds = 0.0;
+	for (const FLyraAssetManagerStartupJobTiming& Timing : StartupJobTimings)
+	{
+		SerialSeconds += Timing.DurationSeconds;
+	}
+
+	UE_LOG(LogLyra, Display, TEXT("All startup jobs took %.2f seconds to complete (%.2f seconds of job time)"), FPlatformTime::Seconds() - AllStartupJobsStartTime, SerialSeconds);
+}
+
+void ULyraAssetManager::DumpStartupJobTimings()
+{
+	UE_LOG(LogLyra, Log, TEXT("========== Startup Job Timings =========="));
+
+	for (const FLyraAssetManagerStartupJobTiming& Timing : Get().StartupJobTimings)
+	{
+		UE_LOG(LogLyra, Log, TEXT("  %-48s started at %7.3f s, took %7.3f s%s"), *Timing.JobName, Timing.StartSeconds, Timing.DurationSeconds, Timing.bThreadSafe ? TEXT(" (worker thread)") : TEXT(""));
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("... %d startup jobs"), Get().StartupJobTimings.Num());
 }
 
 void ULyraAssetManager::UpdateInitialGameContentLoadPercent(float GameContentPercent)
@@ -50,6 +50,12 @@ public:
 	// Logs all assets currently loaded and tracked by the asset manager.
 	static UE_API void DumpLoadedAssets();
 
+	// Logs when each startup job started and how long it took.
+	static UE_API void DumpStartupJobTimings();
+
+	// Returns the boot timings of the startup jobs, in the order they completed.
+	const TArray<FLyraAssetManagerStartupJobTiming>& GetStartupJobTimings() const { return StartupJobTimings; }
+
 	UE_API const ULyraGameData& GetGameData();
 	UE_API const ULyraPawnData* GetDefaultPawnData() const;
 
@@ -97,9 +103,12 @@ protected:
 	TSoftObjectPtr<ULyraPawnData> DefaultPawnData;
 
 private:
-	// Flushes the StartupJobs array. Processes all startup work.
+	// Flushes the StartupJobs array. Processes all startup work, running jobs concurrently once their dependencies are done.
 	UE_API void DoAllStartupJobs();
 
+	// Starts loading the base game data asynchronously, GetGameData will then find it loaded
+	UE_API TSharedPtr<FStreamableHandle> StartLoadingGameData();
+
 	// Sets up the ability system
 	UE_API void InitializeGameplayCueManager();
 
@@ -109,6 +118,9 @@ private:
 	// The list of tasks to execute on startup. Used to track startup progress.
 	TArray<FLyraAssetManagerStartupJob> StartupJobs;
 
+	// Timings of the last DoAllStartupJobs, kept for regression tracking.
+	TArray<FLyraAssetManagerStartupJobTiming> StartupJobTimings;
+
 private:
 	
 	// Assets loaded and tracked by the asset manager.
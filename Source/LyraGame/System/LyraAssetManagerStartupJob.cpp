@@ -6,7 +6,21 @@
 
 TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::DoJob() const
 {
-	const double JobStartTime = FPlatformTime::Seconds();
+	TSharedPtr<FStreamableHandle> Handle = StartJob();
+
+	if (Handle.IsValid())
+	{
+		Handle->WaitUntilComplete(0.0f, false);
+	}
+
+	FinishJob(Handle);
+
+	return Handle;
+}
+
+TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::StartJob() const
+{
+	JobStartTime = FPlatformTime::Seconds();
 
 	TSharedPtr<FStreamableHandle> Handle;
 	UE_LOG(LogLyra, Display, TEXT("Startup job \"%s\" starting"), *JobName);
@@ -15,11 +29,17 @@ TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::DoJob() const
 	if (Handle.IsValid())
 	{
 		Handle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateRaw(this, &FLyraAssetManagerStartupJob::UpdateSubstepProgressFromStreamable));
-		Handle->WaitUntilComplete(0.0f, false);
+	}
+
+	return Handle;
+}
+
+void FLyraAssetManagerStartupJob::FinishJob(const TSharedPtr<FStreamableHandle>& Handle) const
+{
+	if (Handle.IsValid())
+	{
 		Handle->BindUpdateDelegate(FStreamableUpdateDelegate());
 	}
 
 	UE_LOG(LogLyra, Display, TEXT("Startup job \"%s\" took %.2f seconds to complete"), *JobName, FPlatformTime::Seconds() - JobStartTime);
-
-	return Handle;
 }
@@ -15,6 +15,12 @@ struct FLyraAssetManagerStartupJob
 	float JobWeight;
 	mutable double LastUpdate = 0;
 
+	/** Indices of earlier startup jobs that must complete before this one starts */
+	TArray<int32, TInlineAllocator<2>> Dependencies;
+
+	/** If true, JobFunc may run on a worker thread. Thread safe jobs cannot create a load handle */
+	bool bThreadSafe = false;
+
 	/** Simple job that is all synchronous */
 	FLyraAssetManagerStartupJob(const FString& InJobName, const TFunction<void(const FLyraAssetManagerStartupJob&, TSharedPtr<FStreamableHandle>&)>& InJobFunc, float InJobWeight)
 		: JobFunc(InJobFunc)
@@ -22,9 +28,27 @@ struct FLyraAssetManagerStartupJob
 		, JobWeight(InJobWeight)
 	{}
 
+	FLyraAssetManagerStartupJob& AddDependency(int32 JobIndex)
+	{
+		Dependencies.Add(JobIndex);
+		return *this;
+	}
+
+	FLyraAssetManagerStartupJob& SetThreadSafe(bool bInThreadSafe = true)
+	{
+		bThreadSafe = bInThreadSafe;
+		return *this;
+	}
+
 	/** Perform actual loading, will return a handle if it created one */
 	TSharedPtr<FStreamableHandle> DoJob() const;
 
+	/** Starts the job without waiting for its load, will return a handle if it created one */
+	TSharedPtr<FStreamableHandle> StartJob() const;
+
+	/** Completes a job started with StartJob, once its handle (if any) has finished loading */
+	void FinishJob(const TSharedPtr<FStreamableHandle>& Handle) const;
+
 	void UpdateSubstepProgress(float NewProgress) const
 	{
 		SubstepProgressDelegate.ExecuteIfBound(NewProgress);
@@ -36,11 +60,28 @@ struct FLyraAssetManagerStartupJob
 		{
 			// StreamableHandle::GetProgress traverses() a large graph and is quite expensive
 			double Now = FPlatformTime::Seconds();
-			if (LastUpdate - Now > 1.0 / 60)
+			if (Now - LastUpdate > 1.0 / 60)
 			{
 				SubstepProgressDelegate.Execute(StreamableHandle->GetProgress());
 				LastUpdate = Now;
 			}
 		}
 	}
+
+private:
+	mutable double JobStartTime = 0.0;
+};
+
+/** Boot timing of a startup job, kept for regression tracking */
+struct FLyraAssetManagerStartupJobTiming
+{
+	FString JobName;
+
+	// Seconds from the start of the startup jobs until this job started
+	double StartSeconds = 0.0;
+
+	// Seconds this job took, including its load
+	double DurationSeconds = 0.0;
+
+	bool bThreadSafe = false;
 };
@@ -88,6 +88,7 @@
 #include "UObject/UObjectIterator.h"
 
 #include "LyraReplicationGraphSettings.h"
+#include "Performance/LyraServerPerfTimers.h"
 #include "Character/LyraCharacter.h"
 #include "Player/LyraPlayerController.h"
 
@@ -741,6 +742,8 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState
 
 void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	LYRA_SERVER_PERF_SCOPE(ReplicationGraphGather);
+
 	ULyraReplicationGraph* LyraGraph = CastChecked<ULyraReplicationGraph>(GetOuter());
 
 	ReplicationActorList.Reset();
@@ -920,6 +923,8 @@ void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplicatio
 
 void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	LYRA_SERVER_PERF_SCOPE(ReplicationGraphGather);
+
 	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
 	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
 
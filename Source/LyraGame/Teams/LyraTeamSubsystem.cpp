@@ -3,8 +3,11 @@
 #include "Teams/LyraTeamSubsystem.h"
 
 #include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraLogChannels.h"
 #include "LyraTeamAgentInterface.h"
 #include "LyraTeamCheats.h"
@@ -17,6 +20,22 @@
 
 class FSubsystemCollectionBase;
 
+namespace LyraConsoleVariables
+{
+	static bool bCacheTeamIds = true;
+	static FAutoConsoleVariableRef CVarCacheTeamIds(
+		TEXT("lyra.Teams.CacheTeamIds"),
+		bCacheTeamIds,
+		TEXT("Should the team subsystem cache the team of each object until it changes teams?"),
+		ECVF_Default);
+}
+
+namespace LyraTeamSubsystem
+{
+	// Entries are removed when their team source changes teams, this is a safety net against destroyed objects piling up
+	static constexpr int32 MaxCachedTeamIds = 4096;
+}
+
 //////////////////////////////////////////////////////////////////////
 // FLyraTeamTrackingInfo
 
@@ -85,6 +104,8 @@ void ULyraTeamSubsystem::Deinitialize()
 {
 	UCheatManager::UnregisterFromOnCheatManagerCreated(CheatManagerRegistrationHandle);
 
+	CachedTeamIds.Reset();
+
 	Super::Deinitialize();
 }
 
@@ -152,9 +173,42 @@ bool ULyraTeamSubsystem::ChangeTeamForActor(AActor* ActorToChange, int32 NewTeam
 
 int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 {
+	const UObject* TeamSource = nullptr;
+	if (!LyraConsoleVariables::bCacheTeamIds || (TestObject == nullptr) || !IsInGameThread())
+	{
+		return ResolveTeamFromObject(TestObject, /*out*/ TeamSource);
+	}
+
+	const FObjectKey TestObjectKey(TestObject);
+	if (const FCachedTeamId* CachedTeamId = CachedTeamIds.Find(TestObjectKey))
+	{
+		return CachedTeamId->TeamId;
+	}
+
+	const int32 TeamId = ResolveTeamFromObject(TestObject, /*out*/ TeamSource);
+	if ((TeamSource != nullptr) && WatchTeamSource(TeamSource))
+	{
+		if (CachedTeamIds.Num() >= LyraTeamSubsystem::MaxCachedTeamIds)
+		{
+			CachedTeamIds.Reset();
+		}
+
+		FCachedTeamId& CachedTeamId = CachedTeamIds.Add(TestObjectKey);
+		CachedTeamId.TeamSource = FObjectKey(TeamSource);
+		CachedTeamId.TeamId = TeamId;
+	}
+
+	return TeamId;
+}
+
+int32 ULyraTeamSubsystem::ResolveTeamFromObject(const UObject* TestObject, const UObject*& OutTeamSource) const
+{
+	OutTeamSource = nullptr;
+
 	// See if it's directly a team agent
 	if (const ILyraTeamAgentInterface* ObjectWithTeamInterface = Cast<ILyraTeamAgentInterface>(TestObject))
 	{
+		OutTeamSource = TestObject;
 		return GenericTeamIdToInteger(ObjectWithTeamInterface->GetGenericTeamId());
 	}
 
@@ -163,16 +217,19 @@ int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 		// See if the instigator is a team actor
 		if (const ILyraTeamAgentInterface* InstigatorWithTeamInterface = Cast<ILyraTeamAgentInterface>(TestActor->GetInstigator()))
 		{
+			OutTeamSource = TestActor->GetInstigator();
 			return GenericTeamIdToInteger(InstigatorWithTeamInterface->GetGenericTeamId());
 		}
 
 		// TeamInfo actors don't actually have the team interface, so they need a special case
 		if (const ALyraTeamInfoBase* TeamInfo = Cast<ALyraTeamInfoBase>(TestActor))
 		{
+			OutTeamSource = TeamInfo;
 			return TeamInfo->GetTeamId();
 		}
 
 		// Fall back to finding the associated player state
+		// (not cached, the actor can be associated with another player state without any team change)
 		if (const ALyraPlayerState* LyraPS = FindPlayerStateFromActor(TestActor))
 		{
 			return LyraPS->GetTeamId();
@@ -182,6 +239,39 @@ int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 	return INDEX_NONE;
 }
 
+bool ULyraTeamSubsystem::WatchTeamSource(const UObject* TeamSource) const
+{
+	// The team of a team info never changes
+	if (TeamSource->IsA<ALyraTeamInfoBase>())
+	{
+		return true;
+	}
+
+	// Agents that don't broadcast their team changes can't be cached
+	ILyraTeamAgentInterface* TeamAgent = Cast<ILyraTeamAgentInterface>(const_cast<UObject*>(TeamSource));
+	FOnLyraTeamIndexChangedDelegate* TeamChangedDelegate = TeamAgent ? TeamAgent->GetOnTeamIndexChangedDelegate() : nullptr;
+	if (TeamChangedDelegate == nullptr)
+	{
+		return false;
+	}
+
+	ULyraTeamSubsystem* MutableThis = const_cast<ULyraTeamSubsystem*>(this);
+	TeamChangedDelegate->AddUniqueDynamic(MutableThis, &ThisClass::HandleTeamSourceChanged);
+	return true;
+}
+
+void ULyraTeamSubsystem::HandleTeamSourceChanged(UObject* ObjectChangingTeam, int32 OldTeamID, int32 NewTeamID)
+{
+	const FObjectKey TeamSourceKey(ObjectChangingTeam);
+	for (auto It = CachedTeamIds.CreateIterator(); It; ++It)
+	{
+		if (It->Value.TeamSource == TeamSourceKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 const ALyraPlayerState* ULyraTeamSubsystem::FindPlayerStateFromActor(const AActor* PossibleTeamActor) const
 {
 	if (PossibleTeamActor != nullptr)
@@ -241,6 +331,31 @@ ELyraTeamComparison ULyraTeamSubsystem::CompareTeams(const UObject* A, const UOb
 	return CompareTeams(A, B, /*out*/ TeamIdA, /*out*/ TeamIdB);
 }
 
+void ULyraTeamSubsystem::CompareTeamsBulk(const UObject* Viewer, TConstArrayView<const AActor*> Actors, TArray<ELyraTeamComparison>& OutComparisons) const
+{
+	OutComparisons.Reset(Actors.Num());
+
+	const int32 ViewerTeamId = FindTeamFromObject(Viewer);
+	if (ViewerTeamId == INDEX_NONE)
+	{
+		OutComparisons.Init(ELyraTeamComparison::InvalidArgument, Actors.Num());
+		return;
+	}
+
+	for (const AActor* Actor : Actors)
+	{
+		const int32 ActorTeamId = FindTeamFromObject(Actor);
+		if (ActorTeamId == INDEX_NONE)
+		{
+			OutComparisons.Add(ELyraTeamComparison::InvalidArgument);
+		}
+		else
+		{
+			OutComparisons.Add((ViewerTeamId == ActorTeamId) ? ELyraTeamComparison::OnSameTeam : ELyraTeamComparison::DifferentTeams);
+		}
+	}
+}
+
 void ULyraTeamSubsystem::FindTeamFromActor(const UObject* TestObject, bool& bIsPartOfTeam, int32& TeamId) const
 {
 	TeamId = FindTeamFromObject(TestObject);
@@ -403,3 +518,91 @@ FOnLyraTeamDisplayAssetChangedDelegate& ULyraTeamSubsystem::GetTeamDisplayAssetC
 	return TeamMap.FindOrAdd(TeamId).OnTeamDisplayAssetChanged;
 }
 
+
+//////////////////////////////////////////////////////////////////////
+
+#if !UE_BUILD_SHIPPING
+namespace LyraTeamSubsystem
+{
+	// Compares every pawn in the world with every other pawn, like an AI target scan, with and without the team cache
+	static void RunBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumComparisons = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+		const ULyraTeamSubsystem* TeamSubsystem = World ? World->GetSubsystem<ULyraTeamSubsystem>() : nullptr;
+		if (TeamSubsystem == nullptr)
+		{
+			UE_LOG(LogLyraTeams, Warning, TEXT("Team benchmark: no team subsystem in this world"));
+			return;
+		}
+
+		TArray<const AActor*> Pawns;
+		for (TActorIterator<APawn> It(World); It; ++It)
+		{
+			Pawns.Add(*It);
+		}
+
+		if (Pawns.Num() < 2)
+		{
+			UE_LOG(LogLyraTeams, Warning, TEXT("Team benchmark: needs at least two pawns in the world (add bots)"));
+			return;
+		}
+
+		const int32 NumScans = FMath::Max(NumComparisons / Pawns.Num(), 1);
+		const bool bPreviousCacheTeamIds = LyraConsoleVariables::bCacheTeamIds;
+
+		// One scan per viewer, pair by pair
+		auto RunPairScans = [TeamSubsystem, &Pawns, NumScans](TArray<ELyraTeamComparison>& OutLastResults)
+		{
+			for (int32 ScanIndex = 0; ScanIndex < NumScans; ++ScanIndex)
+			{
+				const AActor* Viewer = Pawns[ScanIndex % Pawns.Num()];
+				OutLastResults.Reset();
+				for (const AActor* Pawn : Pawns)
+				{
+					OutLastResults.Add(TeamSubsystem->CompareTeams(Viewer, Pawn));
+				}
+			}
+		};
+
+		TArray<ELyraTeamComparison> UncachedResults;
+		LyraConsoleVariables::bCacheTeamIds = false;
+		const double UncachedStartTime = FPlatformTime::Seconds();
+		RunPairScans(UncachedResults);
+		const double UncachedSeconds = FPlatformTime::Seconds() - UncachedStartTime;
+
+		TArray<ELyraTeamComparison> CachedResults;
+		LyraConsoleVariables::bCacheTeamIds = true;
+		const double CachedStartTime = FPlatformTime::Seconds();
+		RunPairScans(CachedResults);
+		const double CachedSeconds = FPlatformTime::Seconds() - CachedStartTime;
+
+		TArray<ELyraTeamComparison> BulkResults;
+		const double BulkStartTime = FPlatformTime::Seconds();
+		for (int32 ScanIndex = 0; ScanIndex < NumScans; ++ScanIndex)
+		{
+			TeamSubsystem->CompareTeamsBulk(Pawns[ScanIndex % Pawns.Num()], Pawns, BulkResults);
+		}
+		const double BulkSeconds = FPlatformTime::Seconds() - BulkStartTime;
+
+		LyraConsoleVariables::bCacheTeamIds = bPreviousCacheTeamIds;
+
+		int32 NumMismatches = 0;
+		for (int32 Index = 0; Index < UncachedResults.Num(); ++Index)
+		{
+			NumMismatches += ((UncachedResults[Index] != CachedResults[Index]) || (UncachedResults[Index] != BulkResults[Index])) ? 1 : 0;
+		}
+
+		const int32 NumTimedComparisons = NumScans * Pawns.Num();
+		UE_LOG(LogLyraTeams, Log, TEXT("Team benchmark: %d scans of %d pawns (%d mismatches in the last scan)"), NumScans, Pawns.Num(), NumMismatches);
+		UE_LOG(LogLyraTeams, Log, TEXT("  Uncached: %.3f ms (%.1f ns per comparison)"), UncachedSeconds * 1000.0, UncachedSeconds * 1000000000.0 / NumTimedComparisons);
+		UE_LOG(LogLyraTeams, Log, TEXT("  Cached:   %.3f ms (%.1f ns per comparison)"), CachedSeconds * 1000.0, CachedSeconds * 1000000000.0 / NumTimedComparisons);
+		UE_LOG(LogLyraTeams, Log, TEXT("  Bulk:     %.3f ms (%.1f ns per comparison)"), BulkSeconds * 1000.0, BulkSeconds * 1000000000.0 / NumTimedComparisons);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("lyra.Teams.Benchmark"),
+		TEXT("Compares the teams of every pawn in the world with every other pawn, uncached, cached and in bulk. Usage: lyra.Teams.Benchmark [NumComparisons]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunBenchmark));
+}
+#endif // !UE_BUILD_SHIPPING
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraTeamSubsystem.generated.h"
 
@@ -82,6 +83,7 @@ public:
 	UE_API bool ChangeTeamForActor(AActor* ActorToChange, int32 NewTeamId);
 
 	// Returns the team this object belongs to, or INDEX_NONE if it is not part of a team
+	// The result is cached per object until the team agent it came from broadcasts a team change
 	UE_API int32 FindTeamFromObject(const UObject* TestObject) const;
 
 	// Returns the associated player state for this actor, or INDEX_NONE if it is not associated with a player
@@ -98,6 +100,9 @@ public:
 	// Compare the teams of two actors and returns a value indicating if they are on same teams, different teams, or one/both are invalid
 	UE_API ELyraTeamComparison CompareTeams(const UObject* A, const UObject* B) const;
 
+	// Compares the team of the viewer with each of the actors in one pass (OutComparisons matches the order of Actors)
+	UE_API void CompareTeamsBulk(const UObject* Viewer, TConstArrayView<const AActor*> Actors, TArray<ELyraTeamComparison>& OutComparisons) const;
+
 	// Returns true if the instigator can damage the target, taking into account the friendly fire settings
 	UE_API bool CanCauseDamage(const UObject* Instigator, const UObject* Target, bool bAllowDamageToSelf = true) const;
 
@@ -141,10 +146,30 @@ public:
 	// Register for a team display asset notification for the specified team ID
 	UE_API FOnLyraTeamDisplayAssetChangedDelegate& GetTeamDisplayAssetChangedDelegate(int32 TeamId);
 
+private:
+	// Resolves the team of an object without the cache, OutTeamSource is the object the team came from if the result can be cached
+	int32 ResolveTeamFromObject(const UObject* TestObject, const UObject*& OutTeamSource) const;
+
+	// Makes sure a change to the team of the source invalidates the cached teams that came from it, returns false if it can't be watched
+	bool WatchTeamSource(const UObject* TeamSource) const;
+
+	UFUNCTION()
+	void HandleTeamSourceChanged(UObject* ObjectChangingTeam, int32 OldTeamID, int32 NewTeamID);
+
 private:
 	UPROPERTY()
 	TMap<int32, FLyraTeamTrackingInfo> TeamMap;
 
+	struct FCachedTeamId
+	{
+		// The team agent (or team info) the team was resolved from
+		FObjectKey TeamSource;
+		int32 TeamId = INDEX_NONE;
+	};
+
+	// Teams found by FindTeamFromObject (game thread only)
+	mutable TMap<FObjectKey, FCachedTeamId> CachedTeamIds;
+
 	FDelegateHandle CheatManagerRegistrationHandle;
 };
 
@@ -15,6 +15,7 @@
 #include "Inventory/LyraInventoryItemInstance.h"
 #include "Inventory/LyraInventoryManagerComponent.h"
 #include "Character/LyraPawnExtensionComponent.h"
+#include "Performance/LyraServerPerfTimers.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayRpcRegistrationComponent)
 
@@ -98,6 +99,12 @@ void ULyraGameplayRpcRegistrationComponent::RegisterAlwaysOnHttpCallbacks()
 		TEXT("Cheats"),
 		TEXT("raw"),
 		{ CommandDesc });
+
+	RegisterHttpCallback(FName(TEXT("GetServerPerf")),
+		FHttpPath("/server/perf"),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateUObject(this, &ThisClass::HttpGetServerPerfCommand),
+		true);
 }
 
 void ULyraGameplayRpcRegistrationComponent::RegisterInMatchHttpCallbacks()
@@ -158,6 +165,40 @@ bool ULyraGameplayRpcRegistrationComponent::HttpExecuteCheatCommand(const FHttpS
 	return true;
 }
 
+bool ULyraGameplayRpcRegistrationComponent::HttpGetServerPerfCommand(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	double AvgFrameMs, MaxFrameMs;
+	FLyraServerPerfTimers::GetFrameTimeStats(AvgFrameMs, MaxFrameMs);
+
+	FString ResponseStr;
+	TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&ResponseStr);
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("enabled"), FLyraServerPerfTimers::IsEnabled());
+	JsonWriter->WriteValue(TEXT("frames"), FLyraServerPerfTimers::GetNumSampledFrames());
+	JsonWriter->WriteValue(TEXT("avgFrameMs"), AvgFrameMs);
+	JsonWriter->WriteValue(TEXT("maxFrameMs"), MaxFrameMs);
+	JsonWriter->WriteArrayStart(TEXT("timers"));
+	for (int32 TimerIndex = 0; TimerIndex < (int32)ELyraServerPerfTimer::Count; ++TimerIndex)
+	{
+		const ELyraServerPerfTimer Timer = (ELyraServerPerfTimer)TimerIndex;
+		const FLyraServerPerfTimerStats Stats = FLyraServerPerfTimers::GetTimerStats(Timer);
+
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("name"), FLyraServerPerfTimers::GetTimerName(Timer));
+		JsonWriter->WriteValue(TEXT("avgMs"), Stats.AvgMsPerFrame);
+		JsonWriter->WriteValue(TEXT("maxMs"), Stats.MaxMsPerFrame);
+		JsonWriter->WriteValue(TEXT("avgCalls"), Stats.AvgCallsPerFrame);
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(ResponseStr, TEXT("application/json"));
+	OnComplete(MoveTemp(Response));
+	return true;
+}
+
 bool ULyraGameplayRpcRegistrationComponent::HttpFireOnceCommand(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
 {
 	ALyraPlayerController* LPC = GetPlayerController();
@@ -39,6 +39,11 @@ public:
 	*/
 	UE_API bool HttpExecuteCheatCommand(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 
+	/**
+	 * Reports the recent per-frame cost of the server performance timers (see FLyraServerPerfTimers).
+	 */
+	UE_API bool HttpGetServerPerfCommand(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+
 
 // These are RPCs that should only be enabled while we are in the frontend.
 
@@ -8,6 +8,24 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(IndicatorDescriptor)
 
+namespace IndicatorProjection
+{
+	// Applies the screen space offset, and pushes points behind the camera out of the screen
+	static FVector FinishPointProjection(FVector2D ScreenSpacePosition, bool bInFrontOfCamera, const FVector2D& ScreenSpaceOffset, const FVector2f& ScreenSize, double Depth)
+	{
+		ScreenSpacePosition.X += ScreenSpaceOffset.X * (bInFrontOfCamera ? 1 : -1);
+		ScreenSpacePosition.Y += ScreenSpaceOffset.Y;
+
+		if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside((FVector2f)ScreenSpacePosition))
+		{
+			const FVector2f CenterToPosition = (FVector2f(ScreenSpacePosition) - (ScreenSize / 2)).GetSafeNormal();
+			ScreenSpacePosition = FVector2D((ScreenSize / 2) + CenterToPosition * ScreenSize);
+		}
+
+		return FVector(ScreenSpacePosition.X, ScreenSpacePosition.Y, Depth);
+	}
+}
+
 bool FIndicatorProjection::Project(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, FVector& OutScreenPositionWithDepth)
 {
 	if (USceneComponent* Component = IndicatorDescriptor.GetSceneComponent())
@@ -34,16 +52,7 @@ bool FIndicatorProjection::Project(const UIndicatorDescriptor& IndicatorDescript
 					FVector2D OutScreenSpacePosition;
 					const bool bInFrontOfCamera = ULocalPlayer::GetPixelPoint(InProjectionData, ProjectWorldLocation, OutScreenSpacePosition, &ScreenSize);
 
-					OutScreenSpacePosition.X += IndicatorDescriptor.GetScreenSpaceOffset().X * (bInFrontOfCamera ? 1 : -1);
-					OutScreenSpacePosition.Y += IndicatorDescriptor.GetScreenSpaceOffset().Y;
-
-					if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside((FVector2f)OutScreenSpacePosition))
-					{
-						const FVector2f CenterToPosition = (FVector2f(OutScreenSpacePosition) - (ScreenSize / 2)).GetSafeNormal();
-						OutScreenSpacePosition = FVector2D((ScreenSize / 2) + CenterToPosition * ScreenSize);
-					}
-
-					OutScreenPositionWithDepth = FVector(OutScreenSpacePosition.X, OutScreenSpacePosition.Y, FVector::Dist(InProjectionData.ViewOrigin, ProjectWorldLocation));
+					OutScreenPositionWithDepth = IndicatorProjection::FinishPointProjection(OutScreenSpacePosition, bInFrontOfCamera, IndicatorDescriptor.GetScreenSpaceOffset(), ScreenSize, FVector::Dist(InProjectionData.ViewOrigin, ProjectWorldLocation));
 
 					return true;
 				}
@@ -122,6 +131,63 @@ bool FIndicatorProjection::Project(const UIndicatorDescriptor& IndicatorDescript
 	return false;
 }
 
+bool FIndicatorProjection::GetPointWorldLocation(const UIndicatorDescriptor& IndicatorDescriptor, FVector& OutWorldLocation)
+{
+	USceneComponent* Component = IndicatorDescriptor.GetSceneComponent();
+	if ((Component == nullptr) || (IndicatorDescriptor.GetProjectionMode() != EActorCanvasProjectionMode::ComponentPoint))
+	{
+		return false;
+	}
+
+	if (IndicatorDescriptor.GetComponentSocketName() != NAME_None)
+	{
+		OutWorldLocation = Component->GetSocketTransform(IndicatorDescriptor.GetComponentSocketName()).GetLocation();
+	}
+	else
+	{
+		OutWorldLocation = Component->GetComponentLocation();
+	}
+
+	OutWorldLocation += IndicatorDescriptor.GetWorldPositionOffset();
+	return true;
+}
+
+void FIndicatorProjection::ProjectPoints(const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, TConstArrayView<FVector> WorldLocations, TConstArrayView<FVector2D> ScreenSpaceOffsets, TArrayView<FVector> OutScreenPositionsWithDepth)
+{
+	check(WorldLocations.Num() == ScreenSpaceOffsets.Num());
+	check(WorldLocations.Num() == OutScreenPositionsWithDepth.Num());
+
+	if (WorldLocations.Num() == 0)
+	{
+		return;
+	}
+
+	// Same math as ULocalPlayer::GetPixelPoint, without rebuilding the view projection matrix for every point
+	const FMatrix ViewProjectionMatrix = InProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = InProjectionData.GetConstrainedViewRect();
+	const FVector2D ViewRectMin(ViewRect.Min.X, ViewRect.Min.Y);
+	const FVector2D ViewRectSize(FMath::Max(ViewRect.Width(), 1), FMath::Max(ViewRect.Height(), 1));
+	const FVector2D ViewRectToScreen = FVector2D(ScreenSize) / ViewRectSize;
+
+	for (int32 PointIndex = 0; PointIndex < WorldLocations.Num(); ++PointIndex)
+	{
+		const FVector& WorldLocation = WorldLocations[PointIndex];
+
+		FPlane Result = ViewProjectionMatrix.TransformFVector4(FVector4(WorldLocation, 1.f));
+		const bool bInFrontOfCamera = (Result.W >= 0.f);
+		if (Result.W == 0.f)
+		{
+			Result.W = 1.f;
+		}
+
+		const double RHW = 1.0 / FMath::Abs(Result.W);
+		const FVector2D Normalized((Result.X * RHW * 0.5) + 0.5, 0.5 - (Result.Y * RHW * 0.5));
+		const FVector2D ScreenSpacePosition = ((Normalized * ViewRectSize) + ViewRectMin) * ViewRectToScreen;
+
+		OutScreenPositionsWithDepth[PointIndex] = IndicatorProjection::FinishPointProjection(ScreenSpacePosition, bInFrontOfCamera, ScreenSpaceOffsets[PointIndex], ScreenSize, FVector::Dist(InProjectionData.ViewOrigin, WorldLocation));
+	}
+}
+
 void UIndicatorDescriptor::SetIndicatorManagerComponent(ULyraIndicatorManagerComponent* InManager)
 {
 	// Make sure nobody has set this.
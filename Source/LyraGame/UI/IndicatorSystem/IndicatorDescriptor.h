@@ -19,6 +19,15 @@ struct FSceneViewProjectionData;
 struct FIndicatorProjection
 {
 	bool Project(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, FVector& ScreenPositionWithDepth);
+
+	/** Gets the world location a ComponentPoint indicator is projected from, returns false for the other projection modes */
+	static bool GetPointWorldLocation(const UIndicatorDescriptor& IndicatorDescriptor, FVector& OutWorldLocation);
+
+	/**
+	 * Projects a batch of ComponentPoint indicators at once, sharing the view projection matrix between them.
+	 * Gives the same results as calling Project on each of the indicators.
+	 */
+	static void ProjectPoints(const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, TConstArrayView<FVector> WorldLocations, TConstArrayView<FVector2D> ScreenSpaceOffsets, TArrayView<FVector> OutScreenPositionsWithDepth);
 };
 
 UENUM(BlueprintType)
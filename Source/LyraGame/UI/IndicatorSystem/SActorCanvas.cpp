@@ -7,12 +7,48 @@
 #include "Layout/ArrangedChildren.h"
 #include "LyraIndicatorManagerComponent.h"
 #include "SceneView.h"
+#include "SlateGlobals.h"
 #include "UI/IndicatorSystem/IndicatorDescriptor.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/SLeafWidget.h"
 
 class FSlateRect;
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Processed"), STAT_SActorCanvas_IndicatorsProcessed, STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Culled"), STAT_SActorCanvas_IndicatorsCulled, STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Arranged"), STAT_SActorCanvas_IndicatorsArranged, STATGROUP_Slate);
+
+namespace LyraConsoleVariables
+{
+	static float IndicatorMovementThreshold = 0.5f;
+	static FAutoConsoleVariableRef CVarIndicatorMovementThreshold(
+		TEXT("lyra.Indicators.MovementThreshold"),
+		IndicatorMovementThreshold,
+		TEXT("Distance (in pixels) an indicator has to move on screen before the canvas is arranged again."),
+		ECVF_Default);
+
+	static float IndicatorDepthThreshold = 10.0f;
+	static FAutoConsoleVariableRef CVarIndicatorDepthThreshold(
+		TEXT("lyra.Indicators.DepthThreshold"),
+		IndicatorDepthThreshold,
+		TEXT("Change in distance from the camera (in cm) needed before an indicator is sorted again."),
+		ECVF_Default);
+
+	static float IndicatorMaxDistance = 0.0f;
+	static FAutoConsoleVariableRef CVarIndicatorMaxDistance(
+		TEXT("lyra.Indicators.MaxDistance"),
+		IndicatorMaxDistance,
+		TEXT("Indicators further than this from the camera (in cm) are hidden, unless they clamp to the screen. 0 disables distance culling."),
+		ECVF_Default);
+
+	static int32 MaxVisibleIndicators = 0;
+	static FAutoConsoleVariableRef CVarMaxVisibleIndicators(
+		TEXT("lyra.Indicators.MaxVisible"),
+		MaxVisibleIndicators,
+		TEXT("Maximum number of indicators shown at once, keeping the highest priority and then closest ones. 0 means no limit."),
+		ECVF_Default);
+}
+
 namespace EArrowDirection
 {
 	enum Type
@@ -202,6 +238,14 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 
 			bool IndicatorsChanged = false;
 
+			const FVector2f ScreenSize = PaintGeometry.Size;
+
+			PointProjectionChildren.Reset();
+			PointProjectionLocations.Reset();
+			PointProjectionOffsets.Reset();
+			CullingCandidates.Reset();
+			int32 NumProjected = 0;
+
 			for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
 			{
 				SActorCanvas::FSlot& CurChild = CanvasChildren[ChildIndex];
@@ -222,8 +266,6 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 
 				if (!CurChild.GetIsIndicatorVisible())
 				{
-					IndicatorsChanged |= CurChild.bIsDirty();
-					CurChild.ClearDirtyFlag();
 					continue;
 				}
 
@@ -235,39 +277,72 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 					IndicatorsChanged = true;
 				}
 
+				// Point indicators are gathered and projected together below
+				FVector WorldLocation;
+				if (FIndicatorProjection::GetPointWorldLocation(*Indicator, WorldLocation))
+				{
+					PointProjectionChildren.Add(ChildIndex);
+					PointProjectionLocations.Add(WorldLocation);
+					PointProjectionOffsets.Add(Indicator->GetScreenSpaceOffset());
+					continue;
+				}
+
 				FVector ScreenPositionWithDepth;
 
 				FIndicatorProjection Projector;
-				const bool Success = Projector.Project(*Indicator, ProjectionData, PaintGeometry.Size, OUT ScreenPositionWithDepth);
+				const bool Success = Projector.Project(*Indicator, ProjectionData, ScreenSize, OUT ScreenPositionWithDepth);
+				++NumProjected;
 
-				if (!Success)
+				if (UpdateSlotProjection(CurChild, Success, ScreenPositionWithDepth, ScreenSize))
 				{
-					CurChild.SetHasValidScreenPosition(false);
-					CurChild.SetInFrontOfCamera(false);
-
-					IndicatorsChanged |= CurChild.bIsDirty();
-					CurChild.ClearDirtyFlag();
-					continue;
+					CullingCandidates.Add(ChildIndex);
 				}
+			}
 
-				CurChild.SetInFrontOfCamera(Success);
-				CurChild.SetHasValidScreenPosition(CurChild.GetInFrontOfCamera() || Indicator->GetClampToScreen());
+			PointProjectionResults.SetNumUninitialized(PointProjectionLocations.Num(), EAllowShrinking::No);
+			FIndicatorProjection::ProjectPoints(ProjectionData, ScreenSize, PointProjectionLocations, PointProjectionOffsets, PointProjectionResults);
 
-				if (CurChild.HasValidScreenPosition())
+			for (int32 PointIndex = 0; PointIndex < PointProjectionChildren.Num(); ++PointIndex)
+			{
+				const int32 ChildIndex = PointProjectionChildren[PointIndex];
+				if (UpdateSlotProjection(CanvasChildren[ChildIndex], /*bProjected=*/ true, PointProjectionResults[PointIndex], ScreenSize))
 				{
-					// Only dirty the screen position if we can actually show this indicator.
-					CurChild.SetScreenPosition(FVector2D(ScreenPositionWithDepth));
-					CurChild.SetDepth(ScreenPositionWithDepth.X);
+					CullingCandidates.Add(ChildIndex);
 				}
+			}
+
+			// Keep the highest priority, then closest, indicators when over budget
+			const int32 MaxVisible = LyraConsoleVariables::MaxVisibleIndicators;
+			const bool bOverBudget = (MaxVisible > 0) && (CullingCandidates.Num() > MaxVisible);
+			if (bOverBudget)
+			{
+				CullingCandidates.Sort([this](int32 A, int32 B)
+				{
+					const SActorCanvas::FSlot& SlotA = CanvasChildren[A];
+					const SActorCanvas::FSlot& SlotB = CanvasChildren[B];
+					return SlotA.GetPriority() == SlotB.GetPriority() ? SlotA.GetDepth() < SlotB.GetDepth() : SlotA.GetPriority() > SlotB.GetPriority();
+				});
+			}
 
-				CurChild.SetPriority(Indicator->GetPriority());
+			for (int32 CandidateIndex = 0; CandidateIndex < CullingCandidates.Num(); ++CandidateIndex)
+			{
+				CanvasChildren[CullingCandidates[CandidateIndex]].SetIsCulled(bOverBudget && (CandidateIndex >= MaxVisible));
+			}
 
+			NumProjected += PointProjectionChildren.Num();
+			INC_DWORD_STAT_BY(STAT_SActorCanvas_IndicatorsProcessed, NumProjected);
+			INC_DWORD_STAT_BY(STAT_SActorCanvas_IndicatorsCulled, bOverBudget ? (CullingCandidates.Num() - MaxVisible) : 0);
+
+			for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
+			{
+				SActorCanvas::FSlot& CurChild = CanvasChildren[ChildIndex];
 				IndicatorsChanged |= CurChild.bIsDirty();
 				CurChild.ClearDirtyFlag();
 			}
 
 			if (IndicatorsChanged)
 			{
+				bArrangementDirty = true;
 				Invalidate(EInvalidateWidget::Paint);
 			}
 		}
@@ -292,11 +367,65 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 	}
 }
 
+bool SActorCanvas::UpdateSlotProjection(FSlot& Slot, bool bProjected, const FVector& ScreenPositionWithDepth, const FVector2f& ScreenSize)
+{
+	if (!bProjected)
+	{
+		Slot.SetHasValidScreenPosition(false);
+		Slot.SetInFrontOfCamera(false);
+		return false;
+	}
+
+	const UIndicatorDescriptor* Indicator = Slot.Indicator;
+
+	Slot.SetInFrontOfCamera(bProjected);
+	Slot.SetHasValidScreenPosition(Slot.GetInFrontOfCamera() || Indicator->GetClampToScreen());
+
+	if (Slot.HasValidScreenPosition())
+	{
+		// Only dirty the screen position if we can actually show this indicator.
+		// Sub-threshold movement is ignored so that still indicators do not force a new arrange.
+		Slot.SetScreenPosition(FVector2D(ScreenPositionWithDepth), LyraConsoleVariables::IndicatorMovementThreshold);
+		Slot.SetDepth(ScreenPositionWithDepth.Z, LyraConsoleVariables::IndicatorDepthThreshold);
+	}
+
+	Slot.SetPriority(Indicator->GetPriority());
+
+	// Indicators clamped to the screen are always wanted, everything else can be culled when far away or off screen
+	bool bCulled = false;
+	if (!Indicator->GetClampToScreen())
+	{
+		const float MaxDistance = LyraConsoleVariables::IndicatorMaxDistance;
+		if ((MaxDistance > 0.0f) && (ScreenPositionWithDepth.Z > MaxDistance))
+		{
+			bCulled = true;
+		}
+		else
+		{
+			FVector2D SlotSize(ForceInitToZero), SlotOffset(ForceInitToZero), SlotPaddingMin(ForceInitToZero), SlotPaddingMax(ForceInitToZero);
+			GetOffsetAndSize(Indicator, SlotSize, SlotOffset, SlotPaddingMin, SlotPaddingMax);
+
+			const FVector2D SlotMin = FVector2D(ScreenPositionWithDepth) + SlotOffset;
+			const FVector2D SlotMax = SlotMin + SlotSize;
+			bCulled = (SlotMax.X < 0.0) || (SlotMax.Y < 0.0) || (SlotMin.X > ScreenSize.X) || (SlotMin.Y > ScreenSize.Y);
+		}
+	}
+
+	if (bCulled)
+	{
+		Slot.SetIsCulled(true);
+		INC_DWORD_STAT(STAT_SActorCanvas_IndicatorsCulled);
+	}
+
+	return !bCulled;
+}
+
 void SActorCanvas::SetShowAnyIndicators(bool bIndicators)
 {
 	if (bShowAnyIndicators != bIndicators)
 	{
 		bShowAnyIndicators = bIndicators;
+		bArrangementDirty = true;
 
 		if (!bShowAnyIndicators)
 		{
@@ -312,6 +441,12 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_SActorCanvas_OnArrangeChildren);
 
+	if (ArrangeFromCache(AllottedGeometry, ArrangedChildren))
+	{
+		return;
+	}
+
+	CachedArrangement.Reset();
 	NextArrowIndex = 0;
 
 	//Make sure we have a player. If we don't, we can't project anything
@@ -322,7 +457,7 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 		const FVector Center = FVector(AllottedGeometry.Size * 0.5f, 0.0f);
 
 		// Sort the children
-		TArray<const SActorCanvas::FSlot*> SortedSlots;
+		SortedSlots.Reset();
 		for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
 		{
 			SortedSlots.Add(&CanvasChildren[ChildIndex]);
@@ -333,6 +468,8 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 			return A.GetPriority() == B.GetPriority() ? A.GetDepth() > B.GetDepth() : A.GetPriority() < B.GetPriority();
 		});
 
+		INC_DWORD_STAT_BY(STAT_SActorCanvas_IndicatorsArranged, SortedSlots.Num());
+
 		// Go through all the sorted children
 		for (int32 ChildIndex = 0; ChildIndex < SortedSlots.Num(); ++ChildIndex)
 		{
@@ -475,6 +612,7 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 						ArrowWidgetSize,			// Child's size
 						1.f							// Child's scale
 					));
+					CachedArrangement.Emplace(ArrowWidgetToUse, nullptr, FinalPosition, ArrowWidgetSize);
 				}
 			}
 
@@ -487,6 +625,7 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 				SlotSize,
 				1.f
 			));
+			CachedArrangement.Emplace(CurChild.GetWidget(), &CurChild, ScreenPosition + SlotOffset, SlotSize);
 		}
 	}
 
@@ -499,6 +638,36 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 	}
 
 	ArrowIndexLastUpdate = NextArrowIndex;
+
+	CachedArrangeSize = AllottedGeometry.GetLocalSize();
+	bArrangementDirty = false;
+}
+
+bool SActorCanvas::ArrangeFromCache(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const
+{
+	if (bArrangementDirty || (CachedArrangeSize != AllottedGeometry.GetLocalSize()))
+	{
+		return false;
+	}
+
+	// Indicator widgets can resize themselves without the canvas knowing (e.g., text changes)
+	for (const FCachedArrangedWidget& Cached : CachedArrangement)
+	{
+		if (Cached.Slot && (Cached.Slot->GetWidget()->GetDesiredSize() != Cached.Size))
+		{
+			return false;
+		}
+	}
+
+	for (const FCachedArrangedWidget& Cached : CachedArrangement)
+	{
+		if (ArrangedChildren.Accepts(Cached.Widget->GetVisibility()))
+		{
+			ArrangedChildren.AddWidget(AllottedGeometry.MakeChild(Cached.Widget, Cached.Position, Cached.Size, 1.f));
+		}
+	}
+
+	return true;
 }
 
 int32 SActorCanvas::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
@@ -631,6 +800,7 @@ SActorCanvas::FScopedWidgetSlotArguments SActorCanvas::AddActorSlot(UIndicatorDe
 		{
 			if (TSharedPtr<SActorCanvas> Canvas = WeakCanvas.Pin())
 			{
+				Canvas->bArrangementDirty = true;
 				Canvas->UpdateActiveTimer();
 			}
 		}};
@@ -643,6 +813,7 @@ int32 SActorCanvas::RemoveActorSlot(const TSharedRef<SWidget>& SlotWidget)
 		if ( SlotWidget == CanvasChildren[SlotIdx].GetWidget() )
 		{
 			CanvasChildren.RemoveAt(SlotIdx);
+			bArrangementDirty = true;
 
 			UpdateActiveTimer();
 
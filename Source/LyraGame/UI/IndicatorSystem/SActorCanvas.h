@@ -35,6 +35,7 @@ public:
 			, bIsIndicatorVisible(true)
 			, bInFrontOfCamera(true)
 			, bHasValidScreenPosition(false)
+			, bIsCulled(false)
 			, bDirty(true)
 			, bWasIndicatorClamped(false)
 			, bWasIndicatorClampedStatusChanged(false)
@@ -58,9 +59,9 @@ public:
 		}
 
 		FVector2D GetScreenPosition() const { return ScreenPosition; }
-		void SetScreenPosition(FVector2D InScreenPosition)
+		void SetScreenPosition(FVector2D InScreenPosition, double Tolerance = 0.0)
 		{
-			if (ScreenPosition != InScreenPosition)
+			if (!ScreenPosition.Equals(InScreenPosition, Tolerance))
 			{
 				ScreenPosition = InScreenPosition;
 				bDirty = true;
@@ -68,9 +69,9 @@ public:
 		}
 
 		double GetDepth() const { return Depth; }
-		void SetDepth(double InDepth)
+		void SetDepth(double InDepth, double Tolerance = 0.0)
 		{
-			if (Depth != InDepth)
+			if (FMath::Abs(Depth - InDepth) > Tolerance)
 			{
 				Depth = InDepth;
 				bDirty = true;
@@ -111,6 +112,19 @@ public:
 			RefreshVisibility();
 		}
 
+		/** Culled indicators are hidden by the canvas (too far, off screen or over budget), regardless of their own visibility */
+		bool GetIsCulled() const { return bIsCulled; }
+		void SetIsCulled(bool bCulled)
+		{
+			if (bIsCulled != bCulled)
+			{
+				bIsCulled = bCulled;
+				bDirty = true;
+			}
+
+			RefreshVisibility();
+		}
+
 		bool bIsDirty() const { return bDirty; }
 
 		void ClearDirtyFlag()
@@ -137,7 +151,7 @@ public:
 	private:
 		void RefreshVisibility()
 		{
-			const bool bIsVisible = bIsIndicatorVisible && bHasValidScreenPosition;
+			const bool bIsVisible = bIsIndicatorVisible && bHasValidScreenPosition && !bIsCulled;
 			GetWidget()->SetVisibility(bIsVisible ? EVisibility::SelfHitTestInvisible : EVisibility::Collapsed);
 		}
 
@@ -150,6 +164,7 @@ public:
 		uint8 bIsIndicatorVisible : 1;
 		uint8 bInFrontOfCamera : 1;
 		uint8 bHasValidScreenPosition : 1;
+		uint8 bIsCulled : 1;
 		uint8 bDirty : 1;
 		
 		/** 
@@ -215,6 +230,12 @@ private:
 	void SetShowAnyIndicators(bool bIndicators);
 	EActiveTimerReturnType UpdateCanvas(double InCurrentTime, float InDeltaTime);
 
+	/** Applies a projection result to a slot, returns false if the slot got culled by distance or for being off screen */
+	bool UpdateSlotProjection(FSlot& Slot, bool bProjected, const FVector& ScreenPositionWithDepth, const FVector2f& ScreenSize);
+
+	/** Replays the last arrangement if nothing affecting it changed since, returns false if a full arrange is needed */
+	bool ArrangeFromCache(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const;
+
 	/** Helper function for calculating the offset */
 	void GetOffsetAndSize(const UIndicatorDescriptor* Indicator,
 		FVector2D& OutSize, 
@@ -250,5 +271,33 @@ private:
 
 	mutable TOptional<FGeometry> OptionalPaintGeometry;
 
+	// Scratch for the batched projection of ComponentPoint indicators, structure of arrays
+	TArray<int32> PointProjectionChildren;
+	TArray<FVector> PointProjectionLocations;
+	TArray<FVector2D> PointProjectionOffsets;
+	TArray<FVector> PointProjectionResults;
+
+	// Children that passed distance and screen culling this update, competing for the visible budget
+	TArray<int32> CullingCandidates;
+
+	/** Result of the last full arrange, replayed as long as no indicator moved, resized or changed visibility */
+	struct FCachedArrangedWidget
+	{
+		FCachedArrangedWidget(const TSharedRef<SWidget>& InWidget, const FSlot* InSlot, const FVector2D& InPosition, const FVector2D& InSize)
+			: Widget(InWidget), Slot(InSlot), Position(InPosition), Size(InSize)
+		{
+		}
+
+		TSharedRef<SWidget> Widget;
+		// Null for arrows
+		const FSlot* Slot;
+		FVector2D Position;
+		FVector2D Size;
+	};
+	mutable TArray<FCachedArrangedWidget> CachedArrangement;
+	mutable TArray<const FSlot*> SortedSlots;
+	mutable FVector2D CachedArrangeSize = FVector2D::ZeroVector;
+	mutable bool bArrangementDirty = true;
+
 	TSharedPtr<FActiveTimerHandle> TickHandle;
 };
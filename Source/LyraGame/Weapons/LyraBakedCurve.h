@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Curves/RichCurve.h"
+
+/**
+ * FLyraBakedCurve
+ *
+ * Fixed-resolution lookup table sampled from a rich curve, so hot paths can evaluate
+ * it with an index and a lerp instead of a key search.
+ * Inputs outside of the curve's time range are clamped (matching constant extrapolation).
+ */
+struct FLyraBakedCurve
+{
+public:
+	static constexpr int32 DefaultNumSamples = 128;
+
+	void Bake(const FRichCurve& Curve, int32 NumSamples = DefaultNumSamples)
+	{
+		Samples.Reset();
+		MinTime = 0.0f;
+		InvStep = 0.0f;
+
+		if (Curve.GetNumKeys() <= 1)
+		{
+			// Flat (or empty) curves only need a single value
+			Samples.Add(Curve.Eval(0.0f));
+		}
+		else
+		{
+			float MaxTime;
+			Curve.GetTimeRange(/*out*/ MinTime, /*out*/ MaxTime);
+
+			NumSamples = FMath::Max(NumSamples, 2);
+			const float Step = (MaxTime - MinTime) / (NumSamples - 1);
+			InvStep = (Step > 0.0f) ? (1.0f / Step) : 0.0f;
+
+			Samples.SetNumUninitialized(NumSamples);
+			for (int32 Index = 0; Index < NumSamples; ++Index)
+			{
+				Samples[Index] = Curve.Eval(MinTime + Step * Index);
+			}
+		}
+
+		MinValue = Samples[0];
+		MaxValue = Samples[0];
+		for (const float Sample : Samples)
+		{
+			MinValue = FMath::Min(MinValue, Sample);
+			MaxValue = FMath::Max(MaxValue, Sample);
+		}
+	}
+
+	bool IsBaked() const
+	{
+		return Samples.Num() > 0;
+	}
+
+	float Eval(float InTime) const
+	{
+		const int32 LastIndex = Samples.Num() - 1;
+		if (LastIndex <= 0)
+		{
+			return (LastIndex == 0) ? Samples[0] : 0.0f;
+		}
+
+		const float Position = FMath::Clamp((InTime - MinTime) * InvStep, 0.0f, (float)LastIndex);
+		const int32 Index = FMath::Min((int32)Position, LastIndex - 1);
+		return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - (float)Index);
+	}
+
+	float GetMinValue() const { return MinValue; }
+	float GetMaxValue() const { return MaxValue; }
+
+private:
+	TArray<float> Samples;
+	float MinTime = 0.0f;
+	float InvStep = 0.0f;
+	float MinValue = 0.0f;
+	float MaxValue = 0.0f;
+};
@@ -8,8 +8,12 @@
 #include "NativeGameplayTags.h"
 #include "Weapons/LyraWeaponStateComponent.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/LyraGameplayAbilityTargetData_CompressedCartridge.h"
 #include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
 #include "DrawDebugHelpers.h"
+#include "GameFramework/GameStateBase.h"
+#include "Weapons/LyraLagCompensationSubsystem.h"
+#include "Weapons/LyraProjectileSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayAbility_RangedWeapon)
 
@@ -35,6 +39,13 @@ namespace LyraConsoleVariables
 		DrawBulletHitRadius,
 		TEXT("When bullet hit debug drawing is enabled (see DrawBulletHitDuration), how big should the hit radius be? (in uu)"),
 		ECVF_Default);
+
+	static bool bCompressTargetData = true;
+	static FAutoConsoleVariableRef CVarCompressTargetData(
+		TEXT("lyra.Weapon.CompressTargetData"),
+		bCompressTargetData,
+		TEXT("Should the hits of a cartridge be packed into a single quantized target data entry when sent to the server?"),
+		ECVF_Default);
 }
 
 // Weapon fire will be blocked/canceled if the player has this tag
@@ -399,6 +410,17 @@ void ULyraGameplayAbility_RangedWeapon::TraceBulletsInCartridge(const FRangedWea
 		const FVector EndTrace = InputData.StartTrace + (BulletDir * WeaponData->GetMaxDamageRange());
 		FVector HitLocation = EndTrace;
 
+		if (WeaponData->FiresProjectiles())
+		{
+			// Projectiles are swept by the server as they fly, only the launch direction of each bullet is sent
+			FHitResult& LaunchData = OutHits.Emplace_GetRef(ForceInit);
+			LaunchData.TraceStart = InputData.StartTrace;
+			LaunchData.TraceEnd = EndTrace;
+			LaunchData.Location = EndTrace;
+			LaunchData.ImpactPoint = EndTrace;
+			continue;
+		}
+
 		TArray<FHitResult> AllImpacts;
 
 		FHitResult Impact = DoSingleBulletTrace(InputData.StartTrace, EndTrace, WeaponData->GetBulletTraceSweepRadius(), /*bIsSimulated=*/ false, /*out*/ AllImpacts);
@@ -486,15 +508,22 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 		// Take ownership of the target data to make sure no callbacks into game code invalidate it out from under us
 		FGameplayAbilityTargetDataHandle LocalTargetDataHandle(MoveTemp(const_cast<FGameplayAbilityTargetDataHandle&>(InData)));
 
+		// Data sent by a remote client may arrive packed, the rest of the ability works on individual hits
+		FLyraGameplayAbilityTargetData_CompressedCartridge::ExpandHandle(LocalTargetDataHandle);
+
 		const bool bShouldNotifyServer = CurrentActorInfo->IsLocallyControlled() && !CurrentActorInfo->IsNetAuthority();
 		if (bShouldNotifyServer)
 		{
-			MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
+			FGameplayAbilityTargetDataHandle CompressedTargetDataHandle;
+			const bool bCompressed = LyraConsoleVariables::bCompressTargetData && FLyraGameplayAbilityTargetData_CompressedCartridge::CompressHandle(LocalTargetDataHandle, /*out*/ CompressedTargetDataHandle);
+
+			MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), bCompressed ? CompressedTargetDataHandle : LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
 		}
 
 		const bool bIsTargetDataValid = true;
 
-		bool bProjectileWeapon = false;
+		ULyraRangedWeaponInstance* WeaponData = GetWeaponInstance();
+		const bool bProjectileWeapon = WeaponData && WeaponData->FiresProjectiles();
 
 #if WITH_SERVER_CODE
 		if (!bProjectileWeapon)
@@ -503,6 +532,13 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 			{
 				if (Controller->GetLocalRole() == ROLE_Authority)
 				{
+					// Re-trace hits reported by remote clients against where the targets were when they fired
+					TArray<uint8> RejectedHits;
+					if (!CurrentActorInfo->IsLocallyControlled())
+					{
+						FindRejectedHits(LocalTargetDataHandle, /*out*/ RejectedHits);
+					}
+
 					// Confirm hit markers
 					if (ULyraWeaponStateComponent* WeaponStateComponent = Controller->FindComponentByClass<ULyraWeaponStateComponent>())
 					{
@@ -511,7 +547,7 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 						{
 							if (FGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<FGameplayAbilityTargetData_SingleTargetHit*>(LocalTargetDataHandle.Get(i)))
 							{
-								if (SingleTargetHit->bHitReplaced)
+								if (SingleTargetHit->bHitReplaced || RejectedHits.Contains(i))
 								{
 									HitReplaces.Add(i);
 								}
@@ -521,6 +557,11 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 						WeaponStateComponent->ClientConfirmTargetData(LocalTargetDataHandle.UniqueId, bIsTargetDataValid, HitReplaces);
 					}
 
+					// Rejected hits must not reach the blueprint that applies damage
+					for (int32 RejectedIndex = RejectedHits.Num() - 1; RejectedIndex >= 0; --RejectedIndex)
+					{
+						LocalTargetDataHandle.Data.RemoveAt(RejectedHits[RejectedIndex]);
+					}
 				}
 			}
 		}
@@ -531,10 +572,21 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 		if (bIsTargetDataValid && CommitAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo))
 		{
 			// We fired the weapon, add spread
-			ULyraRangedWeaponInstance* WeaponData = GetWeaponInstance();
 			check(WeaponData);
 			WeaponData->AddSpread();
 
+			if (bProjectileWeapon)
+			{
+				if (CurrentActorInfo->IsNetAuthority())
+				{
+					LaunchProjectiles(LocalTargetDataHandle);
+				}
+
+				// The entries are launch records (their impact point is just the end of the trace), nothing has been hit yet.
+				// Projectile impacts are applied by ULyraProjectileSubsystem when they happen.
+				LocalTargetDataHandle.Clear();
+			}
+
 			// Let the blueprint do stuff like apply effects to the targets
 			OnRangedWeaponTargetDataReady(LocalTargetDataHandle);
 		}
@@ -549,6 +601,77 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 	MyAbilityComponent->ConsumeClientReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey());
 }
 
+void ULyraGameplayAbility_RangedWeapon::LaunchProjectiles(const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	ULyraProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<ULyraProjectileSubsystem>();
+	ULyraRangedWeaponInstance* WeaponData = GetWeaponInstance();
+	AActor* AvatarActor = GetAvatarActorFromActorInfo();
+	if ((ProjectileSubsystem == nullptr) || (WeaponData == nullptr) || (AvatarActor == nullptr))
+	{
+		return;
+	}
+
+	// One spec is shared by every projectile in the cartridge
+	FGameplayEffectSpecHandle ImpactEffectSpec;
+	if (ProjectileImpactEffect != nullptr)
+	{
+		ImpactEffectSpec = MakeOutgoingGameplayEffectSpec(ProjectileImpactEffect, GetAbilityLevel());
+	}
+
+	const FVector AvatarLocation = AvatarActor->GetActorLocation();
+	for (int32 Index = 0; Index < TargetData.Num(); ++Index)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(Index);
+		const FHitResult* LaunchData = (Data != nullptr) ? Data->GetHitResult() : nullptr;
+		if (LaunchData == nullptr)
+		{
+			continue;
+		}
+
+		// Don't let clients launch projectiles from somewhere they are not
+		FVector Origin = LaunchData->TraceStart;
+		if (FVector::DistSquared(Origin, AvatarLocation) > FMath::Square(MaxProjectileOriginError))
+		{
+			Origin = GetWeaponTargetingSourceLocation();
+		}
+
+		int32 CartridgeID = INDEX_NONE;
+		if (Data->GetScriptStruct() == FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct())
+		{
+			CartridgeID = static_cast<const FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data)->CartridgeID;
+		}
+
+		const FVector Direction = (LaunchData->TraceEnd - LaunchData->TraceStart).GetSafeNormal();
+		ProjectileSubsystem->LaunchProjectile(WeaponData->GetProjectileParams(), Origin, Direction, AvatarActor, ImpactEffectSpec, CartridgeID);
+	}
+}
+
+void ULyraGameplayAbility_RangedWeapon::FindRejectedHits(const FGameplayAbilityTargetDataHandle& TargetData, OUT TArray<uint8>& OutRejectedHits) const
+{
+	const ULyraLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULyraLagCompensationSubsystem>();
+	if (LagCompensation == nullptr)
+	{
+		return;
+	}
+
+	for (uint8 i = 0; (i < TargetData.Num()) && (i < 255); ++i)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(i);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct()))
+		{
+			continue;
+		}
+
+		const FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<const FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data);
+		const FHitResult& HitResult = SingleTargetHit->HitResult;
+		if (HitResult.bBlockingHit && !LagCompensation->ConfirmHit(HitResult.GetActor(), SingleTargetHit->FireTimestamp, HitResult.TraceStart, HitResult.ImpactPoint))
+		{
+			UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected hit on %s (fired at %.3f)"), *GetPathName(), *GetNameSafe(HitResult.GetActor()), SingleTargetHit->FireTimestamp);
+			OutRejectedHits.Add(i);
+		}
+	}
+}
+
 void ULyraGameplayAbility_RangedWeapon::StartRangedWeaponTargeting()
 {
 	check(CurrentActorInfo);
@@ -576,18 +699,23 @@ void ULyraGameplayAbility_RangedWeapon::StartRangedWeaponTargeting()
 	{
 		const int32 CartridgeID = FMath::Rand();
 
+		const AGameStateBase* GameState = GetWorld()->GetGameState();
+		const double FireTimestamp = (GameState != nullptr) ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
 		for (const FHitResult& FoundHit : FoundHits)
 		{
 			FLyraGameplayAbilityTargetData_SingleTargetHit* NewTargetData = new FLyraGameplayAbilityTargetData_SingleTargetHit();
 			NewTargetData->HitResult = FoundHit;
 			NewTargetData->CartridgeID = CartridgeID;
+			NewTargetData->FireTimestamp = FireTimestamp;
 
 			TargetData.Add(NewTargetData);
 		}
 	}
 
-	// Send hit marker information
-	if (WeaponStateComponent != nullptr)
+	// Send hit marker information (projectiles haven't hit anything yet)
+	const ULyraRangedWeaponInstance* WeaponData = GetWeaponInstance();
+	if ((WeaponStateComponent != nullptr) && !(WeaponData && WeaponData->FiresProjectiles()))
 	{
 		WeaponStateComponent->AddUnconfirmedServerSideHitMarkers(TargetData, FoundHits);
 	}
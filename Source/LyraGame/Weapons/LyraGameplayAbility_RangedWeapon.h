@@ -9,6 +9,7 @@
 enum ECollisionChannel : int;
 
 class APawn;
+class UGameplayEffect;
 class ULyraRangedWeaponInstance;
 class UObject;
 struct FCollisionQueryParams;
@@ -111,6 +112,12 @@ protected:
 
 	void OnTargetDataReadyCallback(const FGameplayAbilityTargetDataHandle& InData, FGameplayTag ApplicationTag);
 
+	// Server only: launches a projectile for each bullet of the cartridge described by TargetData
+	void LaunchProjectiles(const FGameplayAbilityTargetDataHandle& TargetData);
+
+	// Server only: re-traces client reported hits against the lag compensation history and returns the indices of the ones that don't hold up
+	void FindRejectedHits(const FGameplayAbilityTargetDataHandle& TargetData, OUT TArray<uint8>& OutRejectedHits) const;
+
 	UFUNCTION(BlueprintCallable)
 	void StartRangedWeaponTargeting();
 
@@ -118,6 +125,15 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnRangedWeaponTargetDataReady(const FGameplayAbilityTargetDataHandle& TargetData);
 
+protected:
+	// Effect applied to whatever a projectile hits, for weapons that fire projectiles (hitscan weapons apply their effects from OnRangedWeaponTargetDataReady)
+	UPROPERTY(EditDefaultsOnly, Category="Projectile")
+	TSubclassOf<UGameplayEffect> ProjectileImpactEffect;
+
+	// How far from the avatar a client-provided projectile origin may be before the server launches from the avatar instead
+	UPROPERTY(EditDefaultsOnly, Category="Projectile", meta=(ForceUnits=cm))
+	float MaxProjectileOriginError = 300.0f;
+
 private:
 	FDelegateHandle OnTargetDataReadyCallbackDelegateHandle;
 };
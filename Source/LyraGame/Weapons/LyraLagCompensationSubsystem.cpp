@@ -0,0 +1,368 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraLagCompensationSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraLagCompensationSubsystem)
+
+namespace LyraConsoleVariables
+{
+	static bool bEnableLagCompensation = true;
+	static FAutoConsoleVariableRef CVarEnableLagCompensation(
+		TEXT("lyra.Weapon.LagCompensation.Enable"),
+		bEnableLagCompensation,
+		TEXT("Should the server re-trace client reported weapon hits against recorded hitbox history?"),
+		ECVF_Default);
+
+	static int32 LagCompensationHistoryFrames = 64;
+	static FAutoConsoleVariableRef CVarLagCompensationHistoryFrames(
+		TEXT("lyra.Weapon.LagCompensation.HistoryFrames"),
+		LagCompensationHistoryFrames,
+		TEXT("Number of server frames of hitbox history to keep (read when the world starts)"),
+		ECVF_Default);
+
+	static int32 LagCompensationMaxCharacters = 64;
+	static FAutoConsoleVariableRef CVarLagCompensationMaxCharacters(
+		TEXT("lyra.Weapon.LagCompensation.MaxCharacters"),
+		LagCompensationMaxCharacters,
+		TEXT("Maximum number of characters whose hitboxes are recorded (read when the world starts)"),
+		ECVF_Default);
+
+	static float LagCompensationMaxRewindTime = 0.5f;
+	static FAutoConsoleVariableRef CVarLagCompensationMaxRewindTime(
+		TEXT("lyra.Weapon.LagCompensation.MaxRewindTime"),
+		LagCompensationMaxRewindTime,
+		TEXT("Furthest back in time (in seconds) a client's shot is allowed to be rewound"),
+		ECVF_Default);
+
+	static float LagCompensationHitTolerance = 20.0f;
+	static FAutoConsoleVariableRef CVarLagCompensationHitTolerance(
+		TEXT("lyra.Weapon.LagCompensation.HitTolerance"),
+		LagCompensationHitTolerance,
+		TEXT("Extra distance (in uu) added to a rewound hitbox before a client reported hit is rejected"),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraHitboxHistory
+
+void FLyraHitboxHistory::Initialize(int32 InMaxFrames, int32 InMaxSlots)
+{
+	MaxFrames = FMath::Max(InMaxFrames, 2);
+	MaxSlots = FMath::Max(InMaxSlots, 1);
+
+	const int32 NumSamples = MaxFrames * MaxSlots;
+
+	FrameTimestamps.SetNumZeroed(MaxFrames);
+	FrameSerials.SetNumZeroed(MaxFrames);
+	Centers.SetNumZeroed(NumSamples);
+	HalfHeights.SetNumZeroed(NumSamples);
+	Radii.SetNumZeroed(NumSamples);
+	SlotFirstSerial.SetNumZeroed(MaxSlots);
+
+	Reset();
+}
+
+void FLyraHitboxHistory::Reset()
+{
+	NumFrames = 0;
+	HeadFrame = INDEX_NONE;
+	NextSerial = 1;
+
+	for (uint32& FirstSerial : SlotFirstSerial)
+	{
+		FirstSerial = MAX_uint32;
+	}
+}
+
+SIZE_T FLyraHitboxHistory::GetAllocatedSize() const
+{
+	return FrameTimestamps.GetAllocatedSize() + FrameSerials.GetAllocatedSize() + Centers.GetAllocatedSize() +
+		HalfHeights.GetAllocatedSize() + Radii.GetAllocatedSize() + SlotFirstSerial.GetAllocatedSize();
+}
+
+int32 FLyraHitboxHistory::BeginFrame(double Timestamp)
+{
+	check(MaxFrames > 0);
+
+	HeadFrame = (HeadFrame + 1) % MaxFrames;
+	NumFrames = FMath::Min(NumFrames + 1, MaxFrames);
+
+	FrameTimestamps[HeadFrame] = Timestamp;
+	FrameSerials[HeadFrame] = NextSerial++;
+
+	return HeadFrame;
+}
+
+void FLyraHitboxHistory::WriteSlot(int32 FrameIndex, int32 SlotIndex, const FVector& Center, float HalfHeight, float Radius)
+{
+	const int32 SampleIndex = FrameIndex * MaxSlots + SlotIndex;
+	Centers[SampleIndex] = FVector3f(Center);
+	HalfHeights[SampleIndex] = HalfHeight;
+	Radii[SampleIndex] = Radius;
+}
+
+void FLyraHitboxHistory::ResetSlot(int32 SlotIndex)
+{
+	SlotFirstSerial[SlotIndex] = NextSerial;
+}
+
+int32 FLyraHitboxHistory::GetFrameIndex(int32 Age) const
+{
+	return (HeadFrame - Age + MaxFrames) % MaxFrames;
+}
+
+bool FLyraHitboxHistory::SegmentHitsSlotAtTime(int32 SlotIndex, double Timestamp, const FVector& SegmentStart, const FVector& SegmentEnd, float Tolerance, bool& bOutHit) const
+{
+	bOutHit = false;
+
+	if ((NumFrames == 0) || !SlotFirstSerial.IsValidIndex(SlotIndex))
+	{
+		return false;
+	}
+
+	// Frames get older as the age grows, find the youngest frame recorded at or before Timestamp
+	int32 OlderAge = INDEX_NONE;
+	{
+		int32 Low = 0;
+		int32 High = NumFrames - 1;
+		while (Low <= High)
+		{
+			const int32 Mid = (Low + High) / 2;
+			if (FrameTimestamps[GetFrameIndex(Mid)] <= Timestamp)
+			{
+				OlderAge = Mid;
+				High = Mid - 1;
+			}
+			else
+			{
+				Low = Mid + 1;
+			}
+		}
+	}
+
+	if (OlderAge == INDEX_NONE)
+	{
+		// Older than anything we have recorded
+		return false;
+	}
+
+	const int32 OlderFrame = GetFrameIndex(OlderAge);
+	const int32 NewerFrame = (OlderAge > 0) ? GetFrameIndex(OlderAge - 1) : OlderFrame;
+
+	const uint32 FirstSerial = SlotFirstSerial[SlotIndex];
+	if (FrameSerials[OlderFrame] < FirstSerial)
+	{
+		// The slot belonged to someone else (or nobody) at that time
+		return false;
+	}
+
+	const int32 OlderSample = OlderFrame * MaxSlots + SlotIndex;
+	const int32 NewerSample = NewerFrame * MaxSlots + SlotIndex;
+
+	const double OlderTime = FrameTimestamps[OlderFrame];
+	const double NewerTime = FrameTimestamps[NewerFrame];
+	const float Alpha = (NewerTime > OlderTime) ? (float)FMath::Clamp((Timestamp - OlderTime) / (NewerTime - OlderTime), 0.0, 1.0) : 0.0f;
+
+	const FVector Center = FVector(FMath::Lerp(Centers[OlderSample], Centers[NewerSample], Alpha));
+	const float HalfHeight = FMath::Lerp(HalfHeights[OlderSample], HalfHeights[NewerSample], Alpha);
+	const float Radius = FMath::Lerp(Radii[OlderSample], Radii[NewerSample], Alpha);
+
+	// Character capsules stay upright, so the capsule is a vertical segment swept by Radius
+	const FVector AxisOffset(0.0, 0.0, FMath::Max(HalfHeight - Radius, 0.0f));
+
+	FVector ClosestOnSegment;
+	FVector ClosestOnAxis;
+	FMath::SegmentDistToSegmentSafe(SegmentStart, SegmentEnd, Center - AxisOffset, Center + AxisOffset, /*out*/ ClosestOnSegment, /*out*/ ClosestOnAxis);
+
+	bOutHit = FVector::DistSquared(ClosestOnSegment, ClosestOnAxis) <= FMath::Square(Radius + Tolerance);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraLagCompensationSubsystem
+
+ULyraLagCompensationSubsystem::ULyraLagCompensationSubsystem()
+{
+}
+
+void ULyraLagCompensationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	History.Initialize(LyraConsoleVariables::LagCompensationHistoryFrames, LyraConsoleVariables::LagCompensationMaxCharacters);
+	SlotCharacters.SetNum(History.GetMaxSlots());
+}
+
+void ULyraLagCompensationSubsystem::Deinitialize()
+{
+	SlotCharacters.Reset();
+	ActorToSlot.Reset();
+	History.Reset();
+
+	Super::Deinitialize();
+}
+
+bool ULyraLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+TStatId ULyraLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void ULyraLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	if ((World->GetNetMode() == NM_Client) || ActorToSlot.IsEmpty() || !LyraConsoleVariables::bEnableLagCompensation)
+	{
+		return;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	const double Now = (GameState != nullptr) ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+
+	const int32 FrameIndex = History.BeginFrame(Now);
+	for (int32 SlotIndex = 0; SlotIndex < SlotCharacters.Num(); ++SlotIndex)
+	{
+		if (const ACharacter* Character = SlotCharacters[SlotIndex].Get())
+		{
+			if (const UCapsuleComponent* Capsule = Character->GetCapsuleComponent())
+			{
+				History.WriteSlot(FrameIndex, SlotIndex, Capsule->GetComponentLocation(), Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+			}
+		}
+	}
+}
+
+void ULyraLagCompensationSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if ((Character == nullptr) || ActorToSlot.Contains(Character))
+	{
+		return;
+	}
+
+	const int32 SlotIndex = SlotCharacters.IndexOfByPredicate([](const TWeakObjectPtr<ACharacter>& Entry) { return !Entry.IsValid(); });
+	if (SlotIndex == INDEX_NONE)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Lag compensation history is full (%d characters), hits on %s will not be validated"), SlotCharacters.Num(), *GetNameSafe(Character));
+		return;
+	}
+
+	SlotCharacters[SlotIndex] = Character;
+	ActorToSlot.Add(Character, SlotIndex);
+	History.ResetSlot(SlotIndex);
+}
+
+void ULyraLagCompensationSubsystem::UnregisterCharacter(ACharacter* Character)
+{
+	int32 SlotIndex = INDEX_NONE;
+	if (ActorToSlot.RemoveAndCopyValue(Character, /*out*/ SlotIndex))
+	{
+		SlotCharacters[SlotIndex].Reset();
+	}
+}
+
+bool ULyraLagCompensationSubsystem::IsTracked(const AActor* Actor) const
+{
+	return ActorToSlot.Contains(Actor);
+}
+
+bool ULyraLagCompensationSubsystem::ConfirmHit(const AActor* HitActor, double ClientTimestamp, const FVector& TraceStart, const FVector& ImpactPoint) const
+{
+	if (!LyraConsoleVariables::bEnableLagCompensation || (HitActor == nullptr))
+	{
+		return true;
+	}
+
+	// Hits on things attached to a character (weapons, cosmetics) are checked against the character
+	const int32* SlotIndex = ActorToSlot.Find(HitActor);
+	if ((SlotIndex == nullptr) && (HitActor->GetAttachParentActor() != nullptr))
+	{
+		SlotIndex = ActorToSlot.Find(HitActor->GetAttachParentActor());
+	}
+
+	if (SlotIndex == nullptr)
+	{
+		return true;
+	}
+
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	const double Now = (GameState != nullptr) ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+	const double RewindTime = FMath::Clamp(ClientTimestamp, Now - LyraConsoleVariables::LagCompensationMaxRewindTime, Now);
+
+	const float Tolerance = LyraConsoleVariables::LagCompensationHitTolerance;
+	const FVector TraceEnd = ImpactPoint + (ImpactPoint - TraceStart).GetSafeNormal() * Tolerance;
+
+	bool bHit = false;
+	if (!History.SegmentHitsSlotAtTime(*SlotIndex, RewindTime, TraceStart, TraceEnd, Tolerance, /*out*/ bHit))
+	{
+		// No history covering that time (e.g., the character just spawned), trust the client
+		return true;
+	}
+
+	return bHit;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand CVarBenchmarkLagCompensation(
+	TEXT("lyra.Weapon.LagCompensation.Benchmark"),
+	TEXT("Measures hit validation cost against a synthetic 64 character history. Usage: lyra.Weapon.LagCompensation.Benchmark [NumShots]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(
+		[](const TArray<FString>& Args)
+		{
+			const int32 NumShots = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 100000;
+			const int32 NumCharacters = 64;
+			const int32 NumFrames = 64;
+			const double FrameTime = 1.0 / 30.0;
+
+			FLyraHitboxHistory History;
+			History.Initialize(NumFrames, NumCharacters);
+
+			const double RecordStartTime = FPlatformTime::Seconds();
+			for (int32 FrameNumber = 0; FrameNumber < NumFrames * 2; ++FrameNumber)
+			{
+				const int32 FrameIndex = History.BeginFrame(FrameNumber * FrameTime);
+				for (int32 SlotIndex = 0; SlotIndex < NumCharacters; ++SlotIndex)
+				{
+					const FVector Center(SlotIndex * 200.0, FrameNumber * 10.0, 90.0);
+					History.WriteSlot(FrameIndex, SlotIndex, Center, 90.0f, 40.0f);
+				}
+			}
+			const double RecordSeconds = (FPlatformTime::Seconds() - RecordStartTime) / (NumFrames * 2);
+
+			const double Newest = (NumFrames * 2 - 1) * FrameTime;
+			int32 NumConfirmed = 0;
+
+			const double QueryStartTime = FPlatformTime::Seconds();
+			for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+			{
+				const int32 SlotIndex = ShotIndex % NumCharacters;
+				const double Timestamp = Newest - (ShotIndex % NumFrames) * FrameTime * 0.5;
+				const FVector Target(SlotIndex * 200.0, Timestamp / FrameTime * 10.0, 90.0);
+				const FVector Start = Target - FVector(2000.0, 0.0, 0.0);
+
+				bool bHit = false;
+				History.SegmentHitsSlotAtTime(SlotIndex, Timestamp, Start, Target, 20.0f, /*out*/ bHit);
+				NumConfirmed += bHit ? 1 : 0;
+			}
+			const double QuerySeconds = FPlatformTime::Seconds() - QueryStartTime;
+
+			UE_LOG(LogLyra, Log, TEXT("Lag compensation benchmark: %d characters x %d frames (%llu bytes)"), NumCharacters, NumFrames, (uint64)History.GetAllocatedSize());
+			UE_LOG(LogLyra, Log, TEXT("  Record: %.3f us per frame"), RecordSeconds * 1000000.0);
+			UE_LOG(LogLyra, Log, TEXT("  Validate: %d shots in %.3f ms (%.1f ns per shot, %d confirmed)"), NumShots, QuerySeconds * 1000.0, (NumShots > 0) ? (QuerySeconds * 1000000000.0 / NumShots) : 0.0, NumConfirmed);
+		}));
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "LyraLagCompensationSubsystem.generated.h"
+
+class ACharacter;
+class UObject;
+class UWorld;
+
+/**
+ * FLyraHitboxHistory
+ *
+ * Fixed-size ring buffer of hitbox poses for a bounded set of tracked slots.
+ * Storage is structure-of-arrays, indexed by [FrameIndex * MaxSlots + SlotIndex], so a
+ * rewind query only touches the two bracketing frames of the slot it is interested in.
+ * Memory is allocated once in Initialize and never grows afterwards.
+ */
+struct FLyraHitboxHistory
+{
+public:
+	void Initialize(int32 InMaxFrames, int32 InMaxSlots);
+	void Reset();
+
+	int32 GetMaxFrames() const { return MaxFrames; }
+	int32 GetMaxSlots() const { return MaxSlots; }
+	int32 GetNumRecordedFrames() const { return NumFrames; }
+	SIZE_T GetAllocatedSize() const;
+
+	/** Starts a new frame at the given server time, overwriting the oldest one when full. Returns the frame index to write into. */
+	int32 BeginFrame(double Timestamp);
+
+	/** Writes the capsule of a slot for the frame returned by BeginFrame */
+	void WriteSlot(int32 FrameIndex, int32 SlotIndex, const FVector& Center, float HalfHeight, float Radius);
+
+	/** Marks a slot as (re)assigned, so frames recorded before now are never used for it */
+	void ResetSlot(int32 SlotIndex);
+
+	/**
+	 * Tests a segment against the capsule of a slot interpolated at Timestamp.
+	 * Returns false if the slot has no history covering that time.
+	 */
+	bool SegmentHitsSlotAtTime(int32 SlotIndex, double Timestamp, const FVector& SegmentStart, const FVector& SegmentEnd, float Tolerance, bool& bOutHit) const;
+
+private:
+	int32 GetFrameIndex(int32 Age) const;
+
+private:
+	// Per-frame data
+	TArray<double> FrameTimestamps;
+	TArray<uint32> FrameSerials;
+
+	// Per-frame, per-slot data
+	TArray<FVector3f> Centers;
+	TArray<float> HalfHeights;
+	TArray<float> Radii;
+
+	// Per-slot serial of the first frame that belongs to the slot's current owner
+	TArray<uint32> SlotFirstSerial;
+
+	int32 MaxFrames = 0;
+	int32 MaxSlots = 0;
+	int32 NumFrames = 0;
+	int32 HeadFrame = INDEX_NONE;
+	uint32 NextSerial = 1;
+};
+
+
+/**
+ * ULyraLagCompensationSubsystem
+ *
+ * Server-side record of character hitbox poses over the last fraction of a second, used to
+ * validate client-reported weapon hits against where the target was when the client fired.
+ */
+UCLASS()
+class ULyraLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULyraLagCompensationSubsystem();
+
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** Starts recording the hitbox of a character (authority only) */
+	void RegisterCharacter(ACharacter* Character);
+
+	/** Stops recording the hitbox of a character */
+	void UnregisterCharacter(ACharacter* Character);
+
+	/** Returns true if the actor is being recorded */
+	bool IsTracked(const AActor* Actor) const;
+
+	/**
+	 * Re-traces a client reported hit against the historical pose of HitActor at ClientTimestamp.
+	 * Hits on actors that are not tracked, or older than the recorded history, are accepted as-is.
+	 */
+	bool ConfirmHit(const AActor* HitActor, double ClientTimestamp, const FVector& TraceStart, const FVector& ImpactPoint) const;
+
+protected:
+	//~UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+private:
+	FLyraHitboxHistory History;
+
+	TArray<TWeakObjectPtr<ACharacter>> SlotCharacters;
+	TMap<TObjectKey<AActor>, int32> ActorToSlot;
+};
@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraProjectileReplicator.h"
+
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraProjectileReplicator)
+
+ALyraProjectileReplicator::ALyraProjectileReplicator(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetPriority = 2.0f;
+	SetReplicatingMovement(false);
+}
+
+void ALyraProjectileReplicator::MulticastProjectileEvents_Implementation(const TArray<FLyraProjectileSpawnRecord>& Spawns, const TArray<FLyraProjectileImpactRecord>& Impacts)
+{
+	// The server already simulated these
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (ULyraProjectileSubsystem* ProjectileSubsystem = UWorld::GetSubsystem<ULyraProjectileSubsystem>(GetWorld()))
+	{
+		ProjectileSubsystem->HandleReplicatedEvents(Spawns, Impacts);
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Info.h"
+#include "Weapons/LyraProjectileSubsystem.h"
+
+#include "LyraProjectileReplicator.generated.h"
+
+class UObject;
+struct FFrame;
+
+/**
+ * ALyraProjectileReplicator
+ *
+ * Single always-relevant actor spawned by ULyraProjectileSubsystem on the server,
+ * used to send batched projectile spawn and impact records to clients.
+ */
+UCLASS(NotPlaceable, Transient)
+class ALyraProjectileReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ALyraProjectileReplicator(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastProjectileEvents(const TArray<FLyraProjectileSpawnRecord>& Spawns, const TArray<FLyraProjectileImpactRecord>& Impacts);
+};
@@ -0,0 +1,304 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraProjectileSubsystem.h"
+
+#include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
+#include "AbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Physics/LyraCollisionChannels.h"
+#include "Weapons/LyraProjectileReplicator.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraProjectileSubsystem)
+
+namespace LyraConsoleVariables
+{
+	static int32 MaxProjectiles = 4096;
+	static FAutoConsoleVariableRef CVarMaxProjectiles(
+		TEXT("lyra.Weapon.Projectile.MaxProjectiles"),
+		MaxProjectiles,
+		TEXT("Maximum number of projectiles simulated at once per world; launches beyond this are dropped"),
+		ECVF_Default);
+
+	static float ProjectileMaxSubstepTime = 1.0f / 60.0f;
+	static FAutoConsoleVariableRef CVarProjectileMaxSubstepTime(
+		TEXT("lyra.Weapon.Projectile.MaxSubstepTime"),
+		ProjectileMaxSubstepTime,
+		TEXT("Longest time step (in seconds) a projectile is moved and swept in one go"),
+		ECVF_Default);
+
+	static int32 ProjectileMaxSubsteps = 8;
+	static FAutoConsoleVariableRef CVarProjectileMaxSubsteps(
+		TEXT("lyra.Weapon.Projectile.MaxSubsteps"),
+		ProjectileMaxSubsteps,
+		TEXT("Maximum number of sub-steps per frame for projectile simulation"),
+		ECVF_Default);
+
+	static int32 ProjectileMaxRecordsPerMulticast = 128;
+	static FAutoConsoleVariableRef CVarProjectileMaxRecordsPerMulticast(
+		TEXT("lyra.Weapon.Projectile.MaxRecordsPerMulticast"),
+		ProjectileMaxRecordsPerMulticast,
+		TEXT("Maximum number of spawn (and impact) records sent to clients in a single multicast"),
+		ECVF_Default);
+}
+
+bool ULyraProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+void ULyraProjectileSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() != NM_Client)
+	{
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.ObjectFlags |= RF_Transient;
+		Replicator = InWorld.SpawnActor<ALyraProjectileReplicator>(SpawnInfo);
+	}
+}
+
+TStatId ULyraProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraProjectileSubsystem, STATGROUP_Tickables);
+}
+
+double ULyraProjectileSubsystem::GetServerWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	return (GameState != nullptr) ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+int32 ULyraProjectileSubsystem::AddProjectile(uint16 ProjectileId, const FVector& Origin, const FVector& Velocity, float GravityScale, float CollisionRadius, float Lifetime)
+{
+	Positions.Add(Origin);
+	PreviousPositions.Add(Origin);
+	Velocities.Add(Velocity);
+	GravityScales.Add(GravityScale);
+	CollisionRadii.Add(CollisionRadius);
+	TimeRemaining.Add(Lifetime);
+	ProjectileIds.Add(ProjectileId);
+	return Payloads.AddDefaulted();
+}
+
+void ULyraProjectileSubsystem::RemoveProjectileAtSwap(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PreviousPositions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityScales.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CollisionRadii.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TimeRemaining.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ProjectileIds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Payloads.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+bool ULyraProjectileSubsystem::LaunchProjectile(const FLyraProjectileParams& Params, const FVector& Origin, const FVector& Direction, AActor* Instigator, const FGameplayEffectSpecHandle& ImpactEffect, int32 CartridgeID)
+{
+	check(GetWorld()->GetNetMode() != NM_Client);
+
+	if (Positions.Num() >= LyraConsoleVariables::MaxProjectiles)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Dropping projectile launched by %s, %d projectiles are already simulating"), *GetNameSafe(Instigator), Positions.Num());
+		return false;
+	}
+
+	// Quantize up front, so the server simulates exactly what clients will
+	const uint8 QuantizedGravityScale = (uint8)FMath::Clamp(FMath::RoundToInt(Params.GravityScale * 100.0f), 0, 255);
+	const uint8 QuantizedLifetime = (uint8)FMath::Clamp(FMath::RoundToInt(Params.MaxLifetime * 10.0f), 1, 255);
+
+	FLyraProjectileSpawnRecord& Record = PendingSpawnRecords.AddDefaulted_GetRef();
+	Record.Origin = Origin;
+	Record.Velocity = Direction.GetSafeNormal() * Params.Speed;
+	Record.LaunchTime = GetServerWorldTime();
+	Record.ProjectileId = NextProjectileId++;
+	Record.GravityScale = QuantizedGravityScale;
+	Record.Lifetime = QuantizedLifetime;
+
+	const int32 Index = AddProjectile(Record.ProjectileId, Record.Origin, Record.Velocity, QuantizedGravityScale * 0.01f, Params.CollisionRadius, QuantizedLifetime * 0.1f);
+
+	FProjectilePayload& Payload = Payloads[Index];
+	Payload.Instigator = Instigator;
+	Payload.ImpactEffect = ImpactEffect;
+	Payload.CartridgeID = CartridgeID;
+
+	OnProjectileLaunched.Broadcast(Record.ProjectileId, Origin);
+
+	return true;
+}
+
+void ULyraProjectileSubsystem::HandleReplicatedEvents(const TArray<FLyraProjectileSpawnRecord>& Spawns, const TArray<FLyraProjectileImpactRecord>& Impacts)
+{
+	const FVector Gravity(0.0, 0.0, GetWorld()->GetGravityZ());
+	const double Now = GetServerWorldTime();
+
+	for (const FLyraProjectileSpawnRecord& Record : Spawns)
+	{
+		const float GravityScale = Record.GravityScale * 0.01f;
+		const float Lifetime = Record.Lifetime * 0.1f;
+
+		// Catch up with where the server has already moved the projectile to
+		const float Age = FMath::Clamp((float)(Now - Record.LaunchTime), 0.0f, Lifetime);
+		if (Age >= Lifetime)
+		{
+			continue;
+		}
+
+		const FVector Acceleration = Gravity * GravityScale;
+		const FVector Origin = Record.Origin + (Record.Velocity * Age) + (0.5f * Acceleration * Age * Age);
+		const FVector Velocity = Record.Velocity + (Acceleration * Age);
+
+		AddProjectile(Record.ProjectileId, Origin, Velocity, GravityScale, 0.0f, Lifetime - Age);
+
+		OnProjectileLaunched.Broadcast(Record.ProjectileId, Origin);
+	}
+
+	for (const FLyraProjectileImpactRecord& Record : Impacts)
+	{
+		const int32 Index = ProjectileIds.IndexOfByKey(Record.ProjectileId);
+		if (Index != INDEX_NONE)
+		{
+			RemoveProjectileAtSwap(Index);
+		}
+
+		OnProjectileImpact.Broadcast(Record.ProjectileId, Record.Location);
+	}
+}
+
+void ULyraProjectileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const bool bIsAuthority = (GetWorld()->GetNetMode() != NM_Client);
+
+	if (Positions.Num() > 0)
+	{
+		// Only the server sweeps, clients just move the projectiles along until the server says they hit
+		Simulate(DeltaTime, /*bSweep=*/ bIsAuthority);
+	}
+
+	for (const FPendingImpact& Impact : PendingImpacts)
+	{
+		ResolveImpact(Impact);
+	}
+	PendingImpacts.Reset();
+
+	if (bIsAuthority)
+	{
+		FlushReplication();
+	}
+}
+
+void ULyraProjectileSubsystem::Simulate(float DeltaTime, bool bSweep)
+{
+	UWorld* World = GetWorld();
+	const FVector Gravity(0.0, 0.0, World->GetGravityZ());
+
+	const float MaxSubstepTime = FMath::Max(LyraConsoleVariables::ProjectileMaxSubstepTime, UE_KINDA_SMALL_NUMBER);
+	const int32 NumSubsteps = FMath::Clamp(FMath::CeilToInt(DeltaTime / MaxSubstepTime), 1, FMath::Max(LyraConsoleVariables::ProjectileMaxSubsteps, 1));
+	const float StepTime = DeltaTime / NumSubsteps;
+
+	for (int32 Substep = 0; (Substep < NumSubsteps) && (Positions.Num() > 0); ++Substep)
+	{
+		const int32 NumProjectiles = Positions.Num();
+
+		// Integrate every projectile first, this loop only touches the state arrays
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			PreviousPositions[Index] = Positions[Index];
+			Velocities[Index] += Gravity * (GravityScales[Index] * StepTime);
+			Positions[Index] += Velocities[Index] * StepTime;
+			TimeRemaining[Index] -= StepTime;
+		}
+
+		// Then sweep the segments they moved through during this sub-step
+		IndicesToRemove.Reset();
+		for (int32 Index = 0; Index < NumProjectiles; ++Index)
+		{
+			if (bSweep)
+			{
+				const FProjectilePayload& Payload = Payloads[Index];
+
+				FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraProjectileSweep), /*bTraceComplex=*/ true, Payload.Instigator.Get());
+				QueryParams.bReturnPhysicalMaterial = true;
+
+				FHitResult Hit;
+				const bool bHit = (CollisionRadii[Index] > 0.0f) ?
+					World->SweepSingleByChannel(Hit, PreviousPositions[Index], Positions[Index], FQuat::Identity, Lyra_TraceChannel_Weapon, FCollisionShape::MakeSphere(CollisionRadii[Index]), QueryParams) :
+					World->LineTraceSingleByChannel(Hit, PreviousPositions[Index], Positions[Index], Lyra_TraceChannel_Weapon, QueryParams);
+
+				if (bHit)
+				{
+					PendingImpacts.Add({ Payload, Hit, ProjectileIds[Index] });
+					IndicesToRemove.Add(Index);
+					continue;
+				}
+			}
+
+			if (TimeRemaining[Index] <= 0.0f)
+			{
+				IndicesToRemove.Add(Index);
+			}
+		}
+
+		for (int32 RemoveIndex = IndicesToRemove.Num() - 1; RemoveIndex >= 0; --RemoveIndex)
+		{
+			RemoveProjectileAtSwap(IndicesToRemove[RemoveIndex]);
+		}
+	}
+}
+
+void ULyraProjectileSubsystem::ResolveImpact(const FPendingImpact& Impact)
+{
+	FLyraProjectileImpactRecord& Record = PendingImpactRecords.AddDefaulted_GetRef();
+	Record.ProjectileId = Impact.ProjectileId;
+	Record.Location = Impact.Hit.ImpactPoint;
+
+	OnProjectileImpact.Broadcast(Impact.ProjectileId, Impact.Hit.ImpactPoint);
+
+	// Apply the weapon's effect through the same target data path a hitscan hit would use
+	const FGameplayEffectSpecHandle& ImpactEffect = Impact.Payload.ImpactEffect;
+	if (ImpactEffect.IsValid() && (ImpactEffect.Data->GetContext().GetInstigatorAbilitySystemComponent() != nullptr))
+	{
+		FLyraGameplayAbilityTargetData_SingleTargetHit TargetData;
+		TargetData.HitResult = Impact.Hit;
+		TargetData.CartridgeID = Impact.Payload.CartridgeID;
+		TargetData.ApplyGameplayEffectSpec(*ImpactEffect.Data.Get());
+	}
+}
+
+void ULyraProjectileSubsystem::FlushReplication()
+{
+	if ((Replicator == nullptr) || (PendingSpawnRecords.IsEmpty() && PendingImpactRecords.IsEmpty()))
+	{
+		PendingSpawnRecords.Reset();
+		PendingImpactRecords.Reset();
+		return;
+	}
+
+	// Everything that happened this frame goes out together, split up only to keep each RPC reasonably sized
+	const int32 ChunkSize = FMath::Max(LyraConsoleVariables::ProjectileMaxRecordsPerMulticast, 1);
+	const int32 NumChunks = FMath::DivideAndRoundUp(FMath::Max(PendingSpawnRecords.Num(), PendingImpactRecords.Num()), ChunkSize);
+
+	TArray<FLyraProjectileSpawnRecord> SpawnChunk;
+	TArray<FLyraProjectileImpactRecord> ImpactChunk;
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+	{
+		const int32 FirstRecord = ChunkIndex * ChunkSize;
+
+		SpawnChunk.Reset();
+		SpawnChunk.Append(PendingSpawnRecords.GetData() + FMath::Min(FirstRecord, PendingSpawnRecords.Num()), FMath::Clamp(PendingSpawnRecords.Num() - FirstRecord, 0, ChunkSize));
+
+		ImpactChunk.Reset();
+		ImpactChunk.Append(PendingImpactRecords.GetData() + FMath::Min(FirstRecord, PendingImpactRecords.Num()), FMath::Clamp(PendingImpactRecords.Num() - FirstRecord, 0, ChunkSize));
+
+		Replicator->MulticastProjectileEvents(SpawnChunk, ImpactChunk);
+	}
+
+	PendingSpawnRecords.Reset();
+	PendingImpactRecords.Reset();
+}
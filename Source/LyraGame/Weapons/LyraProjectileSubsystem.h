@@ -0,0 +1,176 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/HitResult.h"
+#include "Engine/NetSerialization.h"
+#include "GameplayEffectTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "LyraProjectileSubsystem.generated.h"
+
+class AActor;
+class ALyraProjectileReplicator;
+class UObject;
+class UWorld;
+
+/** Ballistics of the projectiles fired by a ranged weapon */
+USTRUCT(BlueprintType)
+struct FLyraProjectileParams
+{
+	GENERATED_BODY()
+
+	// Launch speed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Projectile, meta=(ForceUnits="cm/s", ClampMin=1.0))
+	float Speed = 5000.0f;
+
+	// Multiplier on world gravity (0 flies straight, 1 is a regular ballistic arc)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Projectile, meta=(ClampMin=0.0, ClampMax=2.55))
+	float GravityScale = 0.0f;
+
+	// Radius of the sphere swept for collision (0.0 will result in a line trace)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Projectile, meta=(ForceUnits=cm, ClampMin=0.0))
+	float CollisionRadius = 0.0f;
+
+	// Time before the projectile expires without hitting anything
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Projectile, meta=(ForceUnits=s, ClampMin=0.1, ClampMax=25.5))
+	float MaxLifetime = 5.0f;
+};
+
+/** Compact description of a launched projectile, sent to clients so they can simulate it for visuals */
+USTRUCT()
+struct FLyraProjectileSpawnRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Velocity;
+
+	// Server world time the projectile was launched at
+	UPROPERTY()
+	double LaunchTime = 0.0;
+
+	UPROPERTY()
+	uint16 ProjectileId = 0;
+
+	// Gravity scale, in hundredths
+	UPROPERTY()
+	uint8 GravityScale = 0;
+
+	// Lifetime, in tenths of a second
+	UPROPERTY()
+	uint8 Lifetime = 0;
+};
+
+/** Tells clients where (and that) a projectile stopped */
+USTRUCT()
+struct FLyraProjectileImpactRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	uint16 ProjectileId = 0;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FLyraProjectileEventDelegate, uint16 /*ProjectileId*/, const FVector& /*Location*/);
+
+/**
+ * ULyraProjectileSubsystem
+ *
+ * Simulates weapon projectiles as plain data rather than actors.
+ * The server sweeps every projectile with sub-stepping and applies the firing ability's effect
+ * through the regular target data path on impact; clients receive batched spawn/impact records
+ * and only integrate the trajectories for visuals.
+ */
+UCLASS()
+class ULyraProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End of UWorldSubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/**
+	 * Launches a projectile (authority only).
+	 * ImpactEffect is applied to whatever the projectile hits, using CartridgeID for the hit's target data.
+	 * Returns false if the projectile could not be launched because the pool is full.
+	 */
+	bool LaunchProjectile(const FLyraProjectileParams& Params, const FVector& Origin, const FVector& Direction, AActor* Instigator, const FGameplayEffectSpecHandle& ImpactEffect, int32 CartridgeID);
+
+	/** Called by the replicator on clients */
+	void HandleReplicatedEvents(const TArray<FLyraProjectileSpawnRecord>& Spawns, const TArray<FLyraProjectileImpactRecord>& Impacts);
+
+	int32 GetNumProjectiles() const { return Positions.Num(); }
+
+	// Broadcast when a projectile starts simulating, on both server and clients
+	FLyraProjectileEventDelegate OnProjectileLaunched;
+
+	// Broadcast when a projectile stops (hit something or expired), on both server and clients
+	FLyraProjectileEventDelegate OnProjectileImpact;
+
+protected:
+	//~UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+private:
+	// Data only needed when a projectile hits something
+	struct FProjectilePayload
+	{
+		TWeakObjectPtr<AActor> Instigator;
+		FGameplayEffectSpecHandle ImpactEffect;
+		int32 CartridgeID = INDEX_NONE;
+	};
+
+	struct FPendingImpact
+	{
+		FProjectilePayload Payload;
+		FHitResult Hit;
+		uint16 ProjectileId;
+	};
+
+	int32 AddProjectile(uint16 ProjectileId, const FVector& Origin, const FVector& Velocity, float GravityScale, float CollisionRadius, float Lifetime);
+	void RemoveProjectileAtSwap(int32 Index);
+
+	void Simulate(float DeltaTime, bool bSweep);
+	void ResolveImpact(const FPendingImpact& Impact);
+	void FlushReplication();
+
+	double GetServerWorldTime() const;
+
+private:
+	// Projectile state, one entry per live projectile (structure of arrays)
+	TArray<FVector> Positions;
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityScales;
+	TArray<float> CollisionRadii;
+	TArray<float> TimeRemaining;
+	TArray<uint16> ProjectileIds;
+	TArray<FProjectilePayload> Payloads;
+
+	TArray<FPendingImpact> PendingImpacts;
+	TArray<int32> IndicesToRemove;
+
+	// Events waiting to be sent to clients
+	TArray<FLyraProjectileSpawnRecord> PendingSpawnRecords;
+	TArray<FLyraProjectileImpactRecord> PendingImpactRecords;
+
+	UPROPERTY(Transient)
+	TObjectPtr<ALyraProjectileReplicator> Replicator;
+
+	uint16 NextProjectileId = 0;
+};
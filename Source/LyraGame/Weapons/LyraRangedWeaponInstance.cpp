@@ -7,6 +7,7 @@
 #include "Camera/LyraCameraComponent.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Weapons/LyraWeaponInstance.h"
+#include "Weapons/LyraWeaponSpreadSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraRangedWeaponInstance)
 
@@ -23,6 +24,8 @@ void ULyraRangedWeaponInstance::PostLoad()
 {
 	Super::PostLoad();
 
+	BakeSpreadCurves();
+
 #if WITH_EDITOR
 	UpdateDebugVisualization();
 #endif
@@ -32,6 +35,7 @@ void ULyraRangedWeaponInstance::PostLoad()
 void ULyraRangedWeaponInstance::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakeSpreadCurves();
 	UpdateDebugVisualization();
 }
 
@@ -49,40 +53,158 @@ void ULyraRangedWeaponInstance::OnEquipped()
 {
 	Super::OnEquipped();
 
+	// Instances are created at runtime from the class defaults, so bake here rather than relying on PostLoad
+	BakeSpreadCurves();
+
 	// Start heat in the middle
-	float MinHeatRange;
-	float MaxHeatRange;
-	ComputeHeatRange(/*out*/ MinHeatRange, /*out*/ MaxHeatRange);
-	CurrentHeat = (MinHeatRange + MaxHeatRange) * 0.5f;
+	CurrentHeat = (CachedMinHeat + CachedMaxHeat) * 0.5f;
 
 	// Derive spread
-	CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	CurrentSpreadAngle = BakedHeatToSpreadCurve.Eval(CurrentHeat);
 
 	// Default the multipliers to 1x
 	CurrentSpreadAngleMultiplier = 1.0f;
 	StandingStillMultiplier = 1.0f;
 	JumpFallMultiplier = 1.0f;
 	CrouchingMultiplier = 1.0f;
+
+	if (ULyraWeaponSpreadSubsystem* SpreadSubsystem = UWorld::GetSubsystem<ULyraWeaponSpreadSubsystem>(GetWorld()))
+	{
+		SpreadSubsystem->RegisterWeapon(this);
+	}
 }
 
 void ULyraRangedWeaponInstance::OnUnequipped()
 {
+	if (ULyraWeaponSpreadSubsystem* SpreadSubsystem = UWorld::GetSubsystem<ULyraWeaponSpreadSubsystem>(GetWorld()))
+	{
+		SpreadSubsystem->UnregisterWeapon(this);
+	}
+
 	Super::OnUnequipped();
 }
 
 void ULyraRangedWeaponInstance::Tick(float DeltaSeconds)
 {
-	APawn* Pawn = GetPawn();
-	check(Pawn != nullptr);
-	
-	const bool bMinSpread = UpdateSpread(DeltaSeconds);
-	const bool bMinMultipliers = UpdateMultipliers(DeltaSeconds);
+	ULyraRangedWeaponInstance* const Self = this;
+	FLyraRangedWeaponTickBatch Batch;
+	TickBatch(MakeArrayView(&Self, 1), DeltaSeconds, Batch);
+}
+
+void ULyraRangedWeaponInstance::BakeSpreadCurves()
+{
+	BakedHeatToSpreadCurve.Bake(*HeatToSpreadCurve.GetRichCurveConst());
+	BakedHeatToHeatPerShotCurve.Bake(*HeatToHeatPerShotCurve.GetRichCurveConst());
+	BakedHeatToCoolDownPerSecondCurve.Bake(*HeatToCoolDownPerSecondCurve.GetRichCurveConst());
+
+	ComputeHeatRange(/*out*/ CachedMinHeat, /*out*/ CachedMaxHeat);
+	ComputeSpreadRange(/*out*/ CachedMinSpread, /*out*/ CachedMaxSpread);
+}
+
+void ULyraRangedWeaponInstance::TickBatch(TConstArrayView<ULyraRangedWeaponInstance*> Weapons, float DeltaSeconds, FLyraRangedWeaponTickBatch& Batch)
+{
+	const int32 NumWeapons = Weapons.Num();
+	Batch.SetNum(NumWeapons);
+
+	// Gather everything that needs the pawn, its components or the world
+	for (int32 Index = 0; Index < NumWeapons; ++Index)
+	{
+		const ULyraRangedWeaponInstance* Weapon = Weapons[Index];
+		APawn* Pawn = Weapon->GetPawn();
+		check(Pawn != nullptr);
+		const UCharacterMovementComponent* CharMovementComp = Cast<UCharacterMovementComponent>(Pawn->GetMovementComponent());
+
+		// Determine if we are aiming down sights, and apply the bonus based on how far into the camera transition we are
+		float AimingAlpha = 0.0f;
+		if (const ULyraCameraComponent* CameraComponent = ULyraCameraComponent::FindCameraComponent(Pawn))
+		{
+			float TopCameraWeight;
+			FGameplayTag TopCameraTag;
+			CameraComponent->GetBlendInfo(/*out*/ TopCameraWeight, /*out*/ TopCameraTag);
+
+			AimingAlpha = (TopCameraTag == TAG_Lyra_Weapon_SteadyAimingCamera) ? TopCameraWeight : 0.0f;
+		}
+
+		Batch.TimeSinceFired[Index] = Pawn->GetWorld()->TimeSince(Weapon->LastFireTime);
+		Batch.PawnSpeed[Index] = Pawn->GetVelocity().Size();
+		Batch.AimingAlpha[Index] = AimingAlpha;
+		Batch.CrouchingAlpha[Index] = ((CharMovementComp != nullptr) && CharMovementComp->IsCrouching()) ? 1.0f : 0.0f;
+		Batch.FallingAlpha[Index] = ((CharMovementComp != nullptr) && CharMovementComp->IsFalling()) ? 1.0f : 0.0f;
+
+		Batch.Heat[Index] = Weapon->CurrentHeat;
+		Batch.SpreadAngle[Index] = Weapon->CurrentSpreadAngle;
+		Batch.StandingStillMultiplier[Index] = Weapon->StandingStillMultiplier;
+		Batch.CrouchingMultiplier[Index] = Weapon->CrouchingMultiplier;
+		Batch.JumpFallMultiplier[Index] = Weapon->JumpFallMultiplier;
+	}
+
+	// Advance heat, spread and multipliers; this loop only reads weapon tuning and the batch arrays
+	const float MultiplierNearlyEqualThreshold = 0.05f;
+	for (int32 Index = 0; Index < NumWeapons; ++Index)
+	{
+		const ULyraRangedWeaponInstance& Weapon = *Weapons[Index];
+
+		// Cool down once the recovery delay has passed
+		float Heat = Batch.Heat[Index];
+		float SpreadAngle = Batch.SpreadAngle[Index];
+		if (Batch.TimeSinceFired[Index] > Weapon.SpreadRecoveryCooldownDelay)
+		{
+			const float CooldownRate = Weapon.BakedHeatToCoolDownPerSecondCurve.Eval(Heat);
+			Heat = Weapon.ClampHeat(Heat - (CooldownRate * DeltaSeconds));
+			SpreadAngle = Weapon.BakedHeatToSpreadCurve.Eval(Heat);
+		}
+		const bool bMinSpread = FMath::IsNearlyEqual(SpreadAngle, Weapon.CachedMinSpread, KINDA_SMALL_NUMBER);
+
+		// See if we are standing still, and if so, smoothly apply the bonus
+		const float MovementTargetValue = FMath::GetMappedRangeValueClamped(
+			/*InputRange=*/ FVector2f(Weapon.StandingStillSpeedThreshold, Weapon.StandingStillSpeedThreshold + Weapon.StandingStillToMovingSpeedRange),
+			/*OutputRange=*/ FVector2f(Weapon.SpreadAngleMultiplier_StandingStill, 1.0f),
+			/*Alpha=*/ Batch.PawnSpeed[Index]);
+		const float StandingStillMultiplier = FMath::FInterpTo(Batch.StandingStillMultiplier[Index], MovementTargetValue, DeltaSeconds, Weapon.TransitionRate_StandingStill);
+		const bool bStandingStillMultiplierAtMin = FMath::IsNearlyEqual(StandingStillMultiplier, Weapon.SpreadAngleMultiplier_StandingStill, Weapon.SpreadAngleMultiplier_StandingStill*0.1f);
+
+		// See if we are crouching, and if so, smoothly apply the bonus
+		const float CrouchingTargetValue = FMath::Lerp(1.0f, Weapon.SpreadAngleMultiplier_Crouching, Batch.CrouchingAlpha[Index]);
+		const float CrouchingMultiplier = FMath::FInterpTo(Batch.CrouchingMultiplier[Index], CrouchingTargetValue, DeltaSeconds, Weapon.TransitionRate_Crouching);
+		const bool bCrouchingMultiplierAtTarget = FMath::IsNearlyEqual(CrouchingMultiplier, CrouchingTargetValue, MultiplierNearlyEqualThreshold);
+
+		// See if we are in the air (jumping/falling), and if so, smoothly apply the penalty
+		const float JumpFallTargetValue = FMath::Lerp(1.0f, Weapon.SpreadAngleMultiplier_JumpingOrFalling, Batch.FallingAlpha[Index]);
+		const float JumpFallMultiplier = FMath::FInterpTo(Batch.JumpFallMultiplier[Index], JumpFallTargetValue, DeltaSeconds, Weapon.TransitionRate_JumpingOrFalling);
+		const bool bJumpFallMultiplerIs1 = FMath::IsNearlyEqual(JumpFallMultiplier, 1.0f, MultiplierNearlyEqualThreshold);
+
+		// Aiming down sights blends in with the camera transition
+		const float AimingMultiplier = FMath::Lerp(1.0f, Weapon.SpreadAngleMultiplier_Aiming, FMath::Clamp(Batch.AimingAlpha[Index], 0.0f, 1.0f));
+		const bool bAimingMultiplierAtTarget = FMath::IsNearlyEqual(AimingMultiplier, Weapon.SpreadAngleMultiplier_Aiming, KINDA_SMALL_NUMBER);
+
+		// need to handle these spread multipliers indicating we are not at min spread
+		const bool bMinMultipliers = bStandingStillMultiplierAtMin && bCrouchingMultiplierAtTarget && bJumpFallMultiplerIs1 && bAimingMultiplierAtTarget;
+
+		Batch.Heat[Index] = Heat;
+		Batch.SpreadAngle[Index] = SpreadAngle;
+		Batch.StandingStillMultiplier[Index] = StandingStillMultiplier;
+		Batch.CrouchingMultiplier[Index] = CrouchingMultiplier;
+		Batch.JumpFallMultiplier[Index] = JumpFallMultiplier;
+		Batch.CombinedMultiplier[Index] = AimingMultiplier * StandingStillMultiplier * CrouchingMultiplier * JumpFallMultiplier;
+		Batch.bFirstShotAccuracy[Index] = Weapon.bAllowFirstShotAccuracy && bMinMultipliers && bMinSpread;
+	}
 
-	bHasFirstShotAccuracy = bAllowFirstShotAccuracy && bMinMultipliers && bMinSpread;
+	// Write the results back
+	for (int32 Index = 0; Index < NumWeapons; ++Index)
+	{
+		ULyraRangedWeaponInstance* Weapon = Weapons[Index];
+		Weapon->CurrentHeat = Batch.Heat[Index];
+		Weapon->CurrentSpreadAngle = Batch.SpreadAngle[Index];
+		Weapon->StandingStillMultiplier = Batch.StandingStillMultiplier[Index];
+		Weapon->CrouchingMultiplier = Batch.CrouchingMultiplier[Index];
+		Weapon->JumpFallMultiplier = Batch.JumpFallMultiplier[Index];
+		Weapon->CurrentSpreadAngleMultiplier = Batch.CombinedMultiplier[Index];
+		Weapon->bHasFirstShotAccuracy = Batch.bFirstShotAccuracy[Index];
 
 #if WITH_EDITOR
-	UpdateDebugVisualization();
+		Weapon->UpdateDebugVisualization();
 #endif
+	}
 }
 
 void ULyraRangedWeaponInstance::ComputeHeatRange(float& MinHeat, float& MaxHeat)
@@ -111,11 +233,11 @@ void ULyraRangedWeaponInstance::ComputeSpreadRange(float& MinSpread, float& MaxS
 void ULyraRangedWeaponInstance::AddSpread()
 {
 	// Sample the heat up curve
-	const float HeatPerShot = HeatToHeatPerShotCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	const float HeatPerShot = BakedHeatToHeatPerShotCurve.Eval(CurrentHeat);
 	CurrentHeat = ClampHeat(CurrentHeat + HeatPerShot);
 
 	// Map the heat to the spread angle
-	CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	CurrentSpreadAngle = BakedHeatToSpreadCurve.Eval(CurrentHeat);
 
 #if WITH_EDITOR
 	UpdateDebugVisualization();
@@ -144,75 +266,3 @@ float ULyraRangedWeaponInstance::GetPhysicalMaterialAttenuation(const UPhysicalM
 
 	return CombinedMultiplier;
 }
-
-bool ULyraRangedWeaponInstance::UpdateSpread(float DeltaSeconds)
-{
-	const float TimeSinceFired = GetWorld()->TimeSince(LastFireTime);
-
-	if (TimeSinceFired > SpreadRecoveryCooldownDelay)
-	{
-		const float CooldownRate = HeatToCoolDownPerSecondCurve.GetRichCurveConst()->Eval(CurrentHeat);
-		CurrentHeat = ClampHeat(CurrentHeat - (CooldownRate * DeltaSeconds));
-		CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
-	}
-	
-	float MinSpread;
-	float MaxSpread;
-	ComputeSpreadRange(/*out*/ MinSpread, /*out*/ MaxSpread);
-
-	return FMath::IsNearlyEqual(CurrentSpreadAngle, MinSpread, KINDA_SMALL_NUMBER);
-}
-
-bool ULyraRangedWeaponInstance::UpdateMultipliers(float DeltaSeconds)
-{
-	const float MultiplierNearlyEqualThreshold = 0.05f;
-
-	APawn* Pawn = GetPawn();
-	check(Pawn != nullptr);
-	UCharacterMovementComponent* CharMovementComp = Cast<UCharacterMovementComponent>(Pawn->GetMovementComponent());
-
-	// See if we are standing still, and if so, smoothly apply the bonus
-	const float PawnSpeed = Pawn->GetVelocity().Size();
-	const float MovementTargetValue = FMath::GetMappedRangeValueClamped(
-		/*InputRange=*/ FVector2D(StandingStillSpeedThreshold, StandingStillSpeedThreshold + StandingStillToMovingSpeedRange),
-		/*OutputRange=*/ FVector2D(SpreadAngleMultiplier_StandingStill, 1.0f),
-		/*Alpha=*/ PawnSpeed);
-	StandingStillMultiplier = FMath::FInterpTo(StandingStillMultiplier, MovementTargetValue, DeltaSeconds, TransitionRate_StandingStill);
-	const bool bStandingStillMultiplierAtMin = FMath::IsNearlyEqual(StandingStillMultiplier, SpreadAngleMultiplier_StandingStill, SpreadAngleMultiplier_StandingStill*0.1f);
-
-	// See if we are crouching, and if so, smoothly apply the bonus
-	const bool bIsCrouching = (CharMovementComp != nullptr) && CharMovementComp->IsCrouching();
-	const float CrouchingTargetValue = bIsCrouching ? SpreadAngleMultiplier_Crouching : 1.0f;
-	CrouchingMultiplier = FMath::FInterpTo(CrouchingMultiplier, CrouchingTargetValue, DeltaSeconds, TransitionRate_Crouching);
-	const bool bCrouchingMultiplierAtTarget = FMath::IsNearlyEqual(CrouchingMultiplier, CrouchingTargetValue, MultiplierNearlyEqualThreshold);
-
-	// See if we are in the air (jumping/falling), and if so, smoothly apply the penalty
-	const bool bIsJumpingOrFalling = (CharMovementComp != nullptr) && CharMovementComp->IsFalling();
-	const float JumpFallTargetValue = bIsJumpingOrFalling ? SpreadAngleMultiplier_JumpingOrFalling : 1.0f;
-	JumpFallMultiplier = FMath::FInterpTo(JumpFallMultiplier, JumpFallTargetValue, DeltaSeconds, TransitionRate_JumpingOrFalling);
-	const bool bJumpFallMultiplerIs1 = FMath::IsNearlyEqual(JumpFallMultiplier, 1.0f, MultiplierNearlyEqualThreshold);
-
-	// Determine if we are aiming down sights, and apply the bonus based on how far into the camera transition we are
-	float AimingAlpha = 0.0f;
-	if (const ULyraCameraComponent* CameraComponent = ULyraCameraComponent::FindCameraComponent(Pawn))
-	{
-		float TopCameraWeight;
-		FGameplayTag TopCameraTag;
-		CameraComponent->GetBlendInfo(/*out*/ TopCameraWeight, /*out*/ TopCameraTag);
-
-		AimingAlpha = (TopCameraTag == TAG_Lyra_Weapon_SteadyAimingCamera) ? TopCameraWeight : 0.0f;
-	}
-	const float AimingMultiplier = FMath::GetMappedRangeValueClamped(
-		/*InputRange=*/ FVector2D(0.0f, 1.0f),
-		/*OutputRange=*/ FVector2D(1.0f, SpreadAngleMultiplier_Aiming),
-		/*Alpha=*/ AimingAlpha);
-	const bool bAimingMultiplierAtTarget = FMath::IsNearlyEqual(AimingMultiplier, SpreadAngleMultiplier_Aiming, KINDA_SMALL_NUMBER);
-
-	// Combine all the multipliers
-	const float CombinedMultiplier = AimingMultiplier * StandingStillMultiplier * CrouchingMultiplier * JumpFallMultiplier;
-	CurrentSpreadAngleMultiplier = CombinedMultiplier;
-
-	// need to handle these spread multipliers indicating we are not at min spread
-	return bStandingStillMultiplierAtMin && bCrouchingMultiplierAtTarget && bJumpFallMultiplerIs1 && bAimingMultiplierAtTarget;
-}
-
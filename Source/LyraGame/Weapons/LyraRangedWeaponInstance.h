@@ -6,10 +6,49 @@
 
 #include "LyraWeaponInstance.h"
 #include "AbilitySystem/LyraAbilitySourceInterface.h"
+#include "Weapons/LyraBakedCurve.h"
+#include "Weapons/LyraProjectileSubsystem.h"
 
 #include "LyraRangedWeaponInstance.generated.h"
 
 class UPhysicalMaterial;
+class ULyraRangedWeaponInstance;
+
+/** Scratch storage for ULyraRangedWeaponInstance::TickBatch, one entry per weapon (structure of arrays) */
+struct FLyraRangedWeaponTickBatch
+{
+	// Inputs gathered from the weapon and its pawn
+	TArray<float, TInlineAllocator<16>> TimeSinceFired;
+	TArray<float, TInlineAllocator<16>> PawnSpeed;
+	TArray<float, TInlineAllocator<16>> AimingAlpha;
+	TArray<float, TInlineAllocator<16>> CrouchingAlpha;
+	TArray<float, TInlineAllocator<16>> FallingAlpha;
+
+	// Spread state, copied in before the update and back out after it
+	TArray<float, TInlineAllocator<16>> Heat;
+	TArray<float, TInlineAllocator<16>> SpreadAngle;
+	TArray<float, TInlineAllocator<16>> StandingStillMultiplier;
+	TArray<float, TInlineAllocator<16>> CrouchingMultiplier;
+	TArray<float, TInlineAllocator<16>> JumpFallMultiplier;
+	TArray<float, TInlineAllocator<16>> CombinedMultiplier;
+	TArray<bool, TInlineAllocator<16>> bFirstShotAccuracy;
+
+	void SetNum(int32 Num)
+	{
+		TimeSinceFired.SetNumUninitialized(Num, EAllowShrinking::No);
+		PawnSpeed.SetNumUninitialized(Num, EAllowShrinking::No);
+		AimingAlpha.SetNumUninitialized(Num, EAllowShrinking::No);
+		CrouchingAlpha.SetNumUninitialized(Num, EAllowShrinking::No);
+		FallingAlpha.SetNumUninitialized(Num, EAllowShrinking::No);
+		Heat.SetNumUninitialized(Num, EAllowShrinking::No);
+		SpreadAngle.SetNumUninitialized(Num, EAllowShrinking::No);
+		StandingStillMultiplier.SetNumUninitialized(Num, EAllowShrinking::No);
+		CrouchingMultiplier.SetNumUninitialized(Num, EAllowShrinking::No);
+		JumpFallMultiplier.SetNumUninitialized(Num, EAllowShrinking::No);
+		CombinedMultiplier.SetNumUninitialized(Num, EAllowShrinking::No);
+		bFirstShotAccuracy.SetNumUninitialized(Num, EAllowShrinking::No);
+	}
+};
 
 /**
  * ULyraRangedWeaponInstance
@@ -68,6 +107,16 @@ public:
 		return BulletTraceSweepRadius;
 	}
 
+	bool FiresProjectiles() const
+	{
+		return bFiresProjectiles;
+	}
+
+	const FLyraProjectileParams& GetProjectileParams() const
+	{
+		return ProjectileParams;
+	}
+
 protected:
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(VisibleAnywhere, Category = "Spread|Fire Params")
@@ -178,6 +227,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon Config", meta=(ForceUnits=cm))
 	float BulletTraceSweepRadius = 0.0f;
 
+	// If set, bullets are launched as projectiles simulated by ULyraProjectileSubsystem instead of being traced instantly
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon Config|Projectile")
+	bool bFiresProjectiles = false;
+
+	// Ballistics of the projectiles, when bFiresProjectiles is set
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Weapon Config|Projectile", meta=(EditCondition="bFiresProjectiles"))
+	FLyraProjectileParams ProjectileParams;
+
 	// A curve that maps the distance (in cm) to a multiplier on the base damage from the associated gameplay effect
 	// If there is no data in this curve, then the weapon is assumed to have no falloff with distance
 	UPROPERTY(EditAnywhere, Category = "Weapon Config")
@@ -214,9 +271,29 @@ private:
 	// The current crouching multiplier
 	float CrouchingMultiplier = 1.0f;
 
+	// Lookup tables baked from the heat curves, so per-frame updates don't search curve keys
+	FLyraBakedCurve BakedHeatToSpreadCurve;
+	FLyraBakedCurve BakedHeatToHeatPerShotCurve;
+	FLyraBakedCurve BakedHeatToCoolDownPerSecondCurve;
+
+	// Ranges derived from the curves when they were baked
+	float CachedMinHeat = 0.0f;
+	float CachedMaxHeat = 0.0f;
+	float CachedMinSpread = 0.0f;
+	float CachedMaxSpread = 0.0f;
+
 public:
 	void Tick(float DeltaSeconds);
 
+	/**
+	 * Advances heat, spread and the spread multipliers of many weapons in one pass.
+	 * Pawn state is gathered first, then the update runs over the contiguous arrays in Batch.
+	 */
+	static void TickBatch(TConstArrayView<ULyraRangedWeaponInstance*> Weapons, float DeltaSeconds, FLyraRangedWeaponTickBatch& Batch);
+
+	/** Rebuilds the lookup tables from the heat curves */
+	void BakeSpreadCurves();
+
 	//~ULyraEquipmentInstance interface
 	virtual void OnEquipped();
 	virtual void OnUnequipped();
@@ -233,18 +310,8 @@ private:
 	void ComputeSpreadRange(float& MinSpread, float& MaxSpread);
 	void ComputeHeatRange(float& MinHeat, float& MaxHeat);
 
-	inline float ClampHeat(float NewHeat)
+	inline float ClampHeat(float NewHeat) const
 	{
-		float MinHeat;
-		float MaxHeat;
-		ComputeHeatRange(/*out*/ MinHeat, /*out*/ MaxHeat);
-
-		return FMath::Clamp(NewHeat, MinHeat, MaxHeat);
+		return FMath::Clamp(NewHeat, CachedMinHeat, CachedMaxHeat);
 	}
-
-	// Updates the spread and returns true if the spread is at minimum
-	bool UpdateSpread(float DeltaSeconds);
-
-	// Updates the multipliers and returns true if they are at minimum
-	bool UpdateMultipliers(float DeltaSeconds);
 };
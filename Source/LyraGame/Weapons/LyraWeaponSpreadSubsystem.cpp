@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraWeaponSpreadSubsystem.h"
+
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Weapons/LyraWeaponStateComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraWeaponSpreadSubsystem)
+
+namespace LyraConsoleVariables
+{
+	static bool bBatchWeaponSpreadUpdate = true;
+	static FAutoConsoleVariableRef CVarBatchWeaponSpreadUpdate(
+		TEXT("lyra.Weapon.BatchSpreadUpdate"),
+		bBatchWeaponSpreadUpdate,
+		TEXT("Should ranged weapon heat/spread be updated in one batch per world rather than by each weapon state component?"),
+		ECVF_Default);
+}
+
+bool ULyraWeaponSpreadSubsystem::IsBatchUpdateEnabled()
+{
+	return LyraConsoleVariables::bBatchWeaponSpreadUpdate;
+}
+
+bool ULyraWeaponSpreadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+TStatId ULyraWeaponSpreadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraWeaponSpreadSubsystem, STATGROUP_Tickables);
+}
+
+void ULyraWeaponSpreadSubsystem::RegisterWeapon(ULyraRangedWeaponInstance* Weapon)
+{
+	if (Weapon != nullptr)
+	{
+		RegisteredWeapons.AddUnique(Weapon);
+	}
+}
+
+void ULyraWeaponSpreadSubsystem::UnregisterWeapon(ULyraRangedWeaponInstance* Weapon)
+{
+	RegisteredWeapons.RemoveSingleSwap(Weapon);
+}
+
+void ULyraWeaponSpreadSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!IsBatchUpdateEnabled() || RegisteredWeapons.IsEmpty())
+	{
+		return;
+	}
+
+	// Only weapons held by a controller with weapon state are updated, matching ULyraWeaponStateComponent
+	WeaponsToTick.Reset();
+	for (int32 Index = RegisteredWeapons.Num() - 1; Index >= 0; --Index)
+	{
+		ULyraRangedWeaponInstance* Weapon = RegisteredWeapons[Index];
+		const APawn* Pawn = (Weapon != nullptr) ? Weapon->GetPawn() : nullptr;
+		if (Pawn == nullptr)
+		{
+			RegisteredWeapons.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const AController* Controller = Pawn->GetController();
+		if ((Controller != nullptr) && (Controller->FindComponentByClass<ULyraWeaponStateComponent>() != nullptr))
+		{
+			WeaponsToTick.Add(Weapon);
+		}
+	}
+
+	ULyraRangedWeaponInstance::TickBatch(WeaponsToTick, DeltaTime, Batch);
+}
@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Weapons/LyraRangedWeaponInstance.h"
+
+#include "LyraWeaponSpreadSubsystem.generated.h"
+
+class UObject;
+
+/**
+ * ULyraWeaponSpreadSubsystem
+ *
+ * Advances heat and spread for every equipped ranged weapon in the world in a single batch,
+ * instead of each weapon state component ticking its own weapon.
+ */
+UCLASS()
+class ULyraWeaponSpreadSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true if weapons are updated by this subsystem rather than by ULyraWeaponStateComponent */
+	static bool IsBatchUpdateEnabled();
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	void RegisterWeapon(ULyraRangedWeaponInstance* Weapon);
+	void UnregisterWeapon(ULyraRangedWeaponInstance* Weapon);
+
+protected:
+	//~UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULyraRangedWeaponInstance>> RegisteredWeapons;
+
+	// Weapons being updated this frame, and the scratch arrays used to update them
+	TArray<ULyraRangedWeaponInstance*> WeaponsToTick;
+	FLyraRangedWeaponTickBatch Batch;
+};
@@ -11,6 +11,7 @@
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Teams/LyraTeamSubsystem.h"
 #include "Weapons/LyraRangedWeaponInstance.h"
+#include "Weapons/LyraWeaponSpreadSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraWeaponStateComponent)
 
@@ -29,6 +30,12 @@ void ULyraWeaponStateComponent::TickComponent(float DeltaTime, enum ELevelTick T
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Equipped weapons are normally advanced together by ULyraWeaponSpreadSubsystem
+	if (ULyraWeaponSpreadSubsystem::IsBatchUpdateEnabled())
+	{
+		return;
+	}
+
 	if (APawn* Pawn = GetPawn<APawn>())
 	{
 		if (ULyraEquipmentManagerComponent* EquipmentManager = Pawn->FindComponentByClass<ULyraEquipmentManagerComponent>())